@@ -124,6 +124,20 @@ public:
     lldb::SBThread
     GetSelectedThread () const;
 
+    //------------------------------------------------------------------
+    /// Unwind the stacks of all threads concurrently.
+    ///
+    /// Computes up to \a max_frames frames (UINT32_MAX for the whole
+    /// stack) for every thread using \a num_workers worker threads
+    /// (zero for one per host CPU).  The frames are cached so that
+    /// following SBThread::GetFrameAtIndex() calls are fast.
+    ///
+    /// @return
+    ///     The number of threads that were unwound.
+    //------------------------------------------------------------------
+    uint32_t
+    ComputeStackFramesForAllThreads (uint32_t max_frames, uint32_t num_workers);
+
     //------------------------------------------------------------------
     // Function for lazily creating a thread using the current OS
     // plug-in. This function will be removed in the future when there
@@ -227,6 +227,16 @@ public:
                     bool load_event,
                     bool delete_locations = false);
 
+    //------------------------------------------------------------------
+    /// Register what this breakpoint's resolver looks for in \a index.
+    ///
+    /// @return
+    ///    \b true if the breakpoint was indexed, \b false if it needs to
+    ///    search every newly loaded module.
+    //------------------------------------------------------------------
+    bool
+    AddToResolutionIndex (BreakpointResolutionIndex &index);
+
 
     //------------------------------------------------------------------
     /// Tells the breakpoint the old module \a old_module_sp has been
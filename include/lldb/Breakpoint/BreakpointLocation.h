@@ -26,6 +26,7 @@
 #include "lldb/Host/Mutex.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Expression/ClangUserExpression.h"
+#include "lldb/Expression/CompiledCondition.h"
 
 namespace lldb_private {
 
@@ -132,6 +133,14 @@ public:
     void
     SetIgnoreCount (uint32_t n);
 
+    //------------------------------------------------------------------
+    /// Return the number of upcoming hits of this location that will be
+    /// ignored, taking both the location's and the breakpoint's ignore
+    /// counts into account.
+    //------------------------------------------------------------------
+    uint32_t
+    GetHitsToIgnore () const;
+
     //------------------------------------------------------------------
     /// Set the callback action invoked when the breakpoint is hit.
     ///
@@ -182,6 +191,20 @@ public:
     bool
     ConditionSaysStop (ExecutionContext &exe_ctx, Error &error);
 
+    //------------------------------------------------------------------
+    /// Evaluate the condition only if that can be done without the
+    /// expression parser, so without running code in the process.
+    ///
+    /// @param[out] condition_says_stop
+    ///     The value of the condition, if \b true is returned.
+    ///
+    /// @return
+    ///     \b true if the condition was evaluated, \b false if there is
+    ///     no condition or it needs an expression.
+    //------------------------------------------------------------------
+    bool
+    ConditionSaysStopWithoutExpression (ExecutionContext &exe_ctx, bool &condition_says_stop);
+
 
     //------------------------------------------------------------------
     /// Set the valid thread to be checked when the breakpoint is hit.
@@ -444,6 +467,14 @@ private:
     ClangUserExpression::ClangUserExpressionSP m_user_expression_sp; ///< The compiled expression to use in testing our condition.
     Mutex m_condition_mutex; ///< Guards parsing and evaluation of the condition, which could be evaluated by multiple processes.
     size_t m_condition_hash; ///< For testing whether the condition source code changed.
+    CompiledCondition m_compiled_condition; ///< The condition compiled for evaluation inside the debugger, if it is simple enough.
+    size_t m_compiled_condition_hash; ///< The hash of the condition source m_compiled_condition was compiled from.
+
+    bool
+    EvaluateCompiledCondition (ExecutionContext &exe_ctx,
+                               const char *condition_text,
+                               size_t condition_hash,
+                               bool &condition_says_stop);
 
     void
     SetShouldResolveIndirectFunctions (bool do_resolve)
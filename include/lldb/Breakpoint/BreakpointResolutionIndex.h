@@ -0,0 +1,138 @@
+//===-- BreakpointResolutionIndex.h -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_BreakpointResolutionIndex_h_
+#define liblldb_BreakpointResolutionIndex_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Host/FileSpec.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class BreakpointResolutionIndex BreakpointResolutionIndex.h "lldb/Breakpoint/BreakpointResolutionIndex.h"
+/// @brief Works out which breakpoints need to search newly loaded modules.
+///
+/// Without an index every breakpoint's resolver searches every module
+/// that gets loaded.  Resolvers that only find locations through a
+/// function name or a source file register those keys here (see
+/// BreakpointResolver::AddToResolutionIndex).  Each new module's name
+/// index and compile unit file lists are then consulted once for all
+/// of the keys, and a breakpoint only searches the modules that can
+/// contain one of its keys.  Breakpoints with resolvers that can't be
+/// indexed (regular expressions, addresses, ...) search every module as
+/// before.
+//----------------------------------------------------------------------
+class BreakpointResolutionIndex
+{
+public:
+    typedef std::map<Breakpoint *, ModuleList> BreakpointModulesMap;
+
+    BreakpointResolutionIndex ();
+
+    ~BreakpointResolutionIndex ();
+
+    //------------------------------------------------------------------
+    /// Add \a bp_sp to the index, asking its resolver for its keys.
+    ///
+    /// @return
+    ///     \b true if the breakpoint was indexed, \b false if it must
+    ///     search every new module.
+    //------------------------------------------------------------------
+    bool
+    AddBreakpoint (const lldb::BreakpointSP &bp_sp);
+
+    //------------------------------------------------------------------
+    // Used by resolvers to register their keys.
+    //------------------------------------------------------------------
+    void
+    AddFunctionName (Breakpoint *bp,
+                     const ConstString &lookup_name,
+                     uint32_t name_type_mask);
+
+    void
+    AddSourceFile (Breakpoint *bp,
+                   const FileSpec &file_spec,
+                   bool check_inlines);
+
+    //------------------------------------------------------------------
+    /// Find the modules in \a module_list each indexed breakpoint needs
+    /// to look at: the ones that contain one of its keys, and the ones it
+    /// already has locations in.
+    ///
+    /// @param[out] bp_modules
+    ///     The modules for each indexed breakpoint that has any. Indexed
+    ///     breakpoints that are not in the map don't need to look at
+    ///     \a module_list at all.
+    //------------------------------------------------------------------
+    void
+    FindModulesToSearch (ModuleList &module_list,
+                         BreakpointModulesMap &bp_modules);
+
+    size_t
+    GetNumIndexedBreakpoints () const
+    {
+        return m_indexed_breakpoints.size();
+    }
+
+protected:
+    struct FunctionNameKey
+    {
+        ConstString lookup_name;
+        uint32_t name_type_mask;
+        std::vector<Breakpoint *> breakpoints;
+    };
+
+    struct SourceFileKey
+    {
+        FileSpec file_spec;
+        bool check_inlines;
+        std::vector<Breakpoint *> breakpoints;
+    };
+
+    typedef std::multimap<const char *, size_t> KeyIndexMap;    // ConstString basename -> key index
+
+    void
+    AddModuleToBreakpoints (const std::vector<Breakpoint *> &breakpoints,
+                            const lldb::ModuleSP &module_sp,
+                            BreakpointModulesMap &bp_modules);
+
+    void
+    FindFunctionNamesInModule (const lldb::ModuleSP &module_sp,
+                               BreakpointModulesMap &bp_modules);
+
+    void
+    FindSourceFilesInModule (const lldb::ModuleSP &module_sp,
+                             BreakpointModulesMap &bp_modules);
+
+    typedef std::map<std::pair<const char *, uint32_t>, size_t> FunctionNameKeyMap;     // (lookup name, name type mask) -> key index
+
+    std::vector<FunctionNameKey> m_function_names;
+    FunctionNameKeyMap m_function_name_keys;
+    std::vector<SourceFileKey> m_source_files;
+    KeyIndexMap m_source_file_basenames;            // Source files by basename
+    bool m_have_inline_source_files;                // True if any source file key needs support files checked
+    std::vector<lldb::BreakpointSP> m_indexed_breakpoints;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (BreakpointResolutionIndex);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_BreakpointResolutionIndex_h_
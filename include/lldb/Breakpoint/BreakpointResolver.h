@@ -97,6 +97,21 @@ public:
     ResolveBreakpointInModules (SearchFilter &filter,
                                 ModuleList &modules);
 
+    //------------------------------------------------------------------
+    /// Register the function names or source files this resolver looks
+    /// for in \a index, so that newly loaded modules that contain none
+    /// of them don't have to be searched.
+    ///
+    /// @return
+    ///   \b true if this resolver only finds locations through the keys it
+    ///   registered, \b false if it has to search every module.
+    //------------------------------------------------------------------
+    virtual bool
+    AddToResolutionIndex (BreakpointResolutionIndex &index)
+    {
+        return false;
+    }
+
     //------------------------------------------------------------------
     /// Prints a canonical description for the breakpoint to the stream \a s.
     ///
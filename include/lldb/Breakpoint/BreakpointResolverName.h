@@ -79,6 +79,9 @@ public:
     virtual void
     Dump (Stream *s) const;
 
+    virtual bool
+    AddToResolutionIndex (BreakpointResolutionIndex &index);
+
     /// Methods for support type inquiry through isa, cast, and dyn_cast:
     static inline bool classof(const BreakpointResolverName *) { return true; }
     static inline bool classof(const BreakpointResolver *V) {
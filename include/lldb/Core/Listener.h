@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -27,6 +28,17 @@
 
 namespace lldb_private {
 
+//----------------------------------------------------------------------
+/// @class Listener Listener.h "lldb/Core/Listener.h"
+/// @brief Receives events from broadcasters and waits for them.
+///
+/// Broadcasters hand events over without taking any lock: AddEvent pushes
+/// them onto a lock-free list, and whoever next looks at the events moves
+/// them, in order, onto the queue that is searched.  Threads waiting for
+/// events register what they are waiting for, and a broadcasting thread
+/// only wakes them up if the event is one they want.  When nobody is
+/// waiting, adding an event doesn't block or make a system call at all.
+//----------------------------------------------------------------------
 class Listener
 {
 public:
@@ -136,9 +148,40 @@ private:
         void *callback_user_data;
     };
 
+    // An event that was added but hasn't been moved to m_events yet.
+    struct PendingEvent
+    {
+        lldb::EventSP event_sp;
+        PendingEvent *next;
+    };
+
+    // What a thread in WaitForEventsInternal is waiting for.
+    struct WaiterInfo
+    {
+        WaiterInfo (Broadcaster *b, const ConstString *names, uint32_t num_names, uint32_t mask) :
+            broadcaster (b),
+            broadcaster_names (names),
+            num_broadcaster_names (num_names),
+            event_type_mask (mask)
+        {
+        }
+
+        Broadcaster *broadcaster;
+        const ConstString *broadcaster_names;
+        uint32_t num_broadcaster_names;
+        uint32_t event_type_mask;
+    };
+
     typedef std::multimap<Broadcaster*, BroadcasterInfo> broadcaster_collection;
     typedef std::list<lldb::EventSP> event_collection;
     typedef std::vector<BroadcasterManager *> broadcaster_manager_collection;
+    typedef std::list<WaiterInfo> waiter_collection;
+
+    void
+    MovePendingEvents ();
+
+    void
+    WakeWaiters (const lldb::EventSP &event_sp);
 
     bool
     FindNextEventInternal (Broadcaster *broadcaster,   // NULL for any broadcaster
@@ -168,7 +211,12 @@ private:
     Mutex m_broadcasters_mutex; // Protects m_broadcasters
     event_collection m_events;
     Mutex m_events_mutex; // Protects m_broadcasters and m_events
-    Predicate<bool> m_cond_wait;
+    std::atomic<PendingEvent *> m_pending_events;   // Most recently added first
+    std::atomic<uint32_t> m_num_waiters;
+    waiter_collection m_waiters;
+    Mutex m_waiters_mutex; // Protects m_waiters and m_wakeup_generation
+    uint32_t m_wakeup_generation;
+    Predicate<uint32_t> m_wakeup; // Set to m_wakeup_generation to wake up waiters
     broadcaster_manager_collection m_broadcaster_managers;
 
     void
@@ -0,0 +1,135 @@
+//===-- RegularExpressionSearch.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_RegularExpressionSearch_h_
+#define liblldb_RegularExpressionSearch_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/RegularExpression.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class RegularExpressionSearch RegularExpressionSearch.h "lldb/Core/RegularExpressionSearch.h"
+/// @brief Matches a regular expression against a large array of names.
+///
+/// Regular expression breakpoints and "image lookup --regex" run a
+/// regular expression over every symbol name and every name in the
+/// debug information indexes of each module.  This class makes that
+/// faster in two ways:
+///
+/// - A literal string that every match must contain (or start with, if
+///   the expression is anchored with '^') is pulled out of the
+///   expression, and names that don't contain it are rejected with a
+///   string compare instead of running the regex engine.
+///
+/// - Large arrays are split into chunks that are matched on several
+///   host threads.  The matching indexes are merged back in increasing
+///   order, so the results are the same as a serial search.
+///
+/// The name callback is called from multiple threads at once, but never
+/// twice for the same index.  Each worker thread matches with its own
+/// copy of the regular expression, since regexec() serializes calls
+/// that share a compiled expression.
+//----------------------------------------------------------------------
+class RegularExpressionSearch
+{
+public:
+    //------------------------------------------------------------------
+    /// Get the name at \a idx, or NULL if the entry should be skipped.
+    //------------------------------------------------------------------
+    typedef const char *(*GetNameCallback) (void *baton, size_t idx);
+
+    RegularExpressionSearch (const RegularExpression &regex);
+
+    ~RegularExpressionSearch ();
+
+    //------------------------------------------------------------------
+    /// Test a single name against the prefilter and the regex.
+    //------------------------------------------------------------------
+    bool
+    Matches (const char *name) const;
+
+    //------------------------------------------------------------------
+    /// Test a single name against the prefilter only.
+    ///
+    /// @return
+    ///     \b false if \a name can't match the regular expression.
+    //------------------------------------------------------------------
+    bool
+    MatchesLiteral (const char *name) const;
+
+    //------------------------------------------------------------------
+    /// Match the names at indexes [0, num_names) and append the indexes
+    /// that match to \a match_indexes in increasing order.
+    ///
+    /// @return
+    ///     The number of indexes that were appended.
+    //------------------------------------------------------------------
+    size_t
+    FindMatches (GetNameCallback callback,
+                 void *baton,
+                 size_t num_names,
+                 std::vector<uint32_t> &match_indexes) const;
+
+    const RegularExpression &
+    GetRegularExpression () const
+    {
+        return m_regex;
+    }
+
+    const std::string &
+    GetRequiredLiteral () const
+    {
+        return m_literal;
+    }
+
+    bool
+    IsLiteralPrefix () const
+    {
+        return m_literal_is_prefix;
+    }
+
+    //------------------------------------------------------------------
+    /// Find the longest literal string that any string matching the
+    /// extended regular expression \a re must contain.
+    ///
+    /// @param[out] is_prefix
+    ///     Set to \b true if matching strings must also start with
+    ///     \a literal.
+    ///
+    /// @return
+    ///     \b false if no such literal could be found; \a literal is
+    ///     then empty.
+    //------------------------------------------------------------------
+    static bool
+    ExtractRequiredLiteral (const char *re,
+                            int compile_flags,
+                            std::string &literal,
+                            bool &is_prefix);
+
+protected:
+    const RegularExpression &m_regex;
+    std::string m_literal;          // Every match contains this string
+    bool m_literal_is_prefix;       // Every match starts with m_literal
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (RegularExpressionSearch);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_RegularExpressionSearch_h_
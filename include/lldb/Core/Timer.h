@@ -62,6 +62,26 @@ public:
     static void
     ResetCategoryTimes ();
 
+    //--------------------------------------------------------------
+    /// Returns true if timers are being collected.
+    //--------------------------------------------------------------
+    static bool
+    IsEnabled ()
+    {
+        return g_display_depth > 0;
+    }
+
+    //--------------------------------------------------------------
+    /// Record a sample of a value that isn't the time spent in a
+    /// scope, such as the latency of an event or the number of items
+    /// that were handled at once.  Samples are only kept while timers
+    /// are enabled, and DumpCategoryTimes() shows their count and
+    /// percentiles for each \a category.  Like the timer categories,
+    /// \a category must be a string constant.
+    //--------------------------------------------------------------
+    static void
+    RecordSample (const char *category, uint64_t value);
+
 protected:
 
     void
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Core/RegularExpressionSearch.h"
 
 namespace lldb_private {
 
@@ -242,12 +243,14 @@ public:
     {
         const size_t start_size = values.size();
 
-        const_iterator pos, end = m_map.end();
-        for (pos = m_map.begin(); pos != end; ++pos)
-        {
-            if (regex.Execute(pos->cstring))
-                values.push_back (pos->value);
-        }
+        // Large maps are matched in parallel; the matches come back in
+        // map order either way.
+        RegularExpressionSearch search (regex);
+        std::vector<uint32_t> match_indexes;
+        search.FindMatches (GetEntryCString, (void *)&m_map, m_map.size(), match_indexes);
+        const size_t num_matches = match_indexes.size();
+        for (size_t i = 0; i < num_matches; ++i)
+            values.push_back (m_map[match_indexes[i]].value);
 
         return values.size() - start_size;
     }
@@ -350,6 +353,13 @@ protected:
     typedef std::vector<Entry> collection;
     typedef typename collection::iterator iterator;
     typedef typename collection::const_iterator const_iterator;
+
+    static const char *
+    GetEntryCString (void *baton, size_t idx)
+    {
+        return (*(const collection *)baton)[idx].cstring;
+    }
+
     collection m_map;
 };
 
@@ -116,6 +116,30 @@ public:
     bool
     MatchesContext (ExecutionContext &exe_ctx);
     
+    //------------------------------------------------------------------
+    /// The number of expressions executed by the IR interpreter, and
+    /// by JIT compiling them and running them in the target, since
+    /// LLDB started.
+    //------------------------------------------------------------------
+    static uint64_t
+    GetNumInterpretedExecutions ();
+    
+    static uint64_t
+    GetNumJITExecutions ();
+    
+    //------------------------------------------------------------------
+    /// Move an already parsed expression to the frame in \a exe_ctx so
+    /// that it can be executed again without parsing it.  The caller
+    /// must make sure the frame is in the same lexical scope as the one
+    /// the expression was parsed in (see ClangUserExpressionCache).
+    ///
+    /// @return
+    ///     False if the expression was parsed for a different process,
+    ///     or is in the middle of being executed.
+    //------------------------------------------------------------------
+    bool
+    RebindToContext (ExecutionContext &exe_ctx);
+    
     //------------------------------------------------------------------
     /// Execute the parsed expression
     ///
@@ -0,0 +1,134 @@
+//===-- ClangUserExpressionCache.h ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ClangUserExpressionCache_h_
+#define liblldb_ClangUserExpressionCache_h_
+
+// C Includes
+// C++ Includes
+#include <list>
+#include <memory>
+#include <string>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Expression/ClangExpression.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private
+{
+
+//----------------------------------------------------------------------
+/// @class ClangUserExpressionCache ClangUserExpressionCache.h "lldb/Expression/ClangUserExpressionCache.h"
+/// @brief Keeps parsed expressions around so they can be run again.
+///
+/// Evaluating an expression parses it, looks up all the entities it
+/// refers to and JIT compiles it, which costs far more than running it.
+/// IDE watch windows evaluate the same expressions in the same function
+/// after every step, so the target keeps the most recently used parsed
+/// expressions keyed by their text, prefix, language, result type and
+/// execution policy, and by the lexical block (or function or symbol) the
+/// frame is stopped in.  A cache hit is re-bound to the new frame and
+/// executed, which materializes its inputs from the frame again.
+///
+/// Since the parsed code refers to variables, types and functions from
+/// the target's modules, the cache is cleared whenever modules are
+/// loaded or unloaded, and when the process goes away.
+//----------------------------------------------------------------------
+class ClangUserExpressionCache
+{
+public:
+    typedef std::shared_ptr<ClangUserExpression> ClangUserExpressionSP;
+
+    ClangUserExpressionCache ();
+
+    ~ClangUserExpressionCache ();
+
+    //------------------------------------------------------------------
+    /// Find a parsed expression that can be executed in \a exe_ctx and
+    /// bind it to the frame in \a exe_ctx.
+    ///
+    /// @return
+    ///     The expression, or an empty shared pointer if there is none
+    ///     (or if the matching one is being executed right now).
+    //------------------------------------------------------------------
+    ClangUserExpressionSP
+    FindExpression (ExecutionContext &exe_ctx,
+                    const char *expr_text,
+                    const char *expr_prefix,
+                    lldb::LanguageType language,
+                    ClangExpression::ResultType desired_type,
+                    ExecutionPolicy execution_policy);
+
+    //------------------------------------------------------------------
+    /// Remember \a expr_sp, which was just parsed successfully in
+    /// \a exe_ctx, evicting the least recently used expressions to keep
+    /// at most \a max_entries.
+    //------------------------------------------------------------------
+    void
+    AddExpression (ExecutionContext &exe_ctx,
+                   const char *expr_text,
+                   const char *expr_prefix,
+                   lldb::LanguageType language,
+                   ClangExpression::ResultType desired_type,
+                   ExecutionPolicy execution_policy,
+                   const ClangUserExpressionSP &expr_sp,
+                   size_t max_entries);
+
+    void
+    RemoveExpression (const ClangUserExpressionSP &expr_sp);
+
+    void
+    Clear ();
+
+    size_t
+    GetSize ();
+
+    uint64_t
+    GetNumHits () const
+    {
+        return m_num_hits;
+    }
+
+    uint64_t
+    GetNumMisses () const
+    {
+        return m_num_misses;
+    }
+
+protected:
+    struct Entry
+    {
+        std::string expr_text;
+        std::string expr_prefix;
+        lldb::LanguageType language;
+        ClangExpression::ResultType desired_type;
+        ExecutionPolicy execution_policy;
+        const void *scope;
+        ClangUserExpressionSP expr_sp;
+    };
+
+    typedef std::list<Entry> collection;    // Most recently used first
+
+    static bool
+    GetScope (ExecutionContext &exe_ctx, const void *&scope);
+
+    collection m_entries;
+    Mutex m_mutex;
+    uint64_t m_num_hits;
+    uint64_t m_num_misses;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (ClangUserExpressionCache);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_ClangUserExpressionCache_h_
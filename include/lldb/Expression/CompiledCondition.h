@@ -0,0 +1,178 @@
+//===-- CompiledCondition.h -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_CompiledCondition_h_
+#define liblldb_CompiledCondition_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Scalar.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class CompiledCondition CompiledCondition.h "lldb/Expression/CompiledCondition.h"
+/// @brief Evaluates simple conditions inside the debugger.
+///
+/// Breakpoint conditions are usually small: a few comparisons of
+/// local variables or struct members against constants, joined with
+/// && and ||.  Running those through ClangUserExpression costs a
+/// materialization of every referenced variable and possibly a call
+/// into the inferior on every hit.
+///
+/// This class compiles the subset of C made up of integer, floating
+/// point and character literals, variable expression paths (as
+/// understood by StackFrame::GetValueForVariableExpressionPath, e.g.
+/// "p->state", "a[3].x", "*ptr"), and the unary, arithmetic, bitwise,
+/// relational and logical operators into a small stack bytecode.
+/// Evaluating it reads only the variables that are referenced.
+///
+/// Anything outside that subset (casts, function calls, assignments,
+/// C++ member access through an implicit "this", ...) fails to compile
+/// or evaluate, and the caller is expected to fall back to a full
+/// expression evaluation.
+//----------------------------------------------------------------------
+class CompiledCondition
+{
+public:
+    CompiledCondition ();
+
+    ~CompiledCondition ();
+
+    //------------------------------------------------------------------
+    /// Compile \a expr, replacing any previously compiled condition.
+    ///
+    /// @return
+    ///     \b true if the condition can be evaluated by this class,
+    ///     \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    Compile (const char *expr);
+
+    //------------------------------------------------------------------
+    /// Evaluate the compiled condition in the context of \a frame.
+    ///
+    /// @param[out] result
+    ///     The value of the condition.
+    ///
+    /// @param[out] error
+    ///     Describes why the condition could not be evaluated.
+    ///
+    /// @return
+    ///     \b true if \a result holds the value of the condition,
+    ///     \b false if the condition must be evaluated some other way.
+    //------------------------------------------------------------------
+    bool
+    Evaluate (StackFrame &frame, Scalar &result, Error &error);
+
+    bool
+    IsValid () const
+    {
+        return !m_code.empty();
+    }
+
+    void
+    Clear ();
+
+    //------------------------------------------------------------------
+    /// Dump the compiled bytecode, for logging.
+    //------------------------------------------------------------------
+    void
+    Dump (Stream &strm) const;
+
+    enum OpCode
+    {
+        eOpPushConstant,        // Push m_constants[operand]
+        eOpPushVariable,        // Push the value of m_variables[operand]
+        eOpBranch,              // Jump to operand
+        eOpBranchIfZero,        // Pop, jump to operand if the value was zero
+        eOpBranchIfNotZero,     // Pop, jump to operand if the value was not zero
+        eOpLogicalNot,
+        eOpNegate,
+        eOpComplement,
+        eOpMultiply,
+        eOpDivide,
+        eOpRemainder,
+        eOpAdd,
+        eOpSubtract,
+        eOpShiftLeft,
+        eOpShiftRight,
+        eOpLessThan,
+        eOpLessThanOrEqual,
+        eOpGreaterThan,
+        eOpGreaterThanOrEqual,
+        eOpEqual,
+        eOpNotEqual,
+        eOpBitwiseAnd,
+        eOpBitwiseXor,
+        eOpBitwiseOr
+    };
+
+    struct Instruction
+    {
+        Instruction (OpCode o, uint32_t arg = 0) :
+            op (o),
+            operand (arg)
+        {
+        }
+
+        OpCode op;
+        uint32_t operand;
+    };
+
+    //------------------------------------------------------------------
+    // Accessors for clients that translate the bytecode into another
+    // form, e.g. an agent expression for a remote stub.
+    //------------------------------------------------------------------
+    const std::vector<Instruction> &
+    GetInstructions () const
+    {
+        return m_code;
+    }
+
+    const Scalar &
+    GetConstantAtIndex (uint32_t idx) const
+    {
+        return m_constants[idx];
+    }
+
+    const std::string &
+    GetVariablePathAtIndex (uint32_t idx) const
+    {
+        return m_variables[idx];
+    }
+
+protected:
+    friend class CompiledConditionParser;
+
+    bool
+    ReadVariable (StackFrame &frame, uint32_t var_idx, Scalar &value, bool &is_pointer, Error &error);
+
+    std::vector<Instruction> m_code;
+    std::vector<Scalar> m_constants;
+    std::vector<std::string> m_variables;   // Variable expression paths, each read at most once per evaluation
+    std::vector<Scalar> m_variable_values;  // Scratch space for Evaluate
+    std::vector<bool> m_variable_read;
+    std::vector<bool> m_variable_is_pointer;
+    std::vector<Scalar> m_stack;            // Scratch space for Evaluate
+    std::vector<bool> m_stack_is_pointer;   // Parallel to m_stack
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (CompiledCondition);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_CompiledCondition_h_
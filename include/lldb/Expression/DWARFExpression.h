@@ -10,6 +10,8 @@
 #ifndef liblldb_DWARFExpression_h_
 #define liblldb_DWARFExpression_h_
 
+#include <memory>
+
 #include "lldb/lldb-private.h"
 #include "lldb/Core/ClangForward.h"
 #include "lldb/Core/Address.h"
@@ -68,6 +70,12 @@ public:
     //------------------------------------------------------------------
     DWARFExpression(const DWARFExpression& rhs);
 
+    //------------------------------------------------------------------
+    /// Assignment operator
+    //------------------------------------------------------------------
+    const DWARFExpression&
+    operator= (const DWARFExpression& rhs);
+
     //------------------------------------------------------------------
     /// Destructor
     //------------------------------------------------------------------
@@ -378,6 +386,19 @@ public:
         data = m_data;
         return data.GetByteSize() > 0;
     }
+
+    //------------------------------------------------------------------
+    /// Get the opcodes that describe the location at \a addr: the whole
+    /// expression, or the matching entry of a location list.
+    ///
+    /// @param[in] loclist_base_addr
+    ///     The base address location list entries are relative to, in the
+    ///     same address space as \a addr.
+    //------------------------------------------------------------------
+    bool
+    GetExpressionDataAtAddress (lldb::addr_t loclist_base_addr,
+                                lldb::addr_t addr,
+                                DataExtractor &data);
     
     bool
     DumpLocationForAddress (Stream *s, 
@@ -387,6 +408,54 @@ public:
                             ABI *abi);
 
 protected:
+    struct CompiledExpression;
+    struct CompiledLocation;
+    struct LocationListEntry;
+    typedef std::shared_ptr<CompiledLocation> CompiledLocationSP;
+
+    //------------------------------------------------------------------
+    /// Get the decoded form of the opcodes, decoding them the first time
+    /// this is called after they were set.
+    ///
+    /// Variable locations are evaluated every time a frame's variables
+    /// are displayed.  Rather than decode the opcodes (and walk the
+    /// location list) every time, they are decoded once: location list
+    /// entries are sorted by address so the entry for a pc can be found
+    /// with a binary search, and the common single opcode locations
+    /// (DW_OP_addr, DW_OP_fbreg, DW_OP_bregN, DW_OP_regN and their "x"
+    /// forms) are evaluated without the expression stack.
+    ///
+    /// The decoded form is thrown away when the opcodes change, so
+    /// callers hold on to the returned shared pointer while they use it.
+    //------------------------------------------------------------------
+    CompiledLocationSP
+    GetCompiledLocation () const;
+
+    void
+    ClearCompiledLocation ();
+
+    //------------------------------------------------------------------
+    /// Find the location list entry of \a compiled whose range contains
+    /// \a addr.  If \a require_opcodes is true, entries with empty
+    /// expressions are skipped.  The entry belongs to \a compiled.
+    //------------------------------------------------------------------
+    const LocationListEntry *
+    FindLocationListEntry (const CompiledLocation &compiled,
+                           lldb::addr_t loclist_base_addr,
+                           lldb::addr_t addr,
+                           bool require_opcodes) const;
+
+    bool
+    EvaluateCompiledExpression (const CompiledExpression &compiled_expr,
+                                ExecutionContext *exe_ctx,
+                                ClangExpressionVariableList *expr_locals,
+                                ClangExpressionDeclMap *decl_map,
+                                RegisterContext *reg_ctx,
+                                lldb::ModuleSP module_sp,
+                                const Value* initial_value_ptr,
+                                Value& result,
+                                Error *error_ptr) const;
+
     //------------------------------------------------------------------
     /// Pretty-prints the location expression to a stream
     ///
@@ -429,6 +498,7 @@ protected:
     lldb::addr_t m_loclist_slide;               ///< A value used to slide the location list offsets so that 
                                                 ///< they are relative to the object that owns the location list
                                                 ///< (the function for frame base and variable location lists)
+    mutable CompiledLocationSP m_compiled_sp;   ///< The decoded opcodes, built when first evaluated
 
 };
 
@@ -46,6 +46,11 @@ public:
                   llvm::Function &function,
                   lldb_private::Error &error);
     
+    //------------------------------------------------------------------
+    /// Interpret the function.  Expressions with loops can run for a
+    /// long time, so interpretation fails once \a instruction_limit
+    /// instructions have been executed.
+    //------------------------------------------------------------------
     static bool
     Interpret (llvm::Module &module,
                llvm::Function &function,
@@ -53,7 +58,8 @@ public:
                lldb_private::IRMemoryMap &memory_map,
                lldb_private::Error &error,
                lldb::addr_t stack_frame_bottom,
-               lldb::addr_t stack_frame_top);
+               lldb::addr_t stack_frame_top,
+               uint64_t instruction_limit);
     
 private:   
     static bool
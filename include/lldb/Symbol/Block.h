@@ -442,6 +442,19 @@ public:
         return m_ranges.GetSize();
     }
 
+    //------------------------------------------------------------------
+    /// Get the offsets into the function's address range of one of
+    /// this block's ranges.
+    ///
+    /// @return
+    ///     The range, or NULL if \a range_idx is out of range.
+    //------------------------------------------------------------------
+    const Range *
+    GetRangeOffsetsAtIndex (uint32_t range_idx) const
+    {
+        return m_ranges.GetEntryAtIndex (range_idx);
+    }
+
     bool
     GetRangeContainingOffset (const lldb::addr_t offset, Range &range);
 
@@ -14,6 +14,7 @@
 #include <set>
 
 #include "lldb/lldb-types.h"
+#include "lldb/Host/TimeValue.h"
 #include "clang/AST/ASTImporter.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/FileSystemOptions.h"
@@ -27,7 +28,7 @@ public:
     static void DumpCounters (Log *log);
     static void ClearLocalCounters ()
     {
-        local_counters = { 0, 0, 0, 0, 0, 0 };
+        local_counters = { 0, 0, 0, 0, 0, 0, 0, 0 };
     }
     
     static void RegisterVisibleQuery ()
@@ -66,6 +67,27 @@ public:
         ++local_counters.m_record_layout_count;
     }
     
+    static void RegisterDeferredCompletion ()
+    {
+        ++global_counters.m_decls_deferred_count;
+        ++local_counters.m_decls_deferred_count;
+    }
+    
+    //------------------------------------------------------------------
+    /// Adds the time from construction to destruction to the time spent
+    /// importing and completing Decls.  Imports nest (completing a Decl
+    /// imports its members), so only the outermost timer counts.
+    //------------------------------------------------------------------
+    class ScopedImportTimer
+    {
+    public:
+        ScopedImportTimer ();
+        ~ScopedImportTimer ();
+    private:
+        TimeValue   m_start;
+        bool        m_outermost;
+    };
+    
 private:
     struct Counters
     {
@@ -75,6 +97,8 @@ private:
         uint64_t    m_clang_import_count;
         uint64_t    m_decls_completed_count;
         uint64_t    m_record_layout_count;
+        uint64_t    m_decls_deferred_count;
+        uint64_t    m_import_time_nsec;
     };
     
     static Counters global_counters;
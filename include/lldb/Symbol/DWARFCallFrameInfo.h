@@ -43,6 +43,21 @@ public:
 
     ~DWARFCallFrameInfo();
 
+    //------------------------------------------------------------------
+    // Provide the .eh_frame_hdr section that goes with this eh_frame.
+    //
+    // The .eh_frame_hdr contains a table of FDE initial locations,
+    // sorted by address, that the runtime uses to find an FDE with a
+    // binary search.  When it is available and well formed, single
+    // address lookups use the table and only decode the one FDE they
+    // need instead of scanning the entire eh_frame section.  The full
+    // FDE index is still built lazily for callers that need every
+    // function (GetFunctionAddressAndSizeVector) or when the table
+    // can't be used.
+    //------------------------------------------------------------------
+    void
+    SetEHFrameHdrSection (const lldb::SectionSP &section_sp);
+
     // Locate an AddressRange that includes the provided Address in this 
     // object's eh_frame/debug_info
     // Returns true if a range is found to cover that address.
@@ -116,6 +131,15 @@ private:
     void
     GetFDEIndex ();
 
+    bool
+    GetFDEEntryFromSearchTable (lldb::addr_t file_addr, FDEEntryMap::Entry& fde_entry);
+
+    bool
+    ParseEHFrameHdr ();
+
+    lldb::addr_t
+    GetSearchTableInitialLocation (uint32_t idx);
+
     bool
     FDEToUnwindPlan (uint32_t offset, Address startaddr, UnwindPlan& unwind_plan);
 
@@ -140,6 +164,15 @@ private:
 
     bool                        m_is_eh_frame;
 
+    // .eh_frame_hdr binary search table
+    lldb::SectionSP             m_hdr_section_sp;
+    DataExtractor               m_hdr_data;
+    bool                        m_hdr_parsed;             // only parse the .eh_frame_hdr header once
+    lldb::offset_t              m_hdr_table_offset;       // offset of the first table entry in m_hdr_data
+    uint32_t                    m_hdr_fde_count;          // number of entries in the table, zero if the table is unusable
+    uint8_t                     m_hdr_table_enc;          // DW_EH_PE encoding of the table entries
+    uint8_t                     m_hdr_entry_size;         // byte size of one (initial_loc, fde_addr) entry
+
     CIESP
     ParseCIE (const uint32_t cie_offset);
 
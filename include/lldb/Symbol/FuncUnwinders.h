@@ -18,7 +18,8 @@ public:
 
     // We'll record three different UnwindPlans for each address range:
     //   1. Unwinding from a call site (a valid exception throw location)
-    //      This is often sourced from the eh_frame exception handling info
+    //      This is often sourced from the eh_frame exception handling info,
+    //      or from the debug_frame when there is no eh_frame for the function
     //   2. Unwinding from a non-call site (any location in the function)
     //      This is often done by analyzing the function prologue assembly
     //      langauge instructions
@@ -478,6 +478,36 @@ public:
     Block&
     GetBlock (bool can_create);
 
+    //------------------------------------------------------------------
+    /// Find the innermost block of this function that contains an
+    /// address.
+    ///
+    /// The ranges of all the blocks in the function are flattened into
+    /// a table, sorted by address, of the innermost block for each
+    /// range the first time this is called, so finding the block for
+    /// an address (and with it the inlined functions it is in) is a
+    /// binary search no matter how deeply blocks are nested.
+    ///
+    /// @param[in] addr
+    ///     A section offset address in the same address space as the
+    ///     function's address range.
+    ///
+    /// @return
+    ///     The innermost block that contains \a addr, or NULL if
+    ///     \a addr isn't in any of this function's blocks.
+    //------------------------------------------------------------------
+    Block *
+    FindBlockContainingAddress (const Address &addr);
+
+    //------------------------------------------------------------------
+    /// Find the innermost block of this function that contains an
+    /// offset into the function's address range.
+    ///
+    /// @see Function::FindBlockContainingAddress (const Address &)
+    //------------------------------------------------------------------
+    Block *
+    FindBlockContainingOffset (lldb::addr_t func_offset);
+
     //------------------------------------------------------------------
     /// Get accessor for the compile unit that owns this function.
     ///
@@ -623,9 +653,15 @@ protected:
 
     enum
     {
-        flagsCalculatedPrologueSize = (1 << 0)  ///< Have we already tried to calculate the prologue size?
+        flagsCalculatedPrologueSize = (1 << 0), ///< Have we already tried to calculate the prologue size?
+        flagsCalculatedBlockRanges  = (1 << 1)  ///< Have we already built m_block_ranges?
     };
 
+    typedef RangeDataVector<uint32_t, uint32_t, Block *> BlockRangeMap;
+
+    void
+    CalculateBlockRanges ();
+
 
 
     //------------------------------------------------------------------
@@ -640,6 +676,7 @@ protected:
     DWARFExpression m_frame_base;   ///< The frame base expression for variables that are relative to the frame pointer.
     Flags m_flags;
     uint32_t m_prologue_byte_size;  ///< Compute the prologue size once and cache it
+    BlockRangeMap m_block_ranges;   ///< Offsets into the function's address range mapped to the innermost block that contains them
 private:
     DISALLOW_COPY_AND_ASSIGN(Function);
 };
@@ -106,6 +106,7 @@ protected:
     typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t> FileRangeToIndexMap;
             void        InitNameIndexes ();
             void        InitAddressIndexes ();
+            void        AppendSymbolIndexesMatchingRegEx (const RegularExpression &regex, const std::vector<uint32_t> &candidate_indexes, std::vector<uint32_t>& indexes);
 
     ObjectFile *        m_objfile;
     collection          m_symbols;
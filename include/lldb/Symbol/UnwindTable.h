@@ -11,15 +11,23 @@
 #ifndef liblldb_UnwindTable_h
 #define liblldb_UnwindTable_h
 
+#include <list>
 #include <map>
 
 #include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
 
 // A class which holds all the FuncUnwinders objects for a given ObjectFile.
 // The UnwindTable is populated with FuncUnwinders objects lazily during
 // the debug session.
+//
+// Since the ObjectFile is shared by every target and thread that has the
+// Module loaded, the UnwindPlans computed for a function are reused across
+// threads and stops.  The table is protected by a mutex and holds at most
+// GetMaximumCachedFuncUnwinders() entries; the least recently used
+// FuncUnwinders are dropped when it grows past that.
 
 class UnwindTable
 {
@@ -30,6 +38,18 @@ public:
     lldb_private::DWARFCallFrameInfo *
     GetEHFrameInfo ();
 
+    // The .debug_frame call frame information, if the ObjectFile has any.
+    // Binaries built with -fno-asynchronous-unwind-tables often have no
+    // eh_frame but may still have debug_frame.
+    lldb_private::DWARFCallFrameInfo *
+    GetDebugFrameInfo ();
+
+    static size_t
+    GetMaximumCachedFuncUnwinders ();
+
+    size_t
+    GetNumCachedFuncUnwinders ();
+
     lldb::FuncUnwindersSP
     GetFuncUnwindersContainingAddress (const Address& addr, SymbolContext &sc);
 
@@ -48,18 +68,33 @@ private:
     
     void Initialize ();
 
-    typedef std::map<lldb::addr_t, lldb::FuncUnwindersSP> collection;
+    bool
+    GetAddressRangeFromCallFrameInfo (const Address& addr, AddressRange &range);
+
+    // Function file addresses, most recently used first
+    typedef std::list<lldb::addr_t> lru_list;
+
+    struct CachedFuncUnwinders
+    {
+        lldb::FuncUnwindersSP func_unwinders_sp;
+        lru_list::iterator lru_pos;
+    };
+
+    typedef std::map<lldb::addr_t, CachedFuncUnwinders> collection;
     typedef collection::iterator iterator;
     typedef collection::const_iterator const_iterator;
 
     ObjectFile&         m_object_file;
     collection          m_unwinds;
+    lru_list            m_lru;
+    Mutex               m_mutex;        // protects everything below m_object_file
 
     bool                m_initialized;  // delay some initialization until ObjectFile is set up
 
     lldb::UnwindAssemblySP m_assembly_profiler;
 
     DWARFCallFrameInfo* m_eh_frame;
+    DWARFCallFrameInfo* m_debug_frame;
     
     DISALLOW_COPY_AND_ASSIGN (UnwindTable);
 };
@@ -48,6 +48,16 @@ namespace lldb_private {
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        // Fill the cache lines covering [addr, addr + size) that aren't
+        // already cached with a single read from the inferior.  Returns
+        // the number of bytes that were read from the inferior.
+        //------------------------------------------------------------------
+        size_t
+        Prefetch (lldb::addr_t addr,
+                  size_t size,
+                  Error &error);
         
         uint32_t
         GetMemoryCacheLineSize() const
@@ -169,6 +179,22 @@ namespace lldb_private {
         bool
         DeallocateMemory (lldb::addr_t ptr);
         
+        //------------------------------------------------------------------
+        // The number of AllocateMemory calls, and the number of times the
+        // process itself was asked for memory to serve them.
+        //------------------------------------------------------------------
+        uint64_t
+        GetNumAllocations () const
+        {
+            return m_num_allocations;
+        }
+
+        uint64_t
+        GetNumProcessAllocations () const
+        {
+            return m_num_process_allocations;
+        }
+
     protected:
         typedef std::shared_ptr<AllocatedBlock> AllocatedBlockSP;
 
@@ -186,6 +212,8 @@ namespace lldb_private {
         Mutex m_mutex;
         typedef std::multimap<uint32_t, AllocatedBlockSP> PermissionsToBlockMap;
         PermissionsToBlockMap m_memory_map;
+        uint64_t m_num_process_allocations;
+        uint64_t m_num_allocations;
         
     private:
         DISALLOW_COPY_AND_ASSIGN (AllocatedMemoryCache);
@@ -51,6 +51,12 @@
 
 namespace lldb_private {
 
+typedef enum FollowForkMode
+{
+    eFollowForkParent = 0,
+    eFollowForkChild
+} FollowForkMode;
+
 //----------------------------------------------------------------------
 // ProcessProperties
 //----------------------------------------------------------------------
@@ -100,6 +106,27 @@ public:
     
     void
     SetDetachKeepsStopped (bool keep_stopped);
+
+    uint64_t
+    GetExpressionArenaSize () const;
+
+    bool
+    GetNonStopModeEnabled () const;
+
+    void
+    SetNonStopModeEnabled (bool enable);
+
+    bool
+    GetDisplacedSteppingEnabled () const;
+
+    void
+    SetDisplacedSteppingEnabled (bool enable);
+
+    FollowForkMode
+    GetFollowForkMode () const;
+
+    void
+    SetFollowForkMode (FollowForkMode mode);
 };
 
 typedef std::shared_ptr<ProcessProperties> ProcessPropertiesSP;
@@ -2835,6 +2862,22 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Populate the memory cache for a range of memory in one read.
+    ///
+    /// Later ReadMemory() calls in the range are satisfied from the
+    /// cache.  Used to batch the many small reads that stack walks
+    /// make into one large read per stack.
+    ///
+    /// @return
+    ///     The number of bytes read from the inferior, zero if the
+    ///     range was already cached or the memory cache is disabled.
+    //------------------------------------------------------------------
+    size_t
+    PrefetchMemory (lldb::addr_t vm_addr,
+                    size_t size,
+                    Error &error);
     
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
@@ -3556,6 +3599,50 @@ public:
     {   
         return true;
     }
+
+    //------------------------------------------------------------------
+    /// Check if threads of this process can keep running while the
+    /// process is stopped.
+    ///
+    /// In non-stop mode only the threads that stop for an event are
+    /// stopped when the process stops.  Threads whose state is still
+    /// running take no part in deciding whether to stop, and are left
+    /// alone when the process resumes.
+    ///
+    /// @return
+    ///     Returns \b true if the plug-in supports non-stop mode and it
+    ///     is enabled, \b false otherwise.
+    //------------------------------------------------------------------
+    virtual bool
+    IsNonStopModeActive ()
+    {
+        return false;
+    }
+
+    //------------------------------------------------------------------
+    /// Get a scratch slot in the inferior to copy an instruction to, so
+    /// it can be stepped without removing a breakpoint trap.
+    ///
+    /// The slots are carved out of memory allocated the first time the
+    /// process is resumed with displaced stepping enabled.  Allocating
+    /// memory may run code in the inferior, which can't be done while
+    /// the threads are being set up to resume.
+    ///
+    /// @return
+    ///     The address of a slot of GetDisplacedStepSlotSize() bytes, or
+    ///     LLDB_INVALID_ADDRESS if there is no free slot.
+    //------------------------------------------------------------------
+    lldb::addr_t
+    AcquireDisplacedStepSlot ();
+
+    void
+    ReleaseDisplacedStepSlot (lldb::addr_t slot_addr);
+
+    static size_t
+    GetDisplacedStepSlotSize ()
+    {
+        return 32;
+    }
     
     void
     SetRunningUserExpression (bool on);
@@ -3805,6 +3892,10 @@ protected:
     lldb::StateType             m_last_broadcast_state;   /// This helps with the Public event coalescing in ShouldBroadcastEvent.
     std::map<lldb::addr_t,lldb::addr_t> m_resolved_indirect_addresses;
     bool m_destroy_in_process;
+    lldb::addr_t                m_displaced_step_arena;         // Memory the displaced step slots are carved out of.
+    bool                        m_displaced_step_arena_tried;   // Set once allocating m_displaced_step_arena was tried.
+    std::vector<lldb::addr_t>   m_displaced_step_free_slots;
+    Mutex                       m_displaced_step_mutex;
     
     enum {
         eCanJITDontKnow= 0,
@@ -3815,6 +3906,12 @@ protected:
     size_t
     RemoveBreakpointOpcodesFromBuffer (lldb::addr_t addr, size_t size, uint8_t *buf) const;
 
+    void
+    AllocateDisplacedStepArena ();
+
+    void
+    ClearDisplacedStepArena ();
+
     void
     SynchronouslyNotifyStateChanged (lldb::StateType state);
 
@@ -165,6 +165,18 @@ public:
     bool
     GetUseFastStepping() const;
     
+    bool
+    GetUseFastBreakpointConditions () const;
+
+    uint64_t
+    GetExpressionCacheSize () const;
+
+    bool
+    GetExpressionLazyTypeCompletion () const;
+
+    uint64_t
+    GetExpressionInterpreterInstructionLimit () const;
+
     bool
     GetDisplayExpressionsInCrashlogs () const;
 
@@ -1098,6 +1110,9 @@ public:
         return m_persistent_variables;
     }
 
+    ClangUserExpressionCache &
+    GetExpressionCache();
+
     //------------------------------------------------------------------
     // Target Stop Hooks
     //------------------------------------------------------------------
@@ -1299,6 +1314,7 @@ protected:
     std::unique_ptr<ClangASTSource> m_scratch_ast_source_ap;
     std::unique_ptr<ClangASTImporter> m_ast_importer_ap;
     ClangPersistentVariables m_persistent_variables;      ///< These are the persistent variables associated with this process for the expression parser.
+    std::unique_ptr<ClangUserExpressionCache> m_expression_cache_ap;    ///< Recently parsed expressions, for evaluating them again without parsing.
 
     std::unique_ptr<SourceManager> m_source_manager_ap;
 
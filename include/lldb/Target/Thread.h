@@ -216,6 +216,15 @@ public:
     // will get to run and how.
     void
     SetupForResume ();
+
+    // Return true if this thread runs the instruction under a hardware
+    // breakpoint at its PC when it is resumed, instead of stopping there
+    // again.  Otherwise the breakpoint is stepped over like a software one.
+    virtual bool
+    CanResumePastHardwareBreakpoint ()
+    {
+        return false;
+    }
     
     // Do not override this function, it is for thread plan logic only
     bool
@@ -276,6 +285,20 @@ public:
     bool
     ThreadStoppedForAReason ();
 
+    //------------------------------------------------------------------
+    /// Returns true if nothing has happened to this thread at this stop
+    /// and nobody has looked at it yet: it has no stop reason, nothing
+    /// but the base plan on its plan stack and no stack frames.
+    ///
+    /// Processes with thousands of threads usually stop because of one
+    /// of them, so the stop and resume logic skips idle threads rather
+    /// than reading their registers and asking their plans about a stop
+    /// that didn't concern them.  Inspecting the thread (e.g. getting
+    /// its frames) makes it a regular thread again until it resumes.
+    //------------------------------------------------------------------
+    bool
+    IsIdle ();
+
     static const char *
     RunModeAsCString (lldb::RunMode mode);
 
@@ -332,6 +355,20 @@ public:
     {
         return GetStackFrameList()->GetFrameAtIndex(idx);
     }
+
+    //------------------------------------------------------------------
+    /// Get the pc of up to \a max_frames frames, youngest first.
+    ///
+    /// This is a fast stack walk that doesn't create StackFrame objects
+    /// or their register and symbol contexts; the frames returned by
+    /// GetStackFrameAtIndex() are still only built when asked for.
+    /// Inlined frames are not included.
+    ///
+    /// @return
+    ///     The number of pcs placed in \a pcs.
+    //------------------------------------------------------------------
+    uint32_t
+    GetStackPCs (std::vector<lldb::addr_t> &pcs, uint32_t max_frames);
     
     virtual lldb::StackFrameSP
     GetFrameWithConcreteFrameIndex (uint32_t unwind_idx);
@@ -744,6 +781,13 @@ public:
     //------------------------------------------------------------------
     ThreadPlan *
     GetCurrentPlan ();
+
+    //------------------------------------------------------------------
+    /// Tells whether a plan that isn't private to another plan, e.g. a
+    /// step the user asked for, is on the plan stack.
+    //------------------------------------------------------------------
+    bool
+    HasPublicPlans ();
     
     //------------------------------------------------------------------
     /// Unwinds the thread stack for the innermost expression plan currently
@@ -987,6 +1031,17 @@ public:
     virtual bool
     CalculateStopInfo () = 0;
 
+    //----------------------------------------------------------------------
+    // Returns true if the thread subclass knows, without asking the
+    // target, that the thread has no stop reason at this stop.  Only then
+    // can the thread be idle (see Thread::IsIdle()).
+    //----------------------------------------------------------------------
+    virtual bool
+    KnownToHaveNoStopReason ()
+    {
+        return false;
+    }
+
     //----------------------------------------------------------------------
     // Gets the temporary resume state for a thread.
     //
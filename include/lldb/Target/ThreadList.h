@@ -137,6 +137,29 @@ public:
     void
     DiscardThreadPlans();
 
+    //------------------------------------------------------------------
+    /// Unwind the stacks of all threads concurrently.
+    ///
+    /// The top of each thread's stack is prefetched into the process
+    /// memory cache with one read per stack, then  num_workers host
+    /// threads compute the stack frames of the threads in the list.
+    /// The frames are cached in each Thread's StackFrameList, so later
+    /// calls like Thread::GetStatus() don't need to unwind again.
+    ///
+    /// @param[in] max_frames
+    ///     The number of frames to compute per thread, UINT32_MAX
+    ///     for the whole stack.
+    ///
+    /// @param[in] num_workers
+    ///     The number of worker threads to use, zero to use one per
+    ///     host CPU.
+    ///
+    /// @return
+    ///     The number of threads that were unwound.
+    //------------------------------------------------------------------
+    uint32_t
+    ComputeStackFrames (uint32_t max_frames, uint32_t num_workers);
+
     uint32_t
     GetStopID () const;
 
@@ -418,6 +418,15 @@ public:
         // in the middle of the plan being queued on a thread can be done here.
     }
 
+    virtual void
+    ThreadStopped ()
+    {
+        // Called on the current plan when its thread stops, before the reason
+        // for the stop is worked out.  A plan that ran the thread somewhere
+        // the user shouldn't see (e.g. a copy of an instruction) can put the
+        // thread back where it belongs here.
+    }
+
     bool
     GetPrivate ()
     {
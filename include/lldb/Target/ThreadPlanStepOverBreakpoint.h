@@ -33,6 +33,8 @@ public:
     virtual bool WillStop ();
     virtual bool MischiefManaged ();
     virtual void ThreadDestroyed ();
+    virtual void ThreadStopped ();
+    virtual void WillPop ();
     void SetAutoContinue (bool do_it);
     virtual bool ShouldAutoContinue(Event *event_ptr);
 
@@ -41,12 +43,26 @@ protected:
     virtual bool DoWillResume (lldb::StateType resume_state, bool current_plan);
 
     void ReenableBreakpointSite ();
+
+    bool
+    IsDisplaced () const
+    {
+        return m_displaced_step_addr != LLDB_INVALID_ADDRESS;
+    }
+
+    void MoveBackFromDisplacedStep ();
+    void ReleaseDisplacedStepSlot ();
+
+    static size_t
+    RelocateInstruction (Thread &thread, lldb::addr_t from_addr, lldb::addr_t to_addr);
 private:
 
     lldb::addr_t m_breakpoint_addr;
     lldb::user_id_t m_breakpoint_site_id;
     bool m_auto_continue;
     bool m_reenabled_breakpoint_site;
+    lldb::addr_t m_displaced_step_addr;     // Where the instruction under the breakpoint was copied to, if it was
+    size_t m_displaced_step_length;
 
     DISALLOW_COPY_AND_ASSIGN (ThreadPlanStepOverBreakpoint);
 
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
@@ -84,6 +85,21 @@ public:
         Mutex::Locker locker(m_unwind_mutex);
         return DoCreateRegisterContextForFrame (frame);
     }
+
+    //------------------------------------------------------------------
+    // Get the pc of each frame, youngest first, without building the
+    // register contexts, symbol contexts or StackFrame objects that a
+    // full unwind does.  Meant for callers that only need addresses,
+    // like samplers and backtrace summaries, and that may ask for the
+    // stack many times.  Returns the number of pcs in \a pcs.
+    //------------------------------------------------------------------
+    uint32_t
+    GetStackPCs (std::vector<lldb::addr_t> &pcs, uint32_t max_frames)
+    {
+        Mutex::Locker locker(m_unwind_mutex);
+        pcs.clear();
+        return DoGetStackPCs (pcs, max_frames);
+    }
     
     Thread &
     GetThread()
@@ -109,6 +125,21 @@ protected:
     virtual lldb::RegisterContextSP
     DoCreateRegisterContextForFrame (StackFrame *frame) = 0;
 
+    // Unwinders without a cheaper way to get just the pcs use the full unwind.
+    virtual uint32_t
+    DoGetStackPCs (std::vector<lldb::addr_t> &pcs, uint32_t max_frames)
+    {
+        lldb::addr_t cfa;
+        lldb::addr_t pc;
+        for (uint32_t idx = 0; idx < max_frames; idx++)
+        {
+            if (!DoGetFrameInfoAtIndex (idx, cfa, pc))
+                break;
+            pcs.push_back (pc);
+        }
+        return pcs.size();
+    }
+
     Thread &m_thread;
     Mutex  m_unwind_mutex;
 private:
@@ -527,7 +527,8 @@ namespace lldb {
         eSectionTypeELFRelocationEntries, // Elf SHT_REL or SHT_REL section
         eSectionTypeELFDynamicLinkInfo,   // Elf SHT_DYNAMIC section
         eSectionTypeEHFrame,
-        eSectionTypeOther
+        eSectionTypeOther,
+        eSectionTypeEHFrameHdr            // .eh_frame_hdr sorted FDE search table
         
     } SectionType;
 
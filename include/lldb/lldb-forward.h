@@ -37,6 +37,7 @@ class   BreakpointLocation;
 class   BreakpointLocationCollection;
 class   BreakpointLocationList;
 class   BreakpointOptions;
+class   BreakpointResolutionIndex;
 class   BreakpointResolver;
 class   BreakpointSite;
 class   BreakpointSiteList;
@@ -60,6 +61,7 @@ class   ClangExpressionVariables;
 class   ClangFunction;
 class   ClangPersistentVariables;
 class   ClangUserExpression;
+class   ClangUserExpressionCache;
 class   ClangUtilityFunction;
 class   CommandInterpreter;
 class   CommandObject;
@@ -164,6 +164,14 @@ public:
     lldb::SBThread
     GetSelectedThread () const;
 
+    %feature("autodoc", "
+    Unwinds the stacks of all threads concurrently, computing up to max_frames
+    frames per thread (UINT32_MAX for the whole stack) with num_workers worker
+    threads (0 for one per CPU).  Returns the number of threads unwound.
+    ") ComputeStackFramesForAllThreads;
+    uint32_t
+    ComputeStackFramesForAllThreads (uint32_t max_frames, uint32_t num_workers);
+
     %feature("autodoc", "
     Lazily create a thread on demand through the current OperatingSystem plug-in, if the current OperatingSystem plug-in supports it.
     ") CreateOSPluginThread;
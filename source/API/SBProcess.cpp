@@ -948,6 +948,35 @@ SBProcess::GetThreadByIndexID (uint32_t index_id)
     return sb_thread;
 }
 
+uint32_t
+SBProcess::ComputeStackFramesForAllThreads (uint32_t max_frames, uint32_t num_workers)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    uint32_t num_threads = 0;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Process::StopLocker stop_locker;
+        if (stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+            num_threads = process_sp->GetThreadList().ComputeStackFrames (max_frames, num_workers);
+        }
+        else
+        {
+            if (log)
+                log->Printf ("SBProcess(%p)::ComputeStackFramesForAllThreads() => error: process is running", process_sp.get());
+        }
+    }
+
+    if (log)
+        log->Printf ("SBProcess(%p)::ComputeStackFramesForAllThreads (max_frames=%u, num_workers=%u) => %u",
+                     process_sp.get(), max_frames, num_workers, num_threads);
+
+    return num_threads;
+}
+
 StateType
 SBProcess::GetStateFromEvent (const SBEvent &event)
 {
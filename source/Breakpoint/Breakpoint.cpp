@@ -641,6 +641,14 @@ Breakpoint::GetDescription (Stream *s, lldb::DescriptionLevel level, bool show_l
     }
 }
 
+bool
+Breakpoint::AddToResolutionIndex (BreakpointResolutionIndex &index)
+{
+    if (m_resolver_sp)
+        return m_resolver_sp->AddToResolutionIndex (index);
+    return false;
+}
+
 void
 Breakpoint::GetResolverDescription (Stream *s)
 {
@@ -13,6 +13,9 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/lldb-private-log.h"
+#include "lldb/Breakpoint/BreakpointResolutionIndex.h"
+#include "lldb/Core/Log.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -213,9 +216,50 @@ void
 BreakpointList::UpdateBreakpoints (ModuleList& module_list, bool added, bool delete_locations)
 {
     Mutex::Locker locker(m_mutex);
+    if (!added)
+    {
+        for (const auto &bp_sp : m_breakpoints)
+            bp_sp->ModulesChanged (module_list, added, delete_locations);
+        return;
+    }
+
+    // Rather than having every breakpoint search every new module, look
+    // the names and files the breakpoints want up in each module once and
+    // only hand the breakpoints the modules that can have matches.
+    BreakpointResolutionIndex index;
+    std::vector<bool> indexed;
+    indexed.reserve (m_breakpoints.size());
+    for (const auto &bp_sp : m_breakpoints)
+        indexed.push_back (index.AddBreakpoint (bp_sp));
+
+    BreakpointResolutionIndex::BreakpointModulesMap bp_modules;
+    index.FindModulesToSearch (module_list, bp_modules);
+
+    size_t bp_idx = 0;
+    size_t num_searched = 0;
     for (const auto &bp_sp : m_breakpoints)
-        bp_sp->ModulesChanged (module_list, added, delete_locations);
+    {
+        if (!indexed[bp_idx++])
+        {
+            bp_sp->ModulesChanged (module_list, added, delete_locations);
+            ++num_searched;
+            continue;
+        }
+        BreakpointResolutionIndex::BreakpointModulesMap::iterator pos = bp_modules.find (bp_sp.get());
+        if (pos != bp_modules.end())
+        {
+            bp_sp->ModulesChanged (pos->second, added, delete_locations);
+            ++num_searched;
+        }
+    }
 
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("BreakpointList::UpdateBreakpoints: %" PRIu64 " modules loaded, %" PRIu64 " of %" PRIu64 " breakpoints indexed, %" PRIu64 " searched",
+                     (uint64_t)module_list.GetSize(),
+                     (uint64_t)index.GetNumIndexedBreakpoints(),
+                     (uint64_t)m_breakpoints.size(),
+                     (uint64_t)num_searched);
 }
 
 void
@@ -11,6 +11,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <string>
 
 // Other libraries and framework includes
@@ -25,6 +26,7 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Symbol.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Thread.h"
@@ -51,7 +53,10 @@ BreakpointLocation::BreakpointLocation
     m_owner (owner),
     m_options_ap (),
     m_bp_site_sp (),
-    m_condition_mutex ()
+    m_condition_mutex (),
+    m_condition_hash (0),
+    m_compiled_condition (),
+    m_compiled_condition_hash (0)
 {
     if (check_for_resolver)
     {
@@ -259,6 +264,71 @@ BreakpointLocation::GetConditionText (size_t *hash) const
     return GetOptionsNoCreate()->GetConditionText(hash);
 }
 
+bool
+BreakpointLocation::ConditionSaysStopWithoutExpression (ExecutionContext &exe_ctx, bool &condition_says_stop)
+{
+    Mutex::Locker evaluation_locker(m_condition_mutex);
+    
+    size_t condition_hash;
+    const char *condition_text = GetConditionText(&condition_hash);
+    if (!condition_text)
+        return false;
+    return EvaluateCompiledCondition (exe_ctx, condition_text, condition_hash, condition_says_stop);
+}
+
+// Must be called with m_condition_mutex locked.
+bool
+BreakpointLocation::EvaluateCompiledCondition (ExecutionContext &exe_ctx,
+                                               const char *condition_text,
+                                               size_t condition_hash,
+                                               bool &condition_says_stop)
+{
+    // Conditions that only compare and combine variables can be evaluated
+    // directly against the frame, reading just the variables they use,
+    // without materializing or running an expression.
+    if (!m_owner.GetTarget().GetUseFastBreakpointConditions())
+        return false;
+
+    Log *log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS);
+
+    if (condition_hash != m_compiled_condition_hash)
+    {
+        const bool compiled = m_compiled_condition.Compile(condition_text);
+        m_compiled_condition_hash = condition_hash;
+        if (log)
+        {
+            log->Printf("Condition \"%s\" %s be evaluated without the expression parser.",
+                        condition_text,
+                        compiled ? "can" : "can not");
+            if (compiled && log->GetVerbose())
+            {
+                StreamString strm;
+                m_compiled_condition.Dump(strm);
+                log->Printf("%s", strm.GetData());
+            }
+        }
+    }
+    
+    StackFrame *frame = exe_ctx.GetFramePtr();
+    if (frame == NULL || !m_compiled_condition.IsValid())
+        return false;
+
+    Scalar scalar_value;
+    Error compiled_error;
+    if (m_compiled_condition.Evaluate(*frame, scalar_value, compiled_error))
+    {
+        condition_says_stop = !scalar_value.IsZero();
+        if (log)
+            log->Printf("Condition successfully evaluated without the expression parser, result is %s.\n",
+                        condition_says_stop ? "true" : "false");
+        return true;
+    }
+    if (log)
+        log->Printf("Couldn't evaluate condition without the expression parser (%s), using an expression.",
+                    compiled_error.AsCString());
+    return false;
+}
+
 bool
 BreakpointLocation::ConditionSaysStop (ExecutionContext &exe_ctx, Error &error)
 {
@@ -272,9 +342,14 @@ BreakpointLocation::ConditionSaysStop (ExecutionContext &exe_ctx, Error &error)
     if (!condition_text)
     {
         m_user_expression_sp.reset();
+        m_compiled_condition.Clear();
         return false;
     }
     
+    bool condition_says_stop;
+    if (EvaluateCompiledCondition (exe_ctx, condition_text, condition_hash, condition_says_stop))
+        return condition_says_stop;
+    
     if (condition_hash != m_condition_hash ||
         !m_user_expression_sp ||
         !m_user_expression_sp->MatchesContext(exe_ctx))
@@ -382,6 +457,17 @@ BreakpointLocation::SetIgnoreCount (uint32_t n)
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeIgnoreChanged);
 }
 
+uint32_t
+BreakpointLocation::GetHitsToIgnore () const
+{
+    // The location's ignore count also counts down the breakpoint's, see
+    // IgnoreCountShouldStop.
+    uint32_t ignore = m_owner.GetIgnoreCount();
+    if (m_options_ap.get() != NULL)
+        ignore = std::max (ignore, m_options_ap->GetIgnoreCount());
+    return ignore;
+}
+
 void
 BreakpointLocation::DecrementIgnoreCount()
 {
@@ -0,0 +1,234 @@
+//===-- BreakpointResolutionIndex.cpp ---------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Breakpoint/BreakpointResolutionIndex.h"
+
+// C Includes
+// C++ Includes
+#include <set>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/SymbolContext.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+BreakpointResolutionIndex::BreakpointResolutionIndex () :
+    m_function_names (),
+    m_function_name_keys (),
+    m_source_files (),
+    m_source_file_basenames (),
+    m_have_inline_source_files (false),
+    m_indexed_breakpoints ()
+{
+}
+
+BreakpointResolutionIndex::~BreakpointResolutionIndex ()
+{
+}
+
+bool
+BreakpointResolutionIndex::AddBreakpoint (const BreakpointSP &bp_sp)
+{
+    if (!bp_sp->AddToResolutionIndex (*this))
+        return false;
+    m_indexed_breakpoints.push_back (bp_sp);
+    return true;
+}
+
+void
+BreakpointResolutionIndex::AddFunctionName (Breakpoint *bp,
+                                            const ConstString &lookup_name,
+                                            uint32_t name_type_mask)
+{
+    const std::pair<const char *, uint32_t> key (lookup_name.GetCString(), name_type_mask);
+    FunctionNameKeyMap::const_iterator pos = m_function_name_keys.find (key);
+    size_t key_idx;
+    if (pos == m_function_name_keys.end())
+    {
+        key_idx = m_function_names.size();
+        m_function_names.push_back (FunctionNameKey());
+        m_function_names.back().lookup_name = lookup_name;
+        m_function_names.back().name_type_mask = name_type_mask;
+        m_function_name_keys[key] = key_idx;
+    }
+    else
+        key_idx = pos->second;
+    m_function_names[key_idx].breakpoints.push_back (bp);
+}
+
+void
+BreakpointResolutionIndex::AddSourceFile (Breakpoint *bp,
+                                          const FileSpec &file_spec,
+                                          bool check_inlines)
+{
+    const char *basename = file_spec.GetFilename().GetCString();
+    std::pair<KeyIndexMap::const_iterator, KeyIndexMap::const_iterator> range = m_source_file_basenames.equal_range (basename);
+    for (KeyIndexMap::const_iterator pos = range.first; pos != range.second; ++pos)
+    {
+        SourceFileKey &key = m_source_files[pos->second];
+        if (key.check_inlines == check_inlines && key.file_spec == file_spec)
+        {
+            key.breakpoints.push_back (bp);
+            return;
+        }
+    }
+
+    m_source_file_basenames.insert (std::make_pair (basename, m_source_files.size()));
+    m_source_files.push_back (SourceFileKey());
+    m_source_files.back().file_spec = file_spec;
+    m_source_files.back().check_inlines = check_inlines;
+    m_source_files.back().breakpoints.push_back (bp);
+    if (check_inlines)
+        m_have_inline_source_files = true;
+}
+
+void
+BreakpointResolutionIndex::AddModuleToBreakpoints (const std::vector<Breakpoint *> &breakpoints,
+                                                   const ModuleSP &module_sp,
+                                                   BreakpointModulesMap &bp_modules)
+{
+    for (size_t i = 0; i < breakpoints.size(); ++i)
+        bp_modules[breakpoints[i]].AppendIfNeeded (module_sp);
+}
+
+void
+BreakpointResolutionIndex::FindFunctionNamesInModule (const ModuleSP &module_sp,
+                                                      BreakpointModulesMap &bp_modules)
+{
+    // Look each name up once for all the breakpoints that want it.  This
+    // is the same lookup BreakpointResolverName does, so it can't miss a
+    // module the resolver would have found something in.
+    const bool include_symbols = true;
+    const bool include_inlines = true;
+    const bool append = false;
+    SymbolContextList sc_list;
+    for (size_t i = 0; i < m_function_names.size(); ++i)
+    {
+        const FunctionNameKey &key = m_function_names[i];
+        if (module_sp->FindFunctions (key.lookup_name,
+                                      NULL,
+                                      key.name_type_mask,
+                                      include_symbols,
+                                      include_inlines,
+                                      append,
+                                      sc_list) > 0)
+            AddModuleToBreakpoints (key.breakpoints, module_sp, bp_modules);
+    }
+}
+
+void
+BreakpointResolutionIndex::FindSourceFilesInModule (const ModuleSP &module_sp,
+                                                    BreakpointModulesMap &bp_modules)
+{
+    // A file can only produce locations in a compile unit whose support
+    // files include it, and unless inlines are checked the compile unit
+    // itself has to be that file (see CompileUnit::ResolveSymbolContext).
+    std::vector<bool> key_found (m_source_files.size(), false);
+    std::set<size_t> candidate_keys;
+    const size_t num_comp_units = module_sp->GetNumCompileUnits();
+    for (size_t cu_idx = 0; cu_idx < num_comp_units; ++cu_idx)
+    {
+        CompUnitSP cu_sp (module_sp->GetCompileUnitAtIndex (cu_idx));
+        if (!cu_sp)
+            continue;
+
+        candidate_keys.clear();
+        std::pair<KeyIndexMap::const_iterator, KeyIndexMap::const_iterator> range = m_source_file_basenames.equal_range (cu_sp->GetFilename().GetCString());
+        for (KeyIndexMap::const_iterator pos = range.first; pos != range.second; ++pos)
+        {
+            const SourceFileKey &key = m_source_files[pos->second];
+            const bool full_match = (bool)key.file_spec.GetDirectory();
+            if (FileSpec::Equal (key.file_spec, *cu_sp, full_match))
+                candidate_keys.insert (pos->second);
+        }
+
+        // Getting the support files parses the line table header, so only
+        // do it when it can make a difference.
+        if (candidate_keys.empty() && !m_have_inline_source_files)
+            continue;
+        const FileSpecList &support_files = cu_sp->GetSupportFiles();
+        if (m_have_inline_source_files)
+        {
+            const size_t num_support_files = support_files.GetSize();
+            for (size_t file_idx = 1; file_idx < num_support_files; ++file_idx)
+            {
+                const FileSpec &support_file = support_files.GetFileSpecAtIndex (file_idx);
+                range = m_source_file_basenames.equal_range (support_file.GetFilename().GetCString());
+                for (KeyIndexMap::const_iterator pos = range.first; pos != range.second; ++pos)
+                {
+                    if (m_source_files[pos->second].check_inlines)
+                        candidate_keys.insert (pos->second);
+                }
+            }
+        }
+
+        for (std::set<size_t>::const_iterator pos = candidate_keys.begin(); pos != candidate_keys.end(); ++pos)
+        {
+            if (key_found[*pos])
+                continue;
+            const SourceFileKey &key = m_source_files[*pos];
+            if (support_files.FindFileIndex (1, key.file_spec, true) != UINT32_MAX)
+            {
+                key_found[*pos] = true;
+                AddModuleToBreakpoints (key.breakpoints, module_sp, bp_modules);
+            }
+        }
+    }
+}
+
+void
+BreakpointResolutionIndex::FindModulesToSearch (ModuleList &module_list,
+                                                BreakpointModulesMap &bp_modules)
+{
+    if (m_indexed_breakpoints.empty())
+        return;
+
+    Mutex::Locker modules_locker (module_list.GetMutex());
+    const size_t num_modules = module_list.GetSize();
+    std::set<Module *> new_modules;
+    for (size_t i = 0; i < num_modules; ++i)
+    {
+        ModuleSP module_sp (module_list.GetModuleAtIndexUnlocked (i));
+        if (!module_sp)
+            continue;
+        new_modules.insert (module_sp.get());
+        if (!m_function_names.empty())
+            FindFunctionNamesInModule (module_sp, bp_modules);
+        if (!m_source_files.empty())
+            FindSourceFilesInModule (module_sp, bp_modules);
+    }
+
+    // Breakpoints that already have locations in a module (because it was
+    // loaded before, e.g. in a previous run) still need to set their
+    // breakpoint sites there.
+    for (size_t bp_idx = 0; bp_idx < m_indexed_breakpoints.size(); ++bp_idx)
+    {
+        Breakpoint *bp = m_indexed_breakpoints[bp_idx].get();
+        const size_t num_locations = bp->GetNumLocations();
+        for (size_t loc_idx = 0; loc_idx < num_locations; ++loc_idx)
+        {
+            BreakpointLocationSP loc_sp (bp->GetLocationAtIndex (loc_idx));
+            if (!loc_sp)
+                continue;
+            SectionSP section_sp (loc_sp->GetAddress().GetSection());
+            if (!section_sp)
+                continue;
+            ModuleSP module_sp (section_sp->GetModule());
+            if (module_sp && new_modules.find (module_sp.get()) != new_modules.end())
+                bp_modules[bp].AppendIfNeeded (module_sp);
+        }
+    }
+}
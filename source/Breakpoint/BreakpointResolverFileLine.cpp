@@ -14,6 +14,7 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointResolutionIndex.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/StreamString.h"
@@ -98,6 +99,14 @@ BreakpointResolverFileLine::GetDepth()
     return Searcher::eDepthModule;
 }
 
+bool
+BreakpointResolverFileLine::AddToResolutionIndex (BreakpointResolutionIndex &index)
+{
+    // The line only matters once we know the module has the file.
+    index.AddSourceFile (m_breakpoint, m_file_spec, m_inlines);
+    return true;
+}
+
 void
 BreakpointResolverFileLine::GetDescription (Stream *s)
 {
@@ -14,6 +14,7 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointResolutionIndex.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/StreamString.h"
@@ -343,6 +344,17 @@ BreakpointResolverName::GetDepth()
     return Searcher::eDepthModule;
 }
 
+bool
+BreakpointResolverName::AddToResolutionIndex (BreakpointResolutionIndex &index)
+{
+    // Only exact names can be looked up in the module name indexes.
+    if (m_match_type != Breakpoint::Exact)
+        return false;
+    for (const LookupInfo &lookup : m_lookups)
+        index.AddFunctionName (m_breakpoint, lookup.lookup_name, lookup.name_type_mask);
+    return true;
+}
+
 void
 BreakpointResolverName::GetDescription (Stream *s)
 {
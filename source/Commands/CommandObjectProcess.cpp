@@ -13,6 +13,9 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/Breakpoint.h"
@@ -20,13 +23,19 @@
 #include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -1829,6 +1838,463 @@ CommandObjectProcessHandle::CommandOptions::g_option_table[] =
 { 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectProcessSample
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessSample
+
+enum SampleOutputFormat
+{
+    eSampleOutputFormatCollapsed,
+    eSampleOutputFormatPProf
+};
+
+static OptionEnumValueElement
+g_sample_output_format[] =
+{
+{ eSampleOutputFormatCollapsed, "collapsed", "One line per unique stack: frames from the outermost in, separated by ';', followed by the sample count."},
+{ eSampleOutputFormatPProf,     "pprof",     "A legacy pprof binary CPU profile, written to the file given with --outfile."},
+{ 0, NULL, NULL }
+};
+
+class CommandObjectProcessSample : public CommandObjectParsed
+{
+public:
+
+    class CommandOptions : public Options
+    {
+    public:
+
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter)
+        {
+            OptionParsingStarting ();
+        }
+
+        ~CommandOptions ()
+        {
+        }
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+            bool success = false;
+            switch (short_option)
+            {
+                case 'c':
+                    m_count = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                    if (!success || m_count == 0)
+                        error.SetErrorStringWithFormat ("invalid sample count: \"%s\"", option_arg);
+                    break;
+
+                case 'i':
+                    m_interval_ms = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                    if (!success)
+                        error.SetErrorStringWithFormat ("invalid sample interval: \"%s\"", option_arg);
+                    break;
+
+                case 'd':
+                    m_max_depth = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                    if (!success || m_max_depth == 0)
+                        error.SetErrorStringWithFormat ("invalid maximum stack depth: \"%s\"", option_arg);
+                    break;
+
+                case 'f':
+                    {
+                        OptionEnumValueElement *enum_values = g_option_table[option_idx].enum_values;
+                        m_format = (SampleOutputFormat) Args::StringToOptionEnum (option_arg, enum_values, eSampleOutputFormatCollapsed, error);
+                    }
+                    break;
+
+                case 'o':
+                    m_outfile.assign (option_arg);
+                    break;
+
+                default:
+                    error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
+                    break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            m_count = 100;
+            m_interval_ms = 10;
+            m_max_depth = 256;
+            m_format = eSampleOutputFormatCollapsed;
+            m_outfile.clear();
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+
+        uint32_t m_count;
+        uint32_t m_interval_ms;
+        uint32_t m_max_depth;
+        SampleOutputFormat m_format;
+        std::string m_outfile;
+    };
+
+    CommandObjectProcessSample (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process sample",
+                             "Profile the current process by repeatedly interrupting it and recording the call stack of every thread.",
+                             "process sample [<cmd-options>]",
+                             eFlagRequiresProcess       |
+                             eFlagTryTargetAPILock      |
+                             eFlagProcessMustBeLaunched |
+                             eFlagProcessMustBePaused   ),
+        m_options (interpreter)
+    {
+        SetHelpLong ("The process is resumed and interrupted once per sample interval. While it is stopped only the\n"
+                     "PC of each frame is recovered for each thread; symbols are looked up once for every unique\n"
+                     "address after sampling has finished. The process is left stopped when the command completes.\n");
+    }
+
+    ~CommandObjectProcessSample ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+protected:
+    typedef std::vector<lldb::addr_t> StackPCs;
+    typedef std::map<StackPCs, uint64_t> StackCountMap;
+    typedef std::map<lldb::addr_t, std::string> SymbolNameMap;
+
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+        Target *target = m_exe_ctx.GetTargetPtr();
+
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("The '%s' command does not take any arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        if (m_options.m_format == eSampleOutputFormatPProf && m_options.m_outfile.empty())
+        {
+            result.AppendError ("the pprof format is binary and requires an output file (--outfile)");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        StackCountMap stacks;
+        uint32_t num_samples = 0;
+        uint64_t num_thread_samples = 0;
+        uint64_t paused_nsec = 0;
+        uint64_t capture_nsec = 0;
+        std::string stop_reason;
+
+        // Keep the stop and resume events we cause to ourselves so they don't
+        // show up as process state changes for every sample.
+        ListenerSP listener_sp (new Listener ("lldb.CommandObjectProcessSample.DoExecute.hijack"));
+        process->HijackProcessEvents (listener_sp.get());
+
+        // A stop we didn't cause (a breakpoint, a signal, the process exiting)
+        // ends sampling, and is passed on once the events are restored.
+        EventSP natural_event_sp;
+
+        const TimeValue sample_start (TimeValue::Now());
+        TimeValue pause_start;
+        StackPCs pcs;
+        for (uint32_t sample_idx = 0; sample_idx < m_options.m_count; ++sample_idx)
+        {
+            ThreadList &thread_list = process->GetThreadList();
+            {
+                Mutex::Locker locker (thread_list.GetMutex());
+                const uint32_t num_threads = thread_list.GetSize();
+                for (uint32_t idx = 0; idx < num_threads; ++idx)
+                    thread_list.GetThreadAtIndex(idx)->SetResumeState (eStateRunning);
+            }
+
+            Error error (process->Resume());
+            if (pause_start.IsValid())
+                paused_nsec += TimeValue::Now() - pause_start;
+            if (error.Fail())
+            {
+                stop_reason = "failed to resume process: ";
+                stop_reason += error.AsCString();
+                break;
+            }
+
+            if (m_options.m_interval_ms > 0)
+                ::usleep (m_options.m_interval_ms * 1000);
+
+            pause_start = TimeValue::Now();
+            error = process->Halt ();
+            if (error.Fail())
+            {
+                stop_reason = "failed to halt process: ";
+                stop_reason += error.AsCString();
+                break;
+            }
+
+            EventSP event_sp;
+            TimeValue timeout (TimeValue::Now());
+            timeout.OffsetWithSeconds (5);
+            StateType state = process->WaitForProcessToStop (&timeout, &event_sp, true, listener_sp.get());
+            if (state != eStateStopped)
+            {
+                stop_reason = "process ";
+                stop_reason += StateAsCString (state);
+                natural_event_sp = event_sp;
+                break;
+            }
+            if (!Process::ProcessEventData::GetInterruptedFromEvent (event_sp.get()))
+            {
+                // The process stopped for its own reasons (a breakpoint, a signal)
+                // before we interrupted it, so this is not a representative sample.
+                stop_reason = "process stopped before it was interrupted";
+                natural_event_sp = event_sp;
+                break;
+            }
+
+            const TimeValue capture_start (TimeValue::Now());
+            {
+                Mutex::Locker locker (thread_list.GetMutex());
+                const uint32_t num_threads = thread_list.GetSize();
+                for (uint32_t idx = 0; idx < num_threads; ++idx)
+                {
+                    ThreadSP thread_sp (thread_list.GetThreadAtIndex(idx));
+                    if (thread_sp && thread_sp->GetStackPCs (pcs, m_options.m_max_depth) > 0)
+                    {
+                        ++stacks[pcs];
+                        ++num_thread_samples;
+                    }
+                }
+            }
+            capture_nsec += TimeValue::Now() - capture_start;
+            ++num_samples;
+        }
+        if (pause_start.IsValid())
+            paused_nsec += TimeValue::Now() - pause_start;
+        const uint64_t wall_nsec = TimeValue::Now() - sample_start;
+
+        process->RestoreProcessEvents ();
+        if (natural_event_sp)
+            process->BroadcastEvent (natural_event_sp);
+        result.SetDidChangeProcessState (true);
+
+        // Symbolicate every unique address once, now that the process is no
+        // longer being sampled.
+        const TimeValue symbolicate_start (TimeValue::Now());
+        SymbolNameMap names;
+        if (m_options.m_format == eSampleOutputFormatCollapsed)
+            SymbolicateStacks (*target, stacks, names);
+        const uint64_t symbolicate_nsec = TimeValue::Now() - symbolicate_start;
+
+        Stream &strm = result.GetOutputStream();
+        bool success = true;
+        if (m_options.m_format == eSampleOutputFormatPProf)
+        {
+            StreamFile outfile_stream;
+            uint32_t open_options = File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate;
+            Error error (outfile_stream.GetFile().Open (m_options.m_outfile.c_str(), open_options));
+            if (error.Success())
+            {
+                DumpPProfProfile (*target, stacks, outfile_stream);
+                strm.Printf ("Wrote pprof profile to '%s'\n", m_options.m_outfile.c_str());
+            }
+            else
+            {
+                result.AppendErrorWithFormat ("Failed to open file '%s' for writing: %s\n", m_options.m_outfile.c_str(), error.AsCString());
+                success = false;
+            }
+        }
+        else if (!m_options.m_outfile.empty())
+        {
+            StreamFile outfile_stream;
+            uint32_t open_options = File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate;
+            Error error (outfile_stream.GetFile().Open (m_options.m_outfile.c_str(), open_options));
+            if (error.Success())
+            {
+                DumpCollapsedStacks (stacks, names, outfile_stream);
+                strm.Printf ("Wrote collapsed stacks to '%s'\n", m_options.m_outfile.c_str());
+            }
+            else
+            {
+                result.AppendErrorWithFormat ("Failed to open file '%s' for writing: %s\n", m_options.m_outfile.c_str(), error.AsCString());
+                success = false;
+            }
+        }
+        else
+        {
+            DumpCollapsedStacks (stacks, names, strm);
+        }
+
+        if (!stop_reason.empty())
+            strm.Printf ("Sampling stopped early: %s\n", stop_reason.c_str());
+
+        strm.Printf ("%u samples, %" PRIu64 " thread stacks, %" PRIu64 " unique stacks in %.3f sec\n",
+                     num_samples,
+                     num_thread_samples,
+                     (uint64_t)stacks.size(),
+                     (double)wall_nsec / TimeValue::NanoSecPerSec);
+        if (num_samples > 0)
+        {
+            strm.Printf ("overhead: process paused %.1f%% of the time, %.3f ms per sample (%.3f ms capturing stacks), %.3f ms symbolicating %" PRIu64 " addresses\n",
+                         wall_nsec ? 100.0 * paused_nsec / wall_nsec : 0.0,
+                         (double)paused_nsec / num_samples / 1000000.0,
+                         (double)capture_nsec / num_samples / 1000000.0,
+                         (double)symbolicate_nsec / 1000000.0,
+                         (uint64_t)names.size());
+        }
+
+        result.SetStatus (success ? eReturnStatusSuccessFinishResult : eReturnStatusFailed);
+        return result.Succeeded();
+    }
+
+    static void
+    SymbolicateStacks (Target &target, const StackCountMap &stacks, SymbolNameMap &names)
+    {
+        SectionLoadList &section_load_list = target.GetSectionLoadList();
+        for (StackCountMap::const_iterator pos = stacks.begin(), end = stacks.end(); pos != end; ++pos)
+        {
+            const StackPCs &stack = pos->first;
+            for (size_t i = 0; i < stack.size(); ++i)
+            {
+                // Frames above the first are return addresses, which may point
+                // just past the end of the calling function, so look up the
+                // call instruction instead.
+                const lldb::addr_t lookup_pc = i > 0 ? stack[i] - 1 : stack[i];
+                if (names.find (lookup_pc) != names.end())
+                    continue;
+
+                StreamString name;
+                Address so_addr;
+                SymbolContext sc;
+                if (section_load_list.ResolveLoadAddress (lookup_pc, so_addr) &&
+                    so_addr.CalculateSymbolContext (&sc, eSymbolContextModule | eSymbolContextFunction | eSymbolContextSymbol))
+                {
+                    ConstString func_name (sc.GetFunctionName());
+                    if (sc.module_sp)
+                        name.Printf ("%s`", sc.module_sp->GetFileSpec().GetFilename().AsCString("<unknown>"));
+                    if (func_name)
+                        name.PutCString (func_name.GetCString());
+                    else
+                        name.Printf ("0x%" PRIx64, stack[i]);
+                }
+                else
+                {
+                    name.Printf ("0x%" PRIx64, stack[i]);
+                }
+                names[lookup_pc] = name.GetString();
+            }
+        }
+    }
+
+    static void
+    DumpCollapsedStacks (const StackCountMap &stacks, const SymbolNameMap &names, Stream &strm)
+    {
+        for (StackCountMap::const_iterator pos = stacks.begin(), end = stacks.end(); pos != end; ++pos)
+        {
+            const StackPCs &stack = pos->first;
+            for (size_t i = stack.size(); i > 0; --i)
+            {
+                const lldb::addr_t lookup_pc = i > 1 ? stack[i-1] - 1 : stack[i-1];
+                SymbolNameMap::const_iterator name_pos = names.find (lookup_pc);
+                if (i != stack.size())
+                    strm.PutChar (';');
+                if (name_pos != names.end())
+                    strm.PutCString (name_pos->second.c_str());
+                else
+                    strm.Printf ("0x%" PRIx64, stack[i-1]);
+            }
+            strm.Printf (" %" PRIu64 "\n", pos->second);
+        }
+    }
+
+    //------------------------------------------------------------------
+    // Write the legacy pprof CPU profile format: a header, one record per
+    // unique stack, a trailer, and then the load map of the process in
+    // /proc/<pid>/maps format so pprof can do its own symbolication.
+    //------------------------------------------------------------------
+    void
+    DumpPProfProfile (Target &target, const StackCountMap &stacks, StreamFile &strm)
+    {
+        std::vector<uint64_t> words;
+        // Header: header count, header words, version, sampling period, padding.
+        words.push_back (0);
+        words.push_back (3);
+        words.push_back (0);
+        words.push_back ((uint64_t)m_options.m_interval_ms * 1000);
+        words.push_back (0);
+        for (StackCountMap::const_iterator pos = stacks.begin(), end = stacks.end(); pos != end; ++pos)
+        {
+            words.push_back (pos->second);
+            words.push_back (pos->first.size());
+            words.insert (words.end(), pos->first.begin(), pos->first.end());
+        }
+        // Trailer
+        words.push_back (0);
+        words.push_back (1);
+        words.push_back (0);
+        strm.Write (&words[0], words.size() * sizeof(uint64_t));
+
+        ModuleList &images = target.GetImages();
+        Mutex::Locker locker (images.GetMutex());
+        const size_t num_modules = images.GetSize();
+        for (size_t i = 0; i < num_modules; ++i)
+        {
+            ModuleSP module_sp (images.GetModuleAtIndexUnlocked (i));
+            SectionList *section_list = module_sp ? module_sp->GetSectionList() : NULL;
+            if (section_list == NULL)
+                continue;
+            char path[PATH_MAX];
+            module_sp->GetFileSpec().GetPath (path, sizeof(path));
+            const size_t num_sections = section_list->GetSize();
+            for (size_t sect_idx = 0; sect_idx < num_sections; ++sect_idx)
+            {
+                SectionSP section_sp (section_list->GetSectionAtIndex (sect_idx));
+                if (!section_sp || section_sp->GetByteSize() == 0)
+                    continue;
+                const lldb::addr_t load_addr = section_sp->GetLoadBaseAddress (&target);
+                if (load_addr == LLDB_INVALID_ADDRESS)
+                    continue;
+                strm.Printf ("%" PRIx64 "-%" PRIx64 " r-xp %" PRIx64 " 00:00 0 %s\n",
+                             load_addr,
+                             load_addr + section_sp->GetByteSize(),
+                             section_sp->GetFileOffset(),
+                             path);
+            }
+        }
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectProcessSample::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_ALL, false, "count",     'c', OptionParser::eRequiredArgument, NULL,                   0, eArgTypeCount,           "The number of samples to take (default 100)."},
+{ LLDB_OPT_SET_ALL, false, "interval",  'i', OptionParser::eRequiredArgument, NULL,                   0, eArgTypeUnsignedInteger, "The number of milliseconds to let the process run between samples (default 10)."},
+{ LLDB_OPT_SET_ALL, false, "depth",     'd', OptionParser::eRequiredArgument, NULL,                   0, eArgTypeCount,           "The maximum number of frames to record for each thread (default 256)."},
+{ LLDB_OPT_SET_ALL, false, "format",    'f', OptionParser::eRequiredArgument, g_sample_output_format, 0, eArgTypeFormat,          "The output format for the collected stacks."},
+{ LLDB_OPT_SET_ALL, false, "outfile",   'o', OptionParser::eRequiredArgument, NULL,                   0, eArgTypeFilename,        "Write the collected stacks to this file instead of the command output."},
+{ 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectMultiwordProcess
 //-------------------------------------------------------------------------
@@ -1852,6 +2318,7 @@ CommandObjectMultiwordProcess::CommandObjectMultiwordProcess (CommandInterpreter
     LoadSubCommand ("interrupt",   CommandObjectSP (new CommandObjectProcessInterrupt (interpreter)));
     LoadSubCommand ("kill",        CommandObjectSP (new CommandObjectProcessKill      (interpreter)));
     LoadSubCommand ("plugin",      CommandObjectSP (new CommandObjectProcessPlugin    (interpreter)));
+    LoadSubCommand ("sample",      CommandObjectSP (new CommandObjectProcessSample    (interpreter)));
 }
 
 CommandObjectMultiwordProcess::~CommandObjectMultiwordProcess ()
@@ -101,6 +101,14 @@ public:
                         error.SetErrorStringWithFormat("invalid boolean value for option '%c'", short_option);
                 }
                 break;
+                case 'p':
+                {
+                    bool success;
+                    m_num_unwind_workers = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                    if (!success)
+                        error.SetErrorStringWithFormat("invalid integer value for option '%c'", short_option);
+                }
+                break;
                 default:
                     error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
                     break;
@@ -115,6 +123,7 @@ public:
             m_count = UINT32_MAX;
             m_start = 0;
             m_extended_backtrace = false;
+            m_num_unwind_workers = UINT32_MAX;
         }
 
         const OptionDefinition*
@@ -131,6 +140,7 @@ public:
         uint32_t m_count;
         uint32_t m_start;
         bool     m_extended_backtrace;
+        uint32_t m_num_unwind_workers;  // UINT32_MAX means unwind each thread as it is displayed
     };
 
     CommandObjectThreadBacktrace (CommandInterpreter &interpreter) :
@@ -223,6 +233,15 @@ protected:
         else if (command.GetArgumentCount() == 1 && ::strcmp (command.GetArgumentAtIndex(0), "all") == 0)
         {
             Process *process = m_exe_ctx.GetProcessPtr();
+            if (m_options.m_num_unwind_workers != UINT32_MAX)
+            {
+                // Compute all the frames we'll display up front, concurrently
+                uint32_t max_frames = UINT32_MAX;
+                if (m_options.m_count != UINT32_MAX && m_options.m_start < UINT32_MAX - m_options.m_count)
+                    max_frames = m_options.m_start + m_options.m_count;
+                process->GetThreadList().ComputeStackFrames (max_frames, m_options.m_num_unwind_workers);
+            }
+
             uint32_t idx = 0;
             for (ThreadSP thread_sp : process->Threads())
             {
@@ -308,6 +327,7 @@ CommandObjectThreadBacktrace::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_1, false, "count", 'c', OptionParser::eRequiredArgument, NULL, 0, eArgTypeCount, "How many frames to display (-1 for all)"},
 { LLDB_OPT_SET_1, false, "start", 's', OptionParser::eRequiredArgument, NULL, 0, eArgTypeFrameIndex, "Frame in which to start the backtrace"},
 { LLDB_OPT_SET_1, false, "extended", 'e', OptionParser::eRequiredArgument, NULL, 0, eArgTypeBoolean, "Show the extended backtrace, if available"},
+{ LLDB_OPT_SET_1, false, "parallel", 'p', OptionParser::eRequiredArgument, NULL, 0, eArgTypeCount, "When showing all threads, unwind them concurrently with this many worker threads (0 for one per CPU)."},
 { 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
 };
 
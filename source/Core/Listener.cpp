@@ -30,7 +30,12 @@ Listener::Listener(const char *name) :
     m_broadcasters_mutex (Mutex::eMutexTypeRecursive),
     m_events (),
     m_events_mutex (Mutex::eMutexTypeRecursive),
-    m_cond_wait()
+    m_pending_events (NULL),
+    m_num_waiters (0),
+    m_waiters (),
+    m_waiters_mutex (Mutex::eMutexTypeNormal),
+    m_wakeup_generation (0),
+    m_wakeup (0)
 {
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
     if (log)
@@ -60,9 +65,8 @@ Listener::Clear()
     for (pos = m_broadcasters.begin(); pos != end; ++pos)
         pos->first->RemoveListener (this, pos->second.event_mask);
     m_broadcasters.clear();
-    m_cond_wait.SetValue (false, eBroadcastNever);
-    m_broadcasters.clear();
     Mutex::Locker event_locker(m_events_mutex);
+    MovePendingEvents ();
     m_events.clear();
 }
 
@@ -154,6 +158,7 @@ Listener::BroadcasterWillDestruct (Broadcaster *broadcaster)
     // Scope for "event_locker"
     {
         Mutex::Locker event_locker(m_events_mutex);
+        MovePendingEvents ();
         // Remove all events for this broadcaster object.
         event_collection::iterator pos = m_events.begin();
         while (pos != m_events.end())
@@ -163,10 +168,6 @@ Listener::BroadcasterWillDestruct (Broadcaster *broadcaster)
             else
                 ++pos;
         }
-
-        if (m_events.empty())
-            m_cond_wait.SetValue (false, eBroadcastNever);
-
     }
 }
 
@@ -187,12 +188,35 @@ Listener::AddEvent (EventSP &event_sp)
     if (log)
         log->Printf ("%p Listener('%s')::AddEvent (event_sp = {%p})", this, m_name.c_str(), event_sp.get());
 
-    // Scope for "locker"
+    PendingEvent *pending = new PendingEvent;
+    pending->event_sp = event_sp;
+    pending->next = m_pending_events.load (std::memory_order_relaxed);
+    while (!m_pending_events.compare_exchange_weak (pending->next, pending))
+        ;
+
+    // A thread that is about to wait counts itself in m_num_waiters before
+    // it looks at the events one last time, so either it finds this event
+    // or we see it here.
+    if (m_num_waiters.load() > 0)
+        WakeWaiters (event_sp);
+}
+
+// Must be called with m_events_mutex locked.
+void
+Listener::MovePendingEvents ()
+{
+    PendingEvent *pending = m_pending_events.exchange (NULL);
+
+    // The pending events are in reverse order, so insert each one in front of
+    // the one added after it.
+    event_collection::iterator insert_pos = m_events.end();
+    while (pending)
     {
-        Mutex::Locker locker(m_events_mutex);
-        m_events.push_back (event_sp);
+        insert_pos = m_events.insert (insert_pos, pending->event_sp);
+        PendingEvent *next = pending->next;
+        delete pending;
+        pending = next;
     }
-    m_cond_wait.SetValue (true, eBroadcastAlways);
 }
 
 class EventBroadcasterMatches
@@ -260,6 +284,22 @@ private:
 };
 
 
+void
+Listener::WakeWaiters (const EventSP &event_sp)
+{
+    Mutex::Locker locker(m_waiters_mutex);
+    for (waiter_collection::const_iterator pos = m_waiters.begin(), end = m_waiters.end(); pos != end; ++pos)
+    {
+        EventMatcher matcher (pos->broadcaster, pos->broadcaster_names, pos->num_broadcaster_names, pos->event_type_mask);
+        if (matcher (event_sp))
+        {
+            // All the waiters wake up and look for their events again.
+            m_wakeup.SetValue (++m_wakeup_generation, eBroadcastAlways);
+            return;
+        }
+    }
+}
+
 bool
 Listener::FindNextEventInternal
 (
@@ -274,6 +314,8 @@ Listener::FindNextEventInternal
 
     Mutex::Locker lock(m_events_mutex);
 
+    MovePendingEvents ();
+
     if (m_events.empty())
         return false;
 
@@ -305,12 +347,7 @@ Listener::FindNextEventInternal
                          event_sp.get());
 
         if (remove)
-        {
             m_events.erase(pos);
-
-            if (m_events.empty())
-                m_cond_wait.SetValue (false, eBroadcastNever);
-        }
         
         // Unlock the event queue here.  We've removed this event and are about to return
         // it so it should be okay to get the next event off the queue here - and it might
@@ -401,7 +438,6 @@ Listener::WaitForEventsInternal
 )
 {
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS));
-    bool timed_out = false;
 
     if (log)
     {
@@ -416,24 +452,35 @@ Listener::WaitForEventsInternal
         if (GetNextEventInternal (broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask, event_sp))
                 return true;
 
+        // Tell the broadcasters what we are waiting for, and then look one
+        // last time for an event that was added before they could know.
+        uint32_t generation;
+        waiter_collection::iterator waiter_pos;
         {
-            // Reset condition value to false, so we can wait for new events to be
-            // added that might meet our current filter
-            // But first poll for any new event that might satisfy our condition, and if so consume it,
-            // otherwise wait.
-            
-            Mutex::Locker event_locker(m_events_mutex);
-            const bool remove = false;
-            if (FindNextEventInternal (broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask, event_sp, remove))
-                continue;
-            else
-                m_cond_wait.SetValue (false, eBroadcastNever);
+            Mutex::Locker waiters_locker(m_waiters_mutex);
+            waiter_pos = m_waiters.insert (m_waiters.end(),
+                                           WaiterInfo (broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask));
+            generation = m_wakeup_generation;
+            ++m_num_waiters;
         }
 
-        if (m_cond_wait.WaitForValueEqualTo (true, timeout, &timed_out))
-            continue;
+        const bool remove = false;
+        bool woken_up = FindNextEventInternal (broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask, event_sp, remove);
+        if (!woken_up)
+        {
+            uint32_t new_generation;
+            woken_up = m_wakeup.WaitForValueNotEqualTo (generation, new_generation, timeout);
+        }
 
-        else if (timed_out)
+        {
+            Mutex::Locker waiters_locker(m_waiters_mutex);
+            m_waiters.erase (waiter_pos);
+            --m_num_waiters;
+        }
+
+        if (woken_up)
+            continue;
+        else if (timeout)
         {
             log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS);
             if (log)
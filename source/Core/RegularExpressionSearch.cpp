@@ -0,0 +1,376 @@
+//===-- RegularExpressionSearch.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/RegularExpressionSearch.h"
+
+// C Includes
+#include <ctype.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Arrays smaller than this are matched on the calling thread; starting
+// workers costs more than they save.
+static const size_t g_min_names_per_chunk = 8 * 1024;
+
+RegularExpressionSearch::RegularExpressionSearch (const RegularExpression &regex) :
+    m_regex (regex),
+    m_literal (),
+    m_literal_is_prefix (false)
+{
+    if (regex.IsValid())
+        ExtractRequiredLiteral (regex.GetText(), regex.GetCompileFlags(), m_literal, m_literal_is_prefix);
+}
+
+RegularExpressionSearch::~RegularExpressionSearch ()
+{
+}
+
+bool
+RegularExpressionSearch::Matches (const char *name) const
+{
+    return MatchesLiteral (name) && m_regex.Execute (name);
+}
+
+bool
+RegularExpressionSearch::MatchesLiteral (const char *name) const
+{
+    if (name == NULL)
+        return false;
+    if (!m_literal.empty())
+    {
+        if (m_literal_is_prefix)
+            return ::strncmp (name, m_literal.c_str(), m_literal.size()) == 0;
+        return ::strstr (name, m_literal.c_str()) != NULL;
+    }
+    return true;
+}
+
+namespace {
+
+// Shared state for the FindMatches() worker threads.  Each worker takes
+// the next chunk of names until there are none left, and keeps the
+// matches for each chunk separate so they can be merged in order.
+struct RegexSearchWorkQueue
+{
+    RegexSearchWorkQueue (const RegularExpressionSearch &search,
+                          RegularExpressionSearch::GetNameCallback callback,
+                          void *baton,
+                          size_t num_names,
+                          size_t chunk_size) :
+        search (search),
+        callback (callback),
+        baton (baton),
+        num_names (num_names),
+        chunk_size (chunk_size),
+        chunk_matches ((num_names + chunk_size - 1) / chunk_size),
+        next_chunk (0),
+        mutex ()
+    {
+    }
+
+    bool
+    GetNextChunk (size_t &chunk_idx)
+    {
+        Mutex::Locker locker (mutex);
+        if (next_chunk >= chunk_matches.size())
+            return false;
+        chunk_idx = next_chunk++;
+        return true;
+    }
+
+    const RegularExpressionSearch &search;
+    const RegularExpressionSearch::GetNameCallback callback;
+    void *baton;
+    const size_t num_names;
+    const size_t chunk_size;
+    std::vector< std::vector<uint32_t> > chunk_matches;
+    size_t next_chunk;
+    Mutex mutex;
+};
+
+}
+
+static void
+MatchNames (const RegularExpressionSearch &search,
+            const RegularExpression &regex,
+            RegularExpressionSearch::GetNameCallback callback,
+            void *baton,
+            size_t start_idx,
+            size_t end_idx,
+            std::vector<uint32_t> &match_indexes)
+{
+    for (size_t idx = start_idx; idx < end_idx; ++idx)
+    {
+        const char *name = callback (baton, idx);
+        if (search.MatchesLiteral (name) && regex.Execute (name))
+            match_indexes.push_back (idx);
+    }
+}
+
+static thread_result_t
+RegexSearchWorkerThread (thread_arg_t arg)
+{
+    RegexSearchWorkQueue *queue = (RegexSearchWorkQueue *)arg;
+    // glibc takes a lock inside regexec() for each compiled expression, so
+    // workers sharing one would take turns.  Compile a copy for this worker.
+    RegularExpression regex (queue->search.GetRegularExpression());
+    size_t chunk_idx;
+    while (queue->GetNextChunk (chunk_idx))
+    {
+        const size_t start_idx = chunk_idx * queue->chunk_size;
+        const size_t end_idx = std::min<size_t> (start_idx + queue->chunk_size, queue->num_names);
+        MatchNames (queue->search, regex, queue->callback, queue->baton, start_idx, end_idx, queue->chunk_matches[chunk_idx]);
+    }
+    return NULL;
+}
+
+size_t
+RegularExpressionSearch::FindMatches (GetNameCallback callback,
+                                      void *baton,
+                                      size_t num_names,
+                                      std::vector<uint32_t> &match_indexes) const
+{
+    const size_t start_size = match_indexes.size();
+    uint32_t num_workers = Host::GetNumberCPUS();
+    if (num_workers <= 1 || num_names < 2 * g_min_names_per_chunk)
+    {
+        MatchNames (*this, m_regex, callback, baton, 0, num_names, match_indexes);
+        return match_indexes.size() - start_size;
+    }
+
+    // Use a few chunks per worker so a worker that gets the names that
+    // are slow to match (or to demangle) doesn't hold everyone up.
+    size_t chunk_size = num_names / (num_workers * 4);
+    if (chunk_size < g_min_names_per_chunk)
+        chunk_size = g_min_names_per_chunk;
+    RegexSearchWorkQueue queue (*this, callback, baton, num_names, chunk_size);
+    if (num_workers > queue.chunk_matches.size())
+        num_workers = queue.chunk_matches.size();
+
+    std::vector<lldb::thread_t> workers;
+    for (uint32_t i = 1; i < num_workers; ++i)
+    {
+        lldb::thread_t worker = Host::ThreadCreate ("<lldb.core.regex-search-worker>", RegexSearchWorkerThread, &queue, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(worker))
+            workers.push_back (worker);
+    }
+
+    // This thread is one of the workers, which also makes sure we finish
+    // if no threads could be created.
+    RegexSearchWorkerThread (&queue);
+
+    for (lldb::thread_t worker : workers)
+        Host::ThreadJoin (worker, NULL, NULL);
+
+    for (const std::vector<uint32_t> &chunk_matches : queue.chunk_matches)
+        match_indexes.insert (match_indexes.end(), chunk_matches.begin(), chunk_matches.end());
+    return match_indexes.size() - start_size;
+}
+
+static void
+EndLiteralRun (std::string &run,
+               bool &run_is_prefix,
+               std::string &literal,
+               bool &is_prefix)
+{
+    // Prefer the longest run; a prefix is cheaper to check than a
+    // substring, so it wins ties.
+    if (!run.empty() && (run.size() > literal.size() || (run.size() == literal.size() && run_is_prefix && !is_prefix)))
+    {
+        literal = run;
+        is_prefix = run_is_prefix;
+    }
+    run.clear();
+    run_is_prefix = false;
+}
+
+bool
+RegularExpressionSearch::ExtractRequiredLiteral (const char *re,
+                                                 int compile_flags,
+                                                 std::string &literal,
+                                                 bool &is_prefix)
+{
+    literal.clear();
+    is_prefix = false;
+
+    // Only extended expressions are parsed here, and a case insensitive
+    // expression can't be prefiltered with a plain string compare.
+    if (re == NULL || (compile_flags & REG_EXTENDED) == 0 || (compile_flags & REG_ICASE) != 0)
+        return false;
+
+    // Walk the expression and collect runs of ordinary characters that
+    // are outside of any group.  A run ends at anything that isn't a
+    // literal character, and a character followed by a '*', '?' or '{'
+    // may not be there at all.  Anything we aren't sure about just ends
+    // the current run: that can only make the literal shorter.
+    std::string run;
+    bool run_is_prefix = false;
+    bool last_was_literal = false;
+    uint32_t depth = 0;
+    const char *p = re;
+    if (*p == '^')
+    {
+        run_is_prefix = true;
+        ++p;
+    }
+
+    while (*p)
+    {
+        const char ch = *p;
+        switch (ch)
+        {
+        case '|':
+            // An alternative at the top level means nothing is required.
+            if (depth == 0)
+            {
+                literal.clear();
+                is_prefix = false;
+                return false;
+            }
+            ++p;
+            last_was_literal = false;
+            break;
+
+        case '(':
+            EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+            ++depth;
+            ++p;
+            last_was_literal = false;
+            break;
+
+        case ')':
+            EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+            if (depth > 0)
+                --depth;
+            ++p;
+            last_was_literal = false;
+            break;
+
+        case '[':
+            EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+            ++p;
+            if (*p == '^')
+                ++p;
+            if (*p == ']')
+                ++p;
+            while (*p && *p != ']')
+            {
+                // Skip "[:class:]", "[.coll.]" and "[=equiv=]" as a whole
+                // since they contain a ']'.
+                if (p[0] == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+                {
+                    const char delim = p[1];
+                    p += 2;
+                    while (*p && !(p[0] == delim && p[1] == ']'))
+                        ++p;
+                    if (*p)
+                        p += 2;
+                }
+                else
+                    ++p;
+            }
+            if (*p == '\0')
+            {
+                literal.clear();
+                is_prefix = false;
+                return false;
+            }
+            ++p;
+            last_was_literal = false;
+            break;
+
+        case '*':
+        case '?':
+        case '{':
+            // The preceding character is optional.
+            if (last_was_literal && depth == 0 && !run.empty())
+                run.erase (run.size() - 1);
+            EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+            if (ch == '{')
+            {
+                while (*p && *p != '}')
+                    ++p;
+            }
+            if (*p)
+                ++p;
+            last_was_literal = false;
+            break;
+
+        case '+':
+            {
+                // The preceding character is required, but may repeat,
+                // unless another quantifier follows: "c+*" may match
+                // nothing at all.
+                const char *next = p + 1;
+                while (*next == '+')
+                    ++next;
+                if (last_was_literal && depth == 0 && !run.empty() && (*next == '*' || *next == '?' || *next == '{'))
+                    run.erase (run.size() - 1);
+                EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+                p = next;
+                last_was_literal = false;
+            }
+            break;
+
+        case '\\':
+            if (p[1] == '\0')
+            {
+                literal.clear();
+                is_prefix = false;
+                return false;
+            }
+            if (isalnum ((unsigned char)p[1]) || strchr ("<>`'", p[1]) != NULL)
+            {
+                // Back references, word boundaries and other special escapes.
+                EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+                last_was_literal = false;
+            }
+            else if (depth == 0)
+            {
+                run.push_back (p[1]);
+                last_was_literal = true;
+            }
+            else
+                last_was_literal = false;
+            p += 2;
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+            EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+            ++p;
+            last_was_literal = false;
+            break;
+
+        default:
+            if (depth == 0)
+            {
+                run.push_back (ch);
+                last_was_literal = true;
+            }
+            else
+                last_was_literal = false;
+            ++p;
+            break;
+        }
+    }
+    EndLiteralRun (run, run_is_prefix, literal, is_prefix);
+    return !literal.empty();
+}
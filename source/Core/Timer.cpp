@@ -16,6 +16,7 @@
 #include "lldb/Host/Mutex.h"
 #include "lldb/Host/Host.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 
 using namespace lldb_private;
@@ -27,6 +28,7 @@ uint32_t Timer::g_display_depth = 0;
 FILE * Timer::g_file = NULL;
 typedef std::vector<Timer *> TimerStack;
 typedef std::map<const char *, uint64_t> TimerCategoryMap;
+typedef std::map<const char *, std::vector<uint64_t> > SampleCategoryMap;
 static lldb::thread_key_t g_key;
 
 static Mutex &
@@ -44,6 +46,13 @@ GetCategoryMap()
 }
 
 
+static SampleCategoryMap &
+GetSampleCategoryMap()
+{
+    static SampleCategoryMap g_sample_category_map;
+    return g_sample_category_map;
+}
+
 static TimerStack *
 GetTimerStackForCurrentThread ()
 {
@@ -226,6 +235,16 @@ Timer::ResetCategoryTimes ()
     Mutex::Locker locker (GetCategoryMutex());
     TimerCategoryMap &category_map = GetCategoryMap();
     category_map.clear();
+    GetSampleCategoryMap().clear();
+}
+
+void
+Timer::RecordSample (const char *category, uint64_t value)
+{
+    if (!IsEnabled())
+        return;
+    Mutex::Locker locker (GetCategoryMutex());
+    GetSampleCategoryMap()[category].push_back (value);
 }
 
 void
@@ -247,4 +266,23 @@ Timer::DumpCategoryTimes (Stream *s)
         const double timer_nsec = sorted_iterators[i]->second;
         s->Printf("%.9f sec for %s\n", timer_nsec / 1000000000.0, sorted_iterators[i]->first);
     }
+
+    SampleCategoryMap &sample_category_map = GetSampleCategoryMap();
+    SampleCategoryMap::iterator sample_pos, sample_end = sample_category_map.end();
+    for (sample_pos = sample_category_map.begin(); sample_pos != sample_end; ++sample_pos)
+    {
+        std::vector<uint64_t> &samples = sample_pos->second;
+        if (samples.empty())
+            continue;
+        std::sort (samples.begin(), samples.end());
+        const size_t num_samples = samples.size();
+        s->Printf("%" PRIu64 " samples of %s: min = %" PRIu64 ", p50 = %" PRIu64 ", p90 = %" PRIu64 ", p99 = %" PRIu64 ", max = %" PRIu64 "\n",
+                  (uint64_t)num_samples,
+                  sample_pos->first,
+                  samples.front(),
+                  samples[num_samples * 50 / 100],
+                  samples[num_samples * 90 / 100],
+                  samples[num_samples * 99 / 100],
+                  samples.back());
+    }
 }
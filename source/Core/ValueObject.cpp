@@ -3737,7 +3737,9 @@ ValueObject::EvaluationPoint::SyncWithProcessState()
     const bool was_valid = m_mod_id.IsValid();
     if (was_valid)
     {
-        if (m_mod_id == current_mod_id)
+        // In non-stop mode the threads that keep running change memory
+        // without changing the stop ID, so read the value again every time.
+        if (m_mod_id == current_mod_id && !process->IsNonStopModeActive())
         {
             // Everything is already up to date in this object, no need to 
             // update the execution context scope.
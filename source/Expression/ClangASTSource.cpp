@@ -445,7 +445,9 @@ ClangASTSource::FindExternalLexicalDecls (const DeclContext *decl_context,
     
     if (!original_decl_context)
         return ELR_Failure;
-    
+
+    const bool lazy_completion = m_target->GetExpressionLazyTypeCompletion();
+
     for (TagDecl::decl_iterator iter = original_decl_context->decls_begin();
          iter != original_decl_context->decls_end();
          ++iter)
@@ -471,8 +473,18 @@ ClangASTSource::FindExternalLexicalDecls (const DeclContext *decl_context,
             if (FieldDecl *copied_field = dyn_cast<FieldDecl>(copied_decl))
             {
                 QualType copied_field_type = copied_field->getType();
-                
-                m_ast_importer->RequireCompleteType(copied_field_type);
+
+                // The field's type was imported as a forward declaration.
+                // If the expression lays out the record or looks inside
+                // the field, clang asks us to complete it then; otherwise
+                // it never needs the members.
+                if (lazy_completion)
+                {
+                    if (copied_field_type->isIncompleteType())
+                        ClangASTMetrics::RegisterDeferredCompletion();
+                }
+                else
+                    m_ast_importer->RequireCompleteType(copied_field_type);
             }
             
             decls.push_back(copied_decl);
@@ -28,6 +28,7 @@
 #include "lldb/Expression/ClangExpressionParser.h"
 #include "lldb/Expression/ClangFunction.h"
 #include "lldb/Expression/ClangUserExpression.h"
+#include "lldb/Expression/ClangUserExpressionCache.h"
 #include "lldb/Expression/ExpressionSourceCode.h"
 #include "lldb/Expression/IRExecutionUnit.h"
 #include "lldb/Expression/IRInterpreter.h"
@@ -51,6 +52,9 @@
 
 using namespace lldb_private;
 
+static uint64_t g_num_interpreted_executions = 0;
+static uint64_t g_num_jit_executions = 0;
+
 ClangUserExpression::ClangUserExpression (const char *expr,
                                           const char *expr_prefix,
                                           lldb::LanguageType language,
@@ -372,6 +376,39 @@ ClangUserExpression::MatchesContext (ExecutionContext &exe_ctx)
     return LockAndCheckContext(exe_ctx, target_sp, process_sp, frame_sp);
 }
 
+uint64_t
+ClangUserExpression::GetNumInterpretedExecutions ()
+{
+    return g_num_interpreted_executions;
+}
+
+uint64_t
+ClangUserExpression::GetNumJITExecutions ()
+{
+    return g_num_jit_executions;
+}
+
+bool
+ClangUserExpression::RebindToContext (ExecutionContext &exe_ctx)
+{
+    lldb::ProcessSP process_sp = exe_ctx.GetProcessSP();
+    
+    if (process_sp != m_process_wp.lock())
+        return false;
+    
+    if (m_jit_start_addr != LLDB_INVALID_ADDRESS && process_sp != m_jit_process_wp.lock())
+        return false;
+    
+    // A dematerializer is only around between materializing and
+    // dematerializing.
+    if (m_dematerializer_sp)
+        return false;
+    
+    InstallContext(exe_ctx);
+    
+    return true;
+}
+
 // This is a really nasty hack, meant to fix Objective-C expressions of the form
 // (int)[myArray count].  Right now, because the type information for count is
 // not available, [myArray count] returns id, which can't be directly cast to
@@ -807,13 +844,24 @@ ClangUserExpression::Execute (Stream &error_stream,
             function_stack_bottom = m_stack_frame_bottom;
             function_stack_top = m_stack_frame_top;
             
+            ++g_num_interpreted_executions;
+            
+            if (log)
+                log->Printf("-- [ClangUserExpression::Execute] Interpreting the expression (%" PRIu64 " interpreted, %" PRIu64 " JIT compiled) --",
+                            g_num_interpreted_executions,
+                            g_num_jit_executions);
+            
+            Target *target = exe_ctx.GetTargetPtr();
+            const uint64_t instruction_limit = target ? target->GetExpressionInterpreterInstructionLimit() : 4096;
+            
             IRInterpreter::Interpret (*module,
                                       *function,
                                       args,
                                       *m_execution_unit_ap.get(),
                                       interpreter_error,
                                       function_stack_bottom,
-                                      function_stack_top);
+                                      function_stack_top,
+                                      instruction_limit);
             
             if (!interpreter_error.Success())
             {
@@ -855,8 +903,15 @@ ClangUserExpression::Execute (Stream &error_stream,
             function_stack_bottom = function_stack_pointer - Host::GetPageSize();
             function_stack_top = function_stack_pointer;
             
+            ++g_num_jit_executions;
+            
             if (log)
+            {
+                log->Printf("-- [ClangUserExpression::Execute] Running the JIT compiled expression (%" PRIu64 " interpreted, %" PRIu64 " JIT compiled) --",
+                            g_num_interpreted_executions,
+                            g_num_jit_executions);
                 log->Printf("-- [ClangUserExpression::Execute] Execution of expression begins --");
+            }
             
             if (exe_ctx.GetProcessPtr())
                 exe_ctx.GetProcessPtr()->SetRunningUserExpression(true);
@@ -957,16 +1012,51 @@ ClangUserExpression::Evaluate (ExecutionContext &exe_ctx,
     if (process == NULL || !process->CanJIT())
         execution_policy = eExecutionPolicyNever;
     
-    ClangUserExpressionSP user_expression_sp (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
+    // Reuse the parsed expression if the same expression was evaluated
+    // in the same scope before.
+    Target *target = exe_ctx.GetTargetPtr();
+    ClangUserExpressionCache *expression_cache = NULL;
+    if (target && target->GetExpressionCacheSize() > 0)
+        expression_cache = &target->GetExpressionCache();
+    
+    ClangUserExpressionSP user_expression_sp;
+    
+    if (expression_cache)
+        user_expression_sp = expression_cache->FindExpression (exe_ctx, expr_cstr, expr_prefix, language, desired_type, execution_policy);
 
     StreamString error_stream;
-        
-    if (log)
-        log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
     
-    const bool keep_expression_in_memory = true;
+    bool parsed = true;
     
-    if (!user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory))
+    if (user_expression_sp)
+    {
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Reusing parsed expression %s (%" PRIu64 " hits, %" PRIu64 " misses) ==",
+                        expr_cstr,
+                        expression_cache->GetNumHits(),
+                        expression_cache->GetNumMisses());
+    }
+    else
+    {
+        user_expression_sp.reset (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
+        
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+        
+        const bool keep_expression_in_memory = true;
+        
+        // Expressions that declare persistent variables must be parsed
+        // every time, since running them again must not see the old
+        // declarations.
+        const size_t num_persistent_variables = target ? target->GetPersistentVariables().GetSize() : 0;
+        
+        parsed = user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory);
+        
+        if (parsed && expression_cache && target->GetPersistentVariables().GetSize() == num_persistent_variables)
+            expression_cache->AddExpression (exe_ctx, expr_cstr, expr_prefix, language, desired_type, execution_policy, user_expression_sp, target->GetExpressionCacheSize());
+    }
+    
+    if (!parsed)
     {
         if (error_stream.GetString().empty())
             error.SetErrorString ("expression failed to parse, unknown error");
@@ -1004,6 +1094,11 @@ ClangUserExpression::Evaluate (ExecutionContext &exe_ctx,
                 if (log)
                     log->Printf("== [ClangUserExpression::Evaluate] Execution completed abnormally ==");
                 
+                // Don't run it again from the cache, it may be left half
+                // way through execution.
+                if (expression_cache)
+                    expression_cache->RemoveExpression (user_expression_sp);
+                
                 if (error_stream.GetString().empty())
                     error.SetErrorString ("expression failed to execute, unknown error");
                 else
@@ -0,0 +1,169 @@
+//===-- ClangUserExpressionCache.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Expression/ClangUserExpressionCache.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Expression/ClangUserExpression.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/StackFrame.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+ClangUserExpressionCache::ClangUserExpressionCache () :
+    m_entries (),
+    m_mutex (Mutex::eMutexTypeRecursive),
+    m_num_hits (0),
+    m_num_misses (0)
+{
+}
+
+ClangUserExpressionCache::~ClangUserExpressionCache ()
+{
+}
+
+bool
+ClangUserExpressionCache::GetScope (ExecutionContext &exe_ctx, const void *&scope)
+{
+    // The parsed expression bakes in the variables that were visible
+    // where it was parsed, so it can only be reused in the same lexical
+    // block.  Without debug info fall back to the function symbol.
+    StackFrame *frame = exe_ctx.GetFramePtr();
+    if (frame == NULL)
+    {
+        scope = NULL;
+        return true;
+    }
+
+    const SymbolContext &sc = frame->GetSymbolContext (eSymbolContextFunction | eSymbolContextBlock | eSymbolContextSymbol);
+    if (sc.block)
+        scope = sc.block;
+    else if (sc.function)
+        scope = sc.function;
+    else if (sc.symbol)
+        scope = sc.symbol;
+    else
+        return false;
+    return true;
+}
+
+ClangUserExpressionCache::ClangUserExpressionSP
+ClangUserExpressionCache::FindExpression (ExecutionContext &exe_ctx,
+                                          const char *expr_text,
+                                          const char *expr_prefix,
+                                          lldb::LanguageType language,
+                                          ClangExpression::ResultType desired_type,
+                                          ExecutionPolicy execution_policy)
+{
+    ClangUserExpressionSP expr_sp;
+    const void *scope = NULL;
+    if (expr_text == NULL || !GetScope (exe_ctx, scope))
+        return expr_sp;
+    if (expr_prefix == NULL)
+        expr_prefix = "";
+
+    Mutex::Locker locker (m_mutex);
+    for (collection::iterator pos = m_entries.begin(), end = m_entries.end(); pos != end; ++pos)
+    {
+        if (pos->scope != scope ||
+            pos->language != language ||
+            pos->desired_type != desired_type ||
+            pos->execution_policy != execution_policy ||
+            pos->expr_text != expr_text ||
+            pos->expr_prefix != expr_prefix)
+            continue;
+
+        // Someone else holds the expression, e.g. we are being called
+        // while it runs.  It can't be executed twice at once.
+        if (!pos->expr_sp.unique())
+            break;
+
+        if (!pos->expr_sp->RebindToContext (exe_ctx))
+        {
+            // It was parsed for a process that is gone.
+            m_entries.erase (pos);
+            break;
+        }
+
+        expr_sp = pos->expr_sp;
+        m_entries.splice (m_entries.begin(), m_entries, pos);
+        ++m_num_hits;
+        return expr_sp;
+    }
+    ++m_num_misses;
+    return expr_sp;
+}
+
+void
+ClangUserExpressionCache::AddExpression (ExecutionContext &exe_ctx,
+                                         const char *expr_text,
+                                         const char *expr_prefix,
+                                         lldb::LanguageType language,
+                                         ClangExpression::ResultType desired_type,
+                                         ExecutionPolicy execution_policy,
+                                         const ClangUserExpressionSP &expr_sp,
+                                         size_t max_entries)
+{
+    const void *scope = NULL;
+    if (max_entries == 0 || expr_text == NULL || !expr_sp || !GetScope (exe_ctx, scope))
+        return;
+
+    Entry entry;
+    entry.expr_text = expr_text;
+    if (expr_prefix)
+        entry.expr_prefix = expr_prefix;
+    entry.language = language;
+    entry.desired_type = desired_type;
+    entry.execution_policy = execution_policy;
+    entry.scope = scope;
+    entry.expr_sp = expr_sp;
+
+    Mutex::Locker locker (m_mutex);
+    m_entries.push_front (entry);
+    while (m_entries.size() > max_entries)
+        m_entries.pop_back();
+}
+
+void
+ClangUserExpressionCache::RemoveExpression (const ClangUserExpressionSP &expr_sp)
+{
+    Mutex::Locker locker (m_mutex);
+    for (collection::iterator pos = m_entries.begin(), end = m_entries.end(); pos != end; ++pos)
+    {
+        if (pos->expr_sp == expr_sp)
+        {
+            m_entries.erase (pos);
+            return;
+        }
+    }
+}
+
+void
+ClangUserExpressionCache::Clear ()
+{
+    // Release the expressions (and with them their JIT allocations in the
+    // process) outside of the lock.
+    collection entries;
+    {
+        Mutex::Locker locker (m_mutex);
+        entries.swap (m_entries);
+    }
+}
+
+size_t
+ClangUserExpressionCache::GetSize ()
+{
+    Mutex::Locker locker (m_mutex);
+    return m_entries.size();
+}
@@ -0,0 +1,837 @@
+//===-- CompiledCondition.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Expression/CompiledCondition.h"
+
+// C Includes
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Core/ValueObject.h"
+#include "lldb/Symbol/ClangASTType.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Target/StackFrame.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+// A recursive descent parser for the condition subset of C that emits
+// CompiledCondition bytecode as it goes.  Operator precedence follows C.
+//----------------------------------------------------------------------
+class CompiledConditionParser
+{
+public:
+    CompiledConditionParser (CompiledCondition &condition, const char *expr) :
+        m_condition (condition),
+        m_pos (expr)
+    {
+    }
+
+    bool
+    Parse ()
+    {
+        if (!ParseLogicalOr())
+            return false;
+        SkipSpaces();
+        return *m_pos == '\0';
+    }
+
+private:
+    void
+    SkipSpaces ()
+    {
+        while (isspace(*m_pos))
+            ++m_pos;
+    }
+
+    // Consume \a op if it is next in the input.  Single character operators
+    // are not matched when they are the start of a longer operator, so "&"
+    // does not match the start of "&&" and "<" does not match "<=" or "<<".
+    bool
+    Accept (const char *op)
+    {
+        SkipSpaces();
+        const size_t len = strlen(op);
+        if (strncmp (m_pos, op, len) != 0)
+            return false;
+        const char next = m_pos[len];
+        if (len == 1)
+        {
+            switch (op[0])
+            {
+            case '&': if (next == '&' || next == '=') return false; break;
+            case '|': if (next == '|' || next == '=') return false; break;
+            case '<': if (next == '<' || next == '=') return false; break;
+            case '>': if (next == '>' || next == '=') return false; break;
+            case '!': if (next == '=') return false; break;
+            case '-': if (next == '-' || next == '=' || next == '>') return false; break;
+            case '+': if (next == '+' || next == '=') return false; break;
+            case '*': case '/': case '%': case '^': if (next == '=') return false; break;
+            default: break;
+            }
+        }
+        else if (len == 2 && (strcmp(op, "<<") == 0 || strcmp(op, ">>") == 0) && next == '=')
+            return false;
+        m_pos += len;
+        return true;
+    }
+
+    uint32_t
+    Emit (CompiledCondition::OpCode op, uint32_t operand = 0)
+    {
+        m_condition.m_code.push_back (CompiledCondition::Instruction (op, operand));
+        return m_condition.m_code.size() - 1;
+    }
+
+    void
+    PatchBranch (uint32_t branch_idx)
+    {
+        m_condition.m_code[branch_idx].operand = m_condition.m_code.size();
+    }
+
+    void
+    EmitConstant (const Scalar &value)
+    {
+        m_condition.m_constants.push_back (value);
+        Emit (CompiledCondition::eOpPushConstant, m_condition.m_constants.size() - 1);
+    }
+
+    void
+    EmitVariable (const std::string &path)
+    {
+        std::vector<std::string> &variables = m_condition.m_variables;
+        uint32_t var_idx;
+        for (var_idx = 0; var_idx < variables.size(); ++var_idx)
+        {
+            if (variables[var_idx] == path)
+                break;
+        }
+        if (var_idx == variables.size())
+            variables.push_back (path);
+        Emit (CompiledCondition::eOpPushVariable, var_idx);
+    }
+
+    // Short circuit evaluation of "a && b" and "a || b" leaves 0 or 1
+    // on the stack:
+    //
+    //      <a>; branch-if-zero F; <b>; branch-if-zero F; push 1; branch E; F: push 0; E:
+    bool
+    ParseLogicalOr ()
+    {
+        if (!ParseLogicalAnd())
+            return false;
+        if (!Accept("||"))
+            return true;
+        std::vector<uint32_t> true_branches;
+        true_branches.push_back (Emit (CompiledCondition::eOpBranchIfNotZero));
+        do
+        {
+            if (!ParseLogicalAnd())
+                return false;
+            true_branches.push_back (Emit (CompiledCondition::eOpBranchIfNotZero));
+        } while (Accept("||"));
+        EmitConstant (Scalar(0));
+        const uint32_t end_branch = Emit (CompiledCondition::eOpBranch);
+        for (size_t i = 0; i < true_branches.size(); ++i)
+            PatchBranch (true_branches[i]);
+        EmitConstant (Scalar(1));
+        PatchBranch (end_branch);
+        return true;
+    }
+
+    bool
+    ParseLogicalAnd ()
+    {
+        if (!ParseBitwiseOr())
+            return false;
+        if (!Accept("&&"))
+            return true;
+        std::vector<uint32_t> false_branches;
+        false_branches.push_back (Emit (CompiledCondition::eOpBranchIfZero));
+        do
+        {
+            if (!ParseBitwiseOr())
+                return false;
+            false_branches.push_back (Emit (CompiledCondition::eOpBranchIfZero));
+        } while (Accept("&&"));
+        EmitConstant (Scalar(1));
+        const uint32_t end_branch = Emit (CompiledCondition::eOpBranch);
+        for (size_t i = 0; i < false_branches.size(); ++i)
+            PatchBranch (false_branches[i]);
+        EmitConstant (Scalar(0));
+        PatchBranch (end_branch);
+        return true;
+    }
+
+    bool
+    ParseBitwiseOr ()
+    {
+        if (!ParseBitwiseXor())
+            return false;
+        while (Accept("|"))
+        {
+            if (!ParseBitwiseXor())
+                return false;
+            Emit (CompiledCondition::eOpBitwiseOr);
+        }
+        return true;
+    }
+
+    bool
+    ParseBitwiseXor ()
+    {
+        if (!ParseBitwiseAnd())
+            return false;
+        while (Accept("^"))
+        {
+            if (!ParseBitwiseAnd())
+                return false;
+            Emit (CompiledCondition::eOpBitwiseXor);
+        }
+        return true;
+    }
+
+    bool
+    ParseBitwiseAnd ()
+    {
+        if (!ParseEquality())
+            return false;
+        while (Accept("&"))
+        {
+            if (!ParseEquality())
+                return false;
+            Emit (CompiledCondition::eOpBitwiseAnd);
+        }
+        return true;
+    }
+
+    bool
+    ParseEquality ()
+    {
+        if (!ParseRelational())
+            return false;
+        while (true)
+        {
+            CompiledCondition::OpCode op;
+            if (Accept("=="))
+                op = CompiledCondition::eOpEqual;
+            else if (Accept("!="))
+                op = CompiledCondition::eOpNotEqual;
+            else
+                return true;
+            if (!ParseRelational())
+                return false;
+            Emit (op);
+        }
+    }
+
+    bool
+    ParseRelational ()
+    {
+        if (!ParseShift())
+            return false;
+        while (true)
+        {
+            CompiledCondition::OpCode op;
+            if (Accept("<="))
+                op = CompiledCondition::eOpLessThanOrEqual;
+            else if (Accept(">="))
+                op = CompiledCondition::eOpGreaterThanOrEqual;
+            else if (Accept("<"))
+                op = CompiledCondition::eOpLessThan;
+            else if (Accept(">"))
+                op = CompiledCondition::eOpGreaterThan;
+            else
+                return true;
+            if (!ParseShift())
+                return false;
+            Emit (op);
+        }
+    }
+
+    bool
+    ParseShift ()
+    {
+        if (!ParseAdditive())
+            return false;
+        while (true)
+        {
+            CompiledCondition::OpCode op;
+            if (Accept("<<"))
+                op = CompiledCondition::eOpShiftLeft;
+            else if (Accept(">>"))
+                op = CompiledCondition::eOpShiftRight;
+            else
+                return true;
+            if (!ParseAdditive())
+                return false;
+            Emit (op);
+        }
+    }
+
+    bool
+    ParseAdditive ()
+    {
+        if (!ParseMultiplicative())
+            return false;
+        while (true)
+        {
+            CompiledCondition::OpCode op;
+            if (Accept("+"))
+                op = CompiledCondition::eOpAdd;
+            else if (Accept("-"))
+                op = CompiledCondition::eOpSubtract;
+            else
+                return true;
+            if (!ParseMultiplicative())
+                return false;
+            Emit (op);
+        }
+    }
+
+    bool
+    ParseMultiplicative ()
+    {
+        if (!ParseUnary())
+            return false;
+        while (true)
+        {
+            CompiledCondition::OpCode op;
+            if (Accept("*"))
+                op = CompiledCondition::eOpMultiply;
+            else if (Accept("/"))
+                op = CompiledCondition::eOpDivide;
+            else if (Accept("%"))
+                op = CompiledCondition::eOpRemainder;
+            else
+                return true;
+            if (!ParseUnary())
+                return false;
+            Emit (op);
+        }
+    }
+
+    bool
+    ParseUnary ()
+    {
+        if (Accept("!"))
+        {
+            if (!ParseUnary())
+                return false;
+            Emit (CompiledCondition::eOpLogicalNot);
+            return true;
+        }
+        if (Accept("~"))
+        {
+            if (!ParseUnary())
+                return false;
+            Emit (CompiledCondition::eOpComplement);
+            return true;
+        }
+        if (Accept("-"))
+        {
+            if (!ParseUnary())
+                return false;
+            Emit (CompiledCondition::eOpNegate);
+            return true;
+        }
+        if (Accept("+"))
+            return ParseUnary();
+        // Dereferences and address-of are only supported directly on a
+        // variable path, where the frame can resolve them for us.
+        if (Accept("*"))
+            return ParseVariablePath ("*");
+        if (Accept("&"))
+            return ParseVariablePath ("&");
+        return ParsePrimary();
+    }
+
+    bool
+    ParsePrimary ()
+    {
+        SkipSpaces();
+        if (Accept("("))
+        {
+            if (!ParseLogicalOr())
+                return false;
+            return Accept(")");
+        }
+        if (isdigit(*m_pos) || (*m_pos == '.' && isdigit(m_pos[1])))
+            return ParseNumber();
+        if (*m_pos == '\'')
+            return ParseCharacter();
+        return ParseVariablePath ("");
+    }
+
+    bool
+    ParseNumber ()
+    {
+        const char *start = m_pos;
+        const bool is_hex = m_pos[0] == '0' && (m_pos[1] == 'x' || m_pos[1] == 'X');
+        const char *end = m_pos + (is_hex ? 2 : 0);
+        bool is_float = false;
+        while (isalnum(*end) || *end == '.')
+        {
+            if (!is_hex && (*end == '.' || *end == 'e' || *end == 'E'))
+            {
+                is_float = true;
+                if ((*end == 'e' || *end == 'E') && (end[1] == '-' || end[1] == '+'))
+                    ++end;
+            }
+            ++end;
+        }
+
+        if (is_float)
+        {
+            char *parse_end = NULL;
+            const double value = ::strtod (start, &parse_end);
+            if (parse_end == start)
+                return false;
+            if (*parse_end == 'f' || *parse_end == 'F')
+            {
+                ++parse_end;
+                if (parse_end != end)
+                    return false;
+                m_pos = end;
+                EmitConstant (Scalar((float)value));
+                return true;
+            }
+            if (parse_end != end)
+                return false;
+            m_pos = end;
+            EmitConstant (Scalar(value));
+            return true;
+        }
+
+        char *parse_end = NULL;
+        const unsigned long long value = ::strtoull (start, &parse_end, 0);
+        if (parse_end == start)
+            return false;
+        bool is_unsigned = false;
+        for (; parse_end < end; ++parse_end)
+        {
+            if (*parse_end == 'u' || *parse_end == 'U')
+                is_unsigned = true;
+            else if (*parse_end != 'l' && *parse_end != 'L')
+                return false;
+        }
+        m_pos = end;
+
+        // Pick the type of the literal the way C does for the common cases.
+        if (is_unsigned)
+        {
+            if (value <= UINT32_MAX)
+                EmitConstant (Scalar((unsigned int)value));
+            else
+                EmitConstant (Scalar(value));
+        }
+        else if (value <= INT32_MAX)
+            EmitConstant (Scalar((int)value));
+        else if (value <= INT64_MAX)
+            EmitConstant (Scalar((long long)value));
+        else
+            EmitConstant (Scalar(value));
+        return true;
+    }
+
+    bool
+    ParseCharacter ()
+    {
+        // Only plain and simple escaped characters: 'a', '\n', '\0', '\\'
+        const char *p = m_pos + 1;
+        int value;
+        if (*p == '\\')
+        {
+            ++p;
+            switch (*p)
+            {
+            case 'n':  value = '\n'; break;
+            case 't':  value = '\t'; break;
+            case 'r':  value = '\r'; break;
+            case '0':  value = '\0'; break;
+            case '\\': value = '\\'; break;
+            case '\'': value = '\''; break;
+            case '"':  value = '"'; break;
+            default:   return false;
+            }
+        }
+        else if (*p != '\0' && *p != '\'')
+            value = *p;
+        else
+            return false;
+        ++p;
+        if (*p != '\'')
+            return false;
+        m_pos = p + 1;
+        EmitConstant (Scalar(value));
+        return true;
+    }
+
+    static bool
+    IsIdentifierStart (char c)
+    {
+        return isalpha(c) || c == '_' || c == '$';
+    }
+
+    bool
+    ParseIdentifier (std::string &path)
+    {
+        SkipSpaces();
+        if (!IsIdentifierStart(*m_pos))
+            return false;
+        const char *start = m_pos;
+        while (IsIdentifierStart(*m_pos) || isdigit(*m_pos))
+            ++m_pos;
+        path.append (start, m_pos - start);
+        return true;
+    }
+
+    // A variable expression path: an identifier followed by any number of
+    // ".member", "->member" or "[constant]" components.
+    bool
+    ParseVariablePath (const char *prefix)
+    {
+        std::string path (prefix);
+        const size_t identifier_start = path.size();
+        if (!ParseIdentifier (path))
+            return false;
+
+        if (*prefix == '\0')
+        {
+            const std::string identifier (path, identifier_start);
+            if (identifier == "true")
+            {
+                EmitConstant (Scalar(1));
+                return true;
+            }
+            if (identifier == "false" || identifier == "nullptr" || identifier == "NULL")
+            {
+                EmitConstant (Scalar(0));
+                return true;
+            }
+            if (identifier == "sizeof")
+                return false;
+        }
+
+        while (true)
+        {
+            if (Accept("."))
+            {
+                path.push_back ('.');
+                if (!ParseIdentifier (path))
+                    return false;
+            }
+            else if (Accept("->"))
+            {
+                path.append ("->");
+                if (!ParseIdentifier (path))
+                    return false;
+            }
+            else if (Accept("["))
+            {
+                SkipSpaces();
+                char *index_end = NULL;
+                const unsigned long long index = ::strtoull (m_pos, &index_end, 0);
+                if (index_end == m_pos)
+                    return false;
+                m_pos = index_end;
+                if (!Accept("]"))
+                    return false;
+                char index_str[32];
+                ::snprintf (index_str, sizeof(index_str), "[%llu]", index);
+                path.append (index_str);
+            }
+            else
+                break;
+        }
+        EmitVariable (path);
+        return true;
+    }
+
+    CompiledCondition &m_condition;
+    const char *m_pos;
+};
+
+} // namespace lldb_private
+
+CompiledCondition::CompiledCondition () :
+    m_code (),
+    m_constants (),
+    m_variables (),
+    m_variable_values (),
+    m_variable_read (),
+    m_stack ()
+{
+}
+
+CompiledCondition::~CompiledCondition ()
+{
+}
+
+void
+CompiledCondition::Clear ()
+{
+    m_code.clear();
+    m_constants.clear();
+    m_variables.clear();
+}
+
+bool
+CompiledCondition::Compile (const char *expr)
+{
+    Clear();
+    if (expr == NULL || expr[0] == '\0')
+        return false;
+
+    CompiledConditionParser parser (*this, expr);
+    if (!parser.Parse())
+    {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+CompiledCondition::ReadVariable (StackFrame &frame, uint32_t var_idx, Scalar &value, bool &is_pointer, Error &error)
+{
+    if (m_variable_read[var_idx])
+    {
+        value = m_variable_values[var_idx];
+        is_pointer = m_variable_is_pointer[var_idx];
+        return true;
+    }
+
+    const uint32_t options = StackFrame::eExpressionPathOptionCheckPtrVsMember |
+                             StackFrame::eExpressionPathOptionsNoSyntheticChildren;
+    VariableSP var_sp;
+    ValueObjectSP valobj_sp (frame.GetValueForVariableExpressionPath (m_variables[var_idx].c_str(),
+                                                                     eNoDynamicValues,
+                                                                     options,
+                                                                     var_sp,
+                                                                     error));
+    if (!valobj_sp || error.Fail())
+    {
+        if (error.Success())
+            error.SetErrorStringWithFormat ("unable to find '%s'", m_variables[var_idx].c_str());
+        return false;
+    }
+
+    // References and aggregates are left to the expression parser.
+    const uint32_t type_info = valobj_sp->GetClangType().GetTypeInfo();
+    if ((type_info & (ClangASTType::eTypeIsScalar | ClangASTType::eTypeIsPointer | ClangASTType::eTypeIsEnumeration)) == 0)
+    {
+        error.SetErrorStringWithFormat ("'%s' is not a scalar value", m_variables[var_idx].c_str());
+        return false;
+    }
+
+    if (!valobj_sp->ResolveValue (value))
+    {
+        error.SetErrorStringWithFormat ("unable to read the value of '%s'", m_variables[var_idx].c_str());
+        return false;
+    }
+
+    is_pointer = (type_info & ClangASTType::eTypeIsPointer) != 0;
+    m_variable_values[var_idx] = value;
+    m_variable_read[var_idx] = true;
+    m_variable_is_pointer[var_idx] = is_pointer;
+    return true;
+}
+
+bool
+CompiledCondition::Evaluate (StackFrame &frame, Scalar &result, Error &error)
+{
+    if (m_code.empty())
+    {
+        error.SetErrorString ("no compiled condition");
+        return false;
+    }
+
+    m_variable_values.resize (m_variables.size());
+    m_variable_read.assign (m_variables.size(), false);
+    m_variable_is_pointer.assign (m_variables.size(), false);
+    m_stack.clear();
+    m_stack_is_pointer.clear();
+
+    const uint32_t code_size = m_code.size();
+    uint32_t pc = 0;
+    while (pc < code_size)
+    {
+        const Instruction &inst = m_code[pc++];
+        switch (inst.op)
+        {
+        case eOpPushConstant:
+            m_stack.push_back (m_constants[inst.operand]);
+            m_stack_is_pointer.push_back (false);
+            continue;
+
+        case eOpPushVariable:
+            {
+                Scalar value;
+                bool is_pointer = false;
+                if (!ReadVariable (frame, inst.operand, value, is_pointer, error))
+                    return false;
+                m_stack.push_back (value);
+                m_stack_is_pointer.push_back (is_pointer);
+            }
+            continue;
+
+        case eOpBranch:
+            pc = inst.operand;
+            continue;
+
+        case eOpBranchIfZero:
+        case eOpBranchIfNotZero:
+            {
+                const bool is_zero = m_stack.back().IsZero();
+                m_stack.pop_back();
+                m_stack_is_pointer.pop_back();
+                if (is_zero == (inst.op == eOpBranchIfZero))
+                    pc = inst.operand;
+            }
+            continue;
+
+        case eOpLogicalNot:
+            m_stack.back() = Scalar(m_stack.back().IsZero() ? 1 : 0);
+            m_stack_is_pointer.back() = false;
+            continue;
+
+        case eOpNegate:
+            if (m_stack_is_pointer.back() || !m_stack.back().UnaryNegate())
+            {
+                error.SetErrorString ("invalid operand to unary '-'");
+                return false;
+            }
+            continue;
+
+        case eOpComplement:
+            if (m_stack_is_pointer.back() || !m_stack.back().OnesComplement())
+            {
+                error.SetErrorString ("invalid operand to unary '~'");
+                return false;
+            }
+            continue;
+
+        default:
+            break;
+        }
+
+        // Everything else is a binary operator
+        const Scalar rhs (m_stack.back());
+        const bool rhs_is_pointer = m_stack_is_pointer.back();
+        m_stack.pop_back();
+        m_stack_is_pointer.pop_back();
+        Scalar &lhs = m_stack.back();
+
+        // Pointers may only be compared. Arithmetic on them has to scale by
+        // the pointee size (and subtracting two pointers divides by it), which
+        // needs the type information only the expression parser keeps around.
+        if (rhs_is_pointer || m_stack_is_pointer.back())
+        {
+            switch (inst.op)
+            {
+            case eOpLessThan:
+            case eOpLessThanOrEqual:
+            case eOpGreaterThan:
+            case eOpGreaterThanOrEqual:
+            case eOpEqual:
+            case eOpNotEqual:
+                break;
+            default:
+                error.SetErrorString ("arithmetic on pointers is left to the expression parser");
+                return false;
+            }
+        }
+        m_stack_is_pointer.back() = false;
+
+        switch (inst.op)
+        {
+        case eOpMultiply:           lhs = lhs * rhs; break;
+        case eOpDivide:             lhs = lhs / rhs; break;
+        case eOpRemainder:          lhs = lhs % rhs; break;
+        case eOpAdd:                lhs = lhs + rhs; break;
+        case eOpSubtract:           lhs = lhs - rhs; break;
+        case eOpShiftLeft:          lhs = lhs << rhs; break;
+        case eOpShiftRight:         lhs = lhs >> rhs; break;
+        case eOpLessThan:           lhs = Scalar(lhs <  rhs ? 1 : 0); break;
+        case eOpLessThanOrEqual:    lhs = Scalar(lhs <= rhs ? 1 : 0); break;
+        case eOpGreaterThan:        lhs = Scalar(lhs >  rhs ? 1 : 0); break;
+        case eOpGreaterThanOrEqual: lhs = Scalar(lhs >= rhs ? 1 : 0); break;
+        case eOpEqual:              lhs = Scalar(lhs == rhs ? 1 : 0); break;
+        case eOpNotEqual:           lhs = Scalar(lhs != rhs ? 1 : 0); break;
+        case eOpBitwiseAnd:         lhs = lhs & rhs; break;
+        case eOpBitwiseXor:         lhs = lhs ^ rhs; break;
+        case eOpBitwiseOr:          lhs = lhs | rhs; break;
+        default:
+            error.SetErrorStringWithFormat ("invalid opcode %u", inst.op);
+            return false;
+        }
+
+        // Scalar produces an invalid value for things like division by
+        // zero or bitwise operations on floating point values.
+        if (!lhs.IsValid())
+        {
+            error.SetErrorString ("invalid operands in condition");
+            return false;
+        }
+    }
+
+    if (m_stack.size() != 1)
+    {
+        error.SetErrorString ("malformed condition");
+        return false;
+    }
+    result = m_stack.back();
+    return true;
+}
+
+void
+CompiledCondition::Dump (Stream &strm) const
+{
+    static const char *g_opcode_names[] =
+    {
+        "push-constant", "push-variable", "branch", "branch-if-zero", "branch-if-not-zero",
+        "not", "negate", "complement", "mul", "div", "rem", "add", "sub", "shl", "shr",
+        "lt", "le", "gt", "ge", "eq", "ne", "and", "xor", "or"
+    };
+
+    for (size_t i = 0; i < m_code.size(); ++i)
+    {
+        const Instruction &inst = m_code[i];
+        strm.Printf ("%4zu: %s", i, g_opcode_names[inst.op]);
+        switch (inst.op)
+        {
+        case eOpPushConstant:
+            strm.PutChar (' ');
+            m_constants[inst.operand].GetValue (&strm, false);
+            break;
+        case eOpPushVariable:
+            strm.Printf (" %s", m_variables[inst.operand].c_str());
+            break;
+        case eOpBranch:
+        case eOpBranchIfZero:
+        case eOpBranchIfNotZero:
+            strm.Printf (" %u", inst.operand);
+            break;
+        default:
+            break;
+        }
+        strm.EOL();
+    }
+}
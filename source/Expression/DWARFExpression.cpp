@@ -13,6 +13,7 @@
 #include <inttypes.h>
 
 // C++ Includes
+#include <algorithm>
 #include <vector>
 
 #include "lldb/Core/DataEncoder.h"
@@ -29,6 +30,7 @@
 
 #include "lldb/Host/Endian.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
 
 #include "lldb/lldb-private-log.h"
 
@@ -218,6 +220,130 @@ DW_OP_value_to_name (uint32_t val)
 }
 
 
+//----------------------------------------------------------------------
+// The decoded form of a single location expression.  The common
+// locations that are a single opcode are evaluated directly, anything
+// else is handed to the expression stack machine.
+//----------------------------------------------------------------------
+struct DWARFExpression::CompiledExpression
+{
+    enum Kind
+    {
+        eKindGeneric,           // Evaluate the opcodes
+        eKindFileAddress,       // DW_OP_addr <file_addr>
+        eKindFrameBaseOffset,   // DW_OP_fbreg <offset>
+        eKindRegisterOffset,    // DW_OP_bregN <offset>, DW_OP_bregx <reg_num> <offset>
+        eKindRegister           // DW_OP_regN, DW_OP_regx <reg_num>
+    };
+
+    CompiledExpression () :
+        kind (eKindGeneric),
+        reg_num (LLDB_INVALID_REGNUM),
+        offset (0),
+        file_addr (LLDB_INVALID_ADDRESS),
+        data_offset (0),
+        data_length (0)
+    {
+    }
+
+    void
+    Compile (const DataExtractor &data, lldb::offset_t expr_offset, lldb::offset_t expr_length)
+    {
+        kind = eKindGeneric;
+        data_offset = expr_offset;
+        data_length = expr_length;
+
+        if (expr_length == 0 || !data.ValidOffsetForDataOfSize (expr_offset, expr_length))
+            return;
+
+        const lldb::offset_t end_offset = expr_offset + expr_length;
+        lldb::offset_t op_offset = expr_offset;
+        const uint8_t op = data.GetU8 (&op_offset);
+        Kind op_kind = eKindGeneric;
+
+        if (op == DW_OP_addr)
+        {
+            file_addr = data.GetAddress (&op_offset);
+            op_kind = eKindFileAddress;
+        }
+        else if (op == DW_OP_fbreg)
+        {
+            offset = data.GetSLEB128 (&op_offset);
+            op_kind = eKindFrameBaseOffset;
+        }
+        else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+        {
+            reg_num = op - DW_OP_breg0;
+            offset = data.GetSLEB128 (&op_offset);
+            op_kind = eKindRegisterOffset;
+        }
+        else if (op == DW_OP_bregx)
+        {
+            reg_num = data.GetULEB128 (&op_offset);
+            offset = data.GetSLEB128 (&op_offset);
+            op_kind = eKindRegisterOffset;
+        }
+        else if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+        {
+            reg_num = op - DW_OP_reg0;
+            op_kind = eKindRegister;
+        }
+        else if (op == DW_OP_regx)
+        {
+            reg_num = data.GetULEB128 (&op_offset);
+            op_kind = eKindRegister;
+        }
+
+        // Only use the shortcut if the operation is the whole expression
+        // and its operands were all there.
+        if (op_offset == end_offset)
+            kind = op_kind;
+    }
+
+    Kind kind;
+    uint32_t reg_num;
+    int64_t offset;
+    lldb::addr_t file_addr;
+    lldb::offset_t data_offset;     // The opcodes, for eKindGeneric
+    lldb::offset_t data_length;
+};
+
+struct DWARFExpression::LocationListEntry
+{
+    // The addresses as they appear in the location list, before the
+    // base address and slide are applied.
+    lldb::addr_t lo_pc;
+    lldb::addr_t hi_pc;
+    CompiledExpression expr;
+
+    bool
+    operator < (const LocationListEntry &rhs) const
+    {
+        return lo_pc < rhs.lo_pc;
+    }
+};
+
+struct DWARFExpression::CompiledLocation
+{
+    CompiledLocation () :
+        expr (),
+        entries (),
+        entries_are_sorted (false)
+    {
+    }
+
+    CompiledExpression expr;                    // The expression, if this isn't a location list
+    std::vector<LocationListEntry> entries;     // The location list entries
+    bool entries_are_sorted;                    // True if the entries are sorted by address and don't overlap
+};
+
+static Mutex &
+GetCompiledLocationMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
 //----------------------------------------------------------------------
 // DWARFExpression constructor
 //----------------------------------------------------------------------
@@ -225,7 +351,8 @@ DWARFExpression::DWARFExpression() :
     m_module_wp(),
     m_data(),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide (LLDB_INVALID_ADDRESS)
+    m_loclist_slide (LLDB_INVALID_ADDRESS),
+    m_compiled_sp ()
 {
 }
 
@@ -233,7 +360,8 @@ DWARFExpression::DWARFExpression(const DWARFExpression& rhs) :
     m_module_wp(rhs.m_module_wp),
     m_data(rhs.m_data),
     m_reg_kind (rhs.m_reg_kind),
-    m_loclist_slide(rhs.m_loclist_slide)
+    m_loclist_slide(rhs.m_loclist_slide),
+    m_compiled_sp ()
 {
 }
 
@@ -242,12 +370,27 @@ DWARFExpression::DWARFExpression(lldb::ModuleSP module_sp, const DataExtractor&
     m_module_wp(),
     m_data(data, data_offset, data_length),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide(LLDB_INVALID_ADDRESS)
+    m_loclist_slide(LLDB_INVALID_ADDRESS),
+    m_compiled_sp ()
 {
     if (module_sp)
         m_module_wp = module_sp;
 }
 
+const DWARFExpression&
+DWARFExpression::operator= (const DWARFExpression& rhs)
+{
+    if (this != &rhs)
+    {
+        m_module_wp = rhs.m_module_wp;
+        m_data = rhs.m_data;
+        m_reg_kind = rhs.m_reg_kind;
+        m_loclist_slide = rhs.m_loclist_slide;
+        ClearCompiledLocation();
+    }
+    return *this;
+}
+
 //----------------------------------------------------------------------
 // Destructor
 //----------------------------------------------------------------------
@@ -266,6 +409,7 @@ void
 DWARFExpression::SetOpcodeData (const DataExtractor& data)
 {
     m_data = data;
+    ClearCompiledLocation();
 }
 
 void
@@ -278,6 +422,7 @@ DWARFExpression::CopyOpcodeData (lldb::ModuleSP module_sp, const DataExtractor&
         m_data.SetData(DataBufferSP(new DataBufferHeap(bytes, data_length)));
         m_data.SetByteOrder(data.GetByteOrder());
         m_data.SetAddressByteSize(data.GetAddressByteSize());
+        ClearCompiledLocation();
     }
 }
 
@@ -286,6 +431,7 @@ DWARFExpression::SetOpcodeData (lldb::ModuleSP module_sp, const DataExtractor& d
 {
     m_module_wp = module_sp;
     m_data.SetData(data, data_offset, data_length);
+    ClearCompiledLocation();
 }
 
 void
@@ -651,6 +797,7 @@ void
 DWARFExpression::SetLocationListSlide (addr_t slide)
 {
     m_loclist_slide = slide;
+    ClearCompiledLocation();
 }
 
 int
@@ -1094,6 +1241,7 @@ DWARFExpression::Update_DW_OP_addr (lldb::addr_t file_addr)
             // pointer to the heap data so "m_data" will now correctly 
             // manage the heap data.
             m_data.SetData (DataBufferSP (head_data_ap.release()));
+            ClearCompiledLocation();
             return true;
         }
         else
@@ -1107,6 +1255,97 @@ DWARFExpression::Update_DW_OP_addr (lldb::addr_t file_addr)
     return false;
 }
 
+DWARFExpression::CompiledLocationSP
+DWARFExpression::GetCompiledLocation () const
+{
+    Mutex::Locker locker (GetCompiledLocationMutex());
+
+    if (!m_compiled_sp)
+    {
+        std::unique_ptr<CompiledLocation> compiled_ap (new CompiledLocation());
+
+        if (IsLocationList())
+        {
+            std::vector<LocationListEntry> &entries = compiled_ap->entries;
+            lldb::offset_t offset = 0;
+            while (m_data.ValidOffset(offset))
+            {
+                LocationListEntry entry;
+                entry.lo_pc = m_data.GetAddress(&offset);
+                entry.hi_pc = m_data.GetAddress(&offset);
+                if (entry.lo_pc == 0 && entry.hi_pc == 0)
+                    break;
+
+                const uint16_t length = m_data.GetU16(&offset);
+                entry.expr.Compile (m_data, offset, length);
+                entries.push_back (entry);
+                offset += length;
+            }
+
+            // Compilers emit location lists in address order, but don't
+            // count on it.  If entries overlap, the first one in the list
+            // wins, so keep them in list order and search them in order.
+            std::vector<LocationListEntry> sorted_entries (entries);
+            std::stable_sort (sorted_entries.begin(), sorted_entries.end());
+            bool overlap = false;
+            for (size_t i = 1; i < sorted_entries.size() && !overlap; ++i)
+                overlap = sorted_entries[i].lo_pc < sorted_entries[i - 1].hi_pc;
+            if (!overlap)
+            {
+                entries.swap (sorted_entries);
+                compiled_ap->entries_are_sorted = true;
+            }
+        }
+        else
+        {
+            compiled_ap->expr.Compile (m_data, 0, m_data.GetByteSize());
+        }
+
+        m_compiled_sp.reset (compiled_ap.release());
+    }
+    return m_compiled_sp;
+}
+
+void
+DWARFExpression::ClearCompiledLocation ()
+{
+    Mutex::Locker locker (GetCompiledLocationMutex());
+    m_compiled_sp.reset();
+}
+
+const DWARFExpression::LocationListEntry *
+DWARFExpression::FindLocationListEntry (const CompiledLocation &compiled,
+                                        lldb::addr_t loclist_base_addr,
+                                        lldb::addr_t addr,
+                                        bool require_opcodes) const
+{
+    const std::vector<LocationListEntry> &entries = compiled.entries;
+
+    // Entries are relative to the object that owns the location list,
+    // so slide the address instead of every entry.
+    const addr_t list_addr = addr - (loclist_base_addr - m_loclist_slide);
+
+    if (compiled.entries_are_sorted)
+    {
+        LocationListEntry key;
+        key.lo_pc = list_addr;
+        std::vector<LocationListEntry>::const_iterator pos = std::upper_bound (entries.begin(), entries.end(), key);
+        if (pos == entries.begin())
+            return NULL;
+        --pos;
+        if (pos->lo_pc <= list_addr && list_addr < pos->hi_pc && (!require_opcodes || pos->expr.data_length > 0))
+            return &*pos;
+        return NULL;
+    }
+
+    for (std::vector<LocationListEntry>::const_iterator pos = entries.begin(), end = entries.end(); pos != end; ++pos)
+    {
+        if (pos->lo_pc <= list_addr && list_addr < pos->hi_pc && (!require_opcodes || pos->expr.data_length > 0))
+            return &*pos;
+    }
+    return NULL;
+}
+
 bool
 DWARFExpression::LocationListContainsAddress (lldb::addr_t loclist_base_addr, lldb::addr_t addr) const
 {
@@ -1115,29 +1354,11 @@ DWARFExpression::LocationListContainsAddress (lldb::addr_t loclist_base_addr, ll
 
     if (IsLocationList())
     {
-        lldb::offset_t offset = 0;
-
         if (loclist_base_addr == LLDB_INVALID_ADDRESS)
             return false;
 
-        while (m_data.ValidOffset(offset))
-        {
-            // We need to figure out what the value is for the location.
-            addr_t lo_pc = m_data.GetAddress(&offset);
-            addr_t hi_pc = m_data.GetAddress(&offset);
-            if (lo_pc == 0 && hi_pc == 0)
-                break;
-            else
-            {
-                lo_pc += loclist_base_addr - m_loclist_slide;
-                hi_pc += loclist_base_addr - m_loclist_slide;
-
-                if (lo_pc <= addr && addr < hi_pc)
-                    return true;
-
-                offset += m_data.GetU16(&offset);
-            }
-        }
+        CompiledLocationSP compiled_sp (GetCompiledLocation());
+        return FindLocationListEntry (*compiled_sp, loclist_base_addr, addr, false) != NULL;
     }
     return false;
 }
@@ -1154,29 +1375,13 @@ DWARFExpression::GetLocation (addr_t base_addr, addr_t pc, lldb::offset_t &offse
 
     if (base_addr != LLDB_INVALID_ADDRESS && pc != LLDB_INVALID_ADDRESS)
     {
-        addr_t curr_base_addr = base_addr;
-
-        while (m_data.ValidOffset(offset))
+        CompiledLocationSP compiled_sp (GetCompiledLocation());
+        const LocationListEntry *entry = FindLocationListEntry (*compiled_sp, base_addr, pc, true);
+        if (entry)
         {
-            // We need to figure out what the value is for the location.
-            addr_t lo_pc = m_data.GetAddress(&offset);
-            addr_t hi_pc = m_data.GetAddress(&offset);
-            if (lo_pc == 0 && hi_pc == 0)
-            {
-                break;
-            }
-            else
-            {
-                lo_pc += curr_base_addr - m_loclist_slide;
-                hi_pc += curr_base_addr - m_loclist_slide;
-                
-                length = m_data.GetU16(&offset);
-                
-                if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                    return true;
-
-                offset += length;
-            }
+            offset = entry->expr.data_offset;
+            length = entry->expr.data_length;
+            return true;
         }
     }
     offset = LLDB_INVALID_OFFSET;
@@ -1184,6 +1389,17 @@ DWARFExpression::GetLocation (addr_t base_addr, addr_t pc, lldb::offset_t &offse
     return false;
 }
 
+bool
+DWARFExpression::GetExpressionDataAtAddress (addr_t loclist_base_addr, addr_t addr, DataExtractor &data)
+{
+    lldb::offset_t offset = 0;
+    lldb::offset_t length = 0;
+    if (!GetLocation (loclist_base_addr, addr, offset, length) || length == 0)
+        return false;
+    data = DataExtractor (m_data, offset, length);
+    return true;
+}
+
 bool
 DWARFExpression::DumpLocationForAddress (Stream *s,
                                          lldb::DescriptionLevel level,
@@ -1238,7 +1454,6 @@ DWARFExpression::Evaluate
 
     if (IsLocationList())
     {
-        lldb::offset_t offset = 0;
         addr_t pc;
         StackFrame *frame = NULL;
         if (reg_ctx)
@@ -1263,31 +1478,10 @@ DWARFExpression::Evaluate
                 return false;
             }
 
-            addr_t curr_loclist_base_load_addr = loclist_base_load_addr;
-
-            while (m_data.ValidOffset(offset))
-            {
-                // We need to figure out what the value is for the location.
-                addr_t lo_pc = m_data.GetAddress(&offset);
-                addr_t hi_pc = m_data.GetAddress(&offset);
-                if (lo_pc == 0 && hi_pc == 0)
-                {
-                    break;
-                }
-                else
-                {
-                    lo_pc += curr_loclist_base_load_addr - m_loclist_slide;
-                    hi_pc += curr_loclist_base_load_addr - m_loclist_slide;
-
-                    uint16_t length = m_data.GetU16(&offset);
-
-                    if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                    {
-                        return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, m_data, offset, length, m_reg_kind, initial_value_ptr, result, error_ptr);
-                    }
-                    offset += length;
-                }
-            }
+            CompiledLocationSP compiled_sp (GetCompiledLocation());
+            const LocationListEntry *entry = FindLocationListEntry (*compiled_sp, loclist_base_load_addr, pc, true);
+            if (entry)
+                return EvaluateCompiledExpression (entry->expr, exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, initial_value_ptr, result, error_ptr);
         }
         if (error_ptr)
             error_ptr->SetErrorString ("variable not available");
@@ -1295,7 +1489,93 @@ DWARFExpression::Evaluate
     }
 
     // Not a location list, just a single expression.
-    return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, m_data, 0, m_data.GetByteSize(), m_reg_kind, initial_value_ptr, result, error_ptr);
+    CompiledLocationSP compiled_sp (GetCompiledLocation());
+    return EvaluateCompiledExpression (compiled_sp->expr, exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, initial_value_ptr, result, error_ptr);
+}
+
+bool
+DWARFExpression::EvaluateCompiledExpression
+(
+    const CompiledExpression &compiled_expr,
+    ExecutionContext *exe_ctx,
+    ClangExpressionVariableList *expr_locals,
+    ClangExpressionDeclMap *decl_map,
+    RegisterContext *reg_ctx,
+    lldb::ModuleSP module_sp,
+    const Value* initial_value_ptr,
+    Value& result,
+    Error *error_ptr
+) const
+{
+    // The verbose expression log traces the stack machine, so use it
+    // when logging.
+    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS));
+
+    if (compiled_expr.kind == CompiledExpression::eKindGeneric || (log && log->GetVerbose()))
+        return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, m_data, compiled_expr.data_offset, compiled_expr.data_length, m_reg_kind, initial_value_ptr, result, error_ptr);
+
+    // These are all a single operation, so the result is what it pushes
+    // (even if there is an initial value under it).
+    StackFrame *frame = exe_ctx ? exe_ctx->GetFramePtr() : NULL;
+    if (reg_ctx == NULL && frame)
+        reg_ctx = frame->GetRegisterContext().get();
+
+    switch (compiled_expr.kind)
+    {
+    case CompiledExpression::eKindGeneric:
+        break;
+
+    case CompiledExpression::eKindFileAddress:
+        result = Value (Scalar (compiled_expr.file_addr));
+        result.SetValueType (Value::eValueTypeFileAddress);
+        return true;
+
+    case CompiledExpression::eKindFrameBaseOffset:
+        {
+            if (exe_ctx == NULL)
+            {
+                if (error_ptr)
+                    error_ptr->SetErrorStringWithFormat ("NULL execution context for DW_OP_fbreg.\n");
+                return false;
+            }
+            if (frame == NULL)
+            {
+                if (error_ptr)
+                    error_ptr->SetErrorString ("Invalid stack frame in context for DW_OP_fbreg opcode.");
+                return false;
+            }
+            Scalar value;
+            if (!frame->GetFrameBaseValue(value, error_ptr))
+                return false;
+            value += compiled_expr.offset;
+            result = Value (value);
+            result.SetValueType (Value::eValueTypeLoadAddress);
+        }
+        return true;
+
+    case CompiledExpression::eKindRegisterOffset:
+        {
+            Value tmp;
+            if (!ReadRegisterValueAsScalar (reg_ctx, m_reg_kind, compiled_expr.reg_num, error_ptr, tmp))
+                return false;
+            tmp.ResolveValue(exe_ctx) += (uint64_t)compiled_expr.offset;
+            tmp.ClearContext();
+            result = tmp;
+            result.SetValueType (Value::eValueTypeLoadAddress);
+        }
+        return true;
+
+    case CompiledExpression::eKindRegister:
+        {
+            Value tmp;
+            if (!ReadRegisterValueAsScalar (reg_ctx, m_reg_kind, compiled_expr.reg_num, error_ptr, tmp))
+                return false;
+            result = tmp;
+        }
+        return true;
+    }
+
+    return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, m_data, compiled_expr.data_offset, compiled_expr.data_length, m_reg_kind, initial_value_ptr, result, error_ptr);
 }
 
 
@@ -20,10 +20,13 @@
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <map>
+#include <math.h>
+#include <string.h>
 
 using namespace llvm;
 
@@ -58,6 +61,23 @@ PrintType(const Type *type, bool truncate = false)
     return s;
 }
 
+static int64_t
+SignExtendRawBits (uint64_t raw_bits, unsigned bit_width)
+{
+    if (bit_width == 0 || bit_width >= 64)
+        return (int64_t)raw_bits;
+    
+    const uint64_t sign_bit = 1ull << (bit_width - 1);
+    raw_bits &= (sign_bit << 1) - 1;
+    return (int64_t)((raw_bits ^ sign_bit) - sign_bit);
+}
+
+static bool
+IsSupportedFloatType (const Type *type)
+{
+    return type->isFloatTy() || type->isDoubleTy();
+}
+
 class InterpreterStackFrame
 {
 public:
@@ -67,6 +87,7 @@ public:
     DataLayout                             &m_target_data;
     lldb_private::IRMemoryMap              &m_memory_map;
     const BasicBlock                       *m_bb;
+    const BasicBlock                       *m_prev_bb;
     BasicBlock::const_iterator              m_ii;
     BasicBlock::const_iterator              m_ie;
     
@@ -82,7 +103,9 @@ public:
                            lldb::addr_t stack_frame_bottom,
                            lldb::addr_t stack_frame_top) :
         m_target_data (target_data),
-        m_memory_map (memory_map)
+        m_memory_map (memory_map),
+        m_bb (NULL),
+        m_prev_bb (NULL)
     {
         m_byte_order = (target_data.isLittleEndian() ? lldb::eByteOrderLittle : lldb::eByteOrderBig);
         m_addr_byte_size = (target_data.getPointerSize(0));
@@ -98,6 +121,7 @@ public:
     
     void Jump (const BasicBlock *bb)
     {
+        m_prev_bb = m_bb;
         m_bb = bb;
         m_ii = m_bb->begin();
         m_ie = m_bb->end();
@@ -183,6 +207,59 @@ public:
         return false;
     }
     
+    bool EvaluateFloatValue (double &result, const Value *value, Module &module)
+    {
+        lldb_private::Scalar raw_scalar;
+        
+        if (!EvaluateValue(raw_scalar, value, module))
+            return false;
+        
+        const uint64_t raw_bits = raw_scalar.GetRawBits64(0);
+        Type *type = value->getType();
+        
+        if (type->isFloatTy())
+        {
+            const uint32_t raw_bits32 = (uint32_t)raw_bits;
+            float float_value;
+            ::memcpy (&float_value, &raw_bits32, sizeof(float_value));
+            result = float_value;
+            return true;
+        }
+        else if (type->isDoubleTy())
+        {
+            ::memcpy (&result, &raw_bits, sizeof(result));
+            return true;
+        }
+        
+        return false;
+    }
+    
+    bool AssignFloatValue (const Value *value, double float_value, Module &module)
+    {
+        lldb_private::Scalar raw_scalar;
+        Type *type = value->getType();
+        
+        if (type->isFloatTy())
+        {
+            const float single_value = (float)float_value;
+            uint32_t raw_bits;
+            ::memcpy (&raw_bits, &single_value, sizeof(raw_bits));
+            raw_scalar = raw_bits;
+        }
+        else if (type->isDoubleTy())
+        {
+            uint64_t raw_bits;
+            ::memcpy (&raw_bits, &float_value, sizeof(raw_bits));
+            raw_scalar = raw_bits;
+        }
+        else
+        {
+            return false;
+        }
+        
+        return AssignValue(value, raw_scalar, module);
+    }
+    
     bool AssignValue (const Value *value, lldb_private::Scalar &scalar, Module &module)
     {
         lldb::addr_t process_address = ResolveValue (value, module);
@@ -428,6 +505,36 @@ static const char *memory_read_error                = "Interpreter couldn't read
 static const char *infinite_loop_error              = "Interpreter ran for too many cycles";
 //static const char *bad_result_error                 = "Result of expression is in bad memory";
 
+// The largest memcpy(), memmove() or memset() the interpreter will do.
+static const uint64_t g_max_interpreted_memory_op_size = 1024 * 1024;
+
+static bool
+CanInterpretCall (const CallInst *call_inst)
+{
+    // Calls into the target need the target to run.  The only calls that
+    // can be interpreted are the memory intrinsics clang emits for
+    // aggregate copies and initialization, and intrinsics that don't
+    // do anything at run time.
+    const Function *callee = call_inst->getCalledFunction();
+    
+    if (!callee)
+        return false;
+    
+    switch (callee->getIntrinsicID())
+    {
+    default:
+        return false;
+    case Intrinsic::memcpy:
+    case Intrinsic::memmove:
+    case Intrinsic::memset:
+    case Intrinsic::dbg_declare:
+    case Intrinsic::dbg_value:
+    case Intrinsic::lifetime_start:
+    case Intrinsic::lifetime_end:
+        return true;
+    }
+}
+
 bool
 IRInterpreter::CanInterpret (llvm::Module &module,
                              llvm::Function &function,
@@ -473,6 +580,28 @@ IRInterpreter::CanInterpret (llvm::Module &module,
             case Instruction::Br:
             case Instruction::GetElementPtr:
                 break;
+            case Instruction::Call:
+                {
+                    CallInst *call_inst = dyn_cast<CallInst>(ii);
+                    
+                    if (!call_inst)
+                    {
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(interpreter_internal_error);
+                        return false;
+                    }
+                    
+                    if (!CanInterpretCall(call_inst))
+                    {
+                        if (log)
+                            log->Printf("Unsupported function call: %s", PrintValue(ii).c_str());
+                        
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(unsupported_opcode_error);
+                        return false;
+                    }
+                }
+                break;
             case Instruction::ICmp:
                 {
                     ICmpInst *icmp_inst = dyn_cast<ICmpInst>(ii);
@@ -511,27 +640,51 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                 break;
             case Instruction::And:
             case Instruction::AShr:
+            case Instruction::FAdd:
+            case Instruction::FCmp:
+            case Instruction::FDiv:
+            case Instruction::FMul:
+            case Instruction::FPExt:
+            case Instruction::FPToSI:
+            case Instruction::FPToUI:
+            case Instruction::FPTrunc:
+            case Instruction::FRem:
+            case Instruction::FSub:
             case Instruction::IntToPtr:
             case Instruction::PtrToInt:
             case Instruction::Load:
             case Instruction::LShr:
             case Instruction::Mul:
             case Instruction::Or:
+            case Instruction::PHI:
             case Instruction::Ret:
             case Instruction::SDiv:
+            case Instruction::Select:
             case Instruction::SExt:
             case Instruction::Shl:
+            case Instruction::SIToFP:
             case Instruction::SRem:
             case Instruction::Store:
             case Instruction::Sub:
             case Instruction::Trunc:
             case Instruction::UDiv:
+            case Instruction::UIToFP:
             case Instruction::URem:
             case Instruction::Xor:
             case Instruction::ZExt:
                 break;
             }
             
+            // Floating point values are computed as doubles, which can't
+            // hold a long double.
+            if (ii->getType()->isFloatingPointTy() && !IsSupportedFloatType(ii->getType()))
+            {
+                if (log)
+                    log->Printf("Unsupported result type: %s", PrintType(ii->getType()).c_str());
+                error.SetErrorString(unsupported_operand_error);
+                return false;
+            }
+            
             for (int oi = 0, oe = ii->getNumOperands();
                  oi != oe;
                  ++oi)
@@ -544,6 +697,10 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                 default:
                     break;
                 case Type::VectorTyID:
+                case Type::HalfTyID:
+                case Type::X86_FP80TyID:
+                case Type::FP128TyID:
+                case Type::PPC_FP128TyID:
                     {
                         if (log)
                             log->Printf("Unsupported operand type: %s", PrintType(operand_type).c_str());
@@ -565,7 +722,8 @@ IRInterpreter::Interpret (llvm::Module &module,
                           lldb_private::IRMemoryMap &memory_map,
                           lldb_private::Error &error,
                           lldb::addr_t stack_frame_bottom,
-                          lldb::addr_t stack_frame_top)
+                          lldb::addr_t stack_frame_top,
+                          uint64_t instruction_limit)
 {
     lldb_private::Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
     
@@ -607,11 +765,11 @@ IRInterpreter::Interpret (llvm::Module &module,
         frame.MakeArgument(ai, ptr);
     }
     
-    uint32_t num_insts = 0;
+    uint64_t num_insts = 0;
     
     frame.Jump(function.begin());
     
-    while (frame.m_ii != frame.m_ie && (++num_insts < 4096))
+    while (frame.m_ii != frame.m_ie && (++num_insts < instruction_limit))
     {
         const Instruction *inst = frame.m_ii;
         
@@ -868,9 +1026,9 @@ IRInterpreter::Interpret (llvm::Module &module,
                     return false;
                 }
                 
-                S.MakeSigned();
-                
-                lldb_private::Scalar S_signextend(S.SLongLong());
+                // The source value was read as an unsigned number of
+                // its own width, so sign extend it from that width.
+                lldb_private::Scalar S_signextend((long long)SignExtendRawBits(S.GetRawBits64(0), source->getType()->getScalarSizeInBits()));
                 
                 frame.AssignValue(inst, S_signextend, module);
             }
@@ -1098,6 +1256,516 @@ IRInterpreter::Interpret (llvm::Module &module,
                 }
             }
                 break;
+            case Instruction::FAdd:
+            case Instruction::FSub:
+            case Instruction::FMul:
+            case Instruction::FDiv:
+            case Instruction::FRem:
+            {
+                Value *lhs = inst->getOperand(0);
+                Value *rhs = inst->getOperand(1);
+                
+                double L;
+                double R;
+                
+                if (!frame.EvaluateFloatValue(L, lhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                if (!frame.EvaluateFloatValue(R, rhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                // A float operation done in double precision and then
+                // rounded to float gives the same result as doing it in
+                // float.
+                double result = 0.0;
+                
+                switch (inst->getOpcode())
+                {
+                    default:
+                        break;
+                    case Instruction::FAdd:
+                        result = L + R;
+                        break;
+                    case Instruction::FSub:
+                        result = L - R;
+                        break;
+                    case Instruction::FMul:
+                        result = L * R;
+                        break;
+                    case Instruction::FDiv:
+                        result = L / R;
+                        break;
+                    case Instruction::FRem:
+                        result = fmod(L, R);
+                        break;
+                }
+                
+                if (!frame.AssignFloatValue(inst, result, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't assign the result of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(memory_write_error);
+                    return false;
+                }
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::FCmp:
+            {
+                const FCmpInst *fcmp_inst = dyn_cast<FCmpInst>(inst);
+                
+                if (!fcmp_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns FCmp, but instruction is not an FCmpInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+                
+                Value *lhs = inst->getOperand(0);
+                Value *rhs = inst->getOperand(1);
+                
+                double L;
+                double R;
+                
+                if (!frame.EvaluateFloatValue(L, lhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                if (!frame.EvaluateFloatValue(R, rhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                const bool unordered = isnan(L) || isnan(R);
+                bool compare_result = false;
+                
+                switch (fcmp_inst->getPredicate())
+                {
+                    default:
+                        if (log)
+                            log->Printf("Unsupported FCmp predicate: %s", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(unsupported_opcode_error);
+                        return false;
+                    case CmpInst::FCMP_FALSE:
+                        compare_result = false;
+                        break;
+                    case CmpInst::FCMP_OEQ:
+                        compare_result = !unordered && L == R;
+                        break;
+                    case CmpInst::FCMP_OGT:
+                        compare_result = !unordered && L > R;
+                        break;
+                    case CmpInst::FCMP_OGE:
+                        compare_result = !unordered && L >= R;
+                        break;
+                    case CmpInst::FCMP_OLT:
+                        compare_result = !unordered && L < R;
+                        break;
+                    case CmpInst::FCMP_OLE:
+                        compare_result = !unordered && L <= R;
+                        break;
+                    case CmpInst::FCMP_ONE:
+                        compare_result = !unordered && L != R;
+                        break;
+                    case CmpInst::FCMP_ORD:
+                        compare_result = !unordered;
+                        break;
+                    case CmpInst::FCMP_UNO:
+                        compare_result = unordered;
+                        break;
+                    case CmpInst::FCMP_UEQ:
+                        compare_result = unordered || L == R;
+                        break;
+                    case CmpInst::FCMP_UGT:
+                        compare_result = unordered || L > R;
+                        break;
+                    case CmpInst::FCMP_UGE:
+                        compare_result = unordered || L >= R;
+                        break;
+                    case CmpInst::FCMP_ULT:
+                        compare_result = unordered || L < R;
+                        break;
+                    case CmpInst::FCMP_ULE:
+                        compare_result = unordered || L <= R;
+                        break;
+                    case CmpInst::FCMP_UNE:
+                        compare_result = unordered || L != R;
+                        break;
+                    case CmpInst::FCMP_TRUE:
+                        compare_result = true;
+                        break;
+                }
+                
+                lldb_private::Scalar result(compare_result ? 1 : 0);
+                
+                frame.AssignValue(inst, result, module);
+                
+                if (log)
+                {
+                    log->Printf("Interpreted an FCmpInst");
+                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::SIToFP:
+            case Instruction::UIToFP:
+            {
+                Value *source = inst->getOperand(0);
+                
+                lldb_private::Scalar S;
+                
+                if (!frame.EvaluateValue(S, source, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                const uint64_t raw_bits = S.GetRawBits64(0);
+                const unsigned bit_width = source->getType()->getScalarSizeInBits();
+                double result;
+                
+                if (inst->getOpcode() == Instruction::SIToFP)
+                    result = (double)SignExtendRawBits(raw_bits, bit_width);
+                else if (bit_width < 64)
+                    result = (double)(raw_bits & ((1ull << bit_width) - 1));
+                else
+                    result = (double)raw_bits;
+                
+                if (!frame.AssignFloatValue(inst, result, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't assign the result of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(memory_write_error);
+                    return false;
+                }
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Src : %s", frame.SummarizeValue(source).c_str());
+                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::FPToSI:
+            case Instruction::FPToUI:
+            case Instruction::FPExt:
+            case Instruction::FPTrunc:
+            {
+                Value *source = inst->getOperand(0);
+                
+                double F;
+                
+                if (!frame.EvaluateFloatValue(F, source, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                bool assigned = false;
+                
+                switch (inst->getOpcode())
+                {
+                    default:
+                        break;
+                    case Instruction::FPToSI:
+                    {
+                        lldb_private::Scalar result((long long)F);
+                        assigned = frame.AssignValue(inst, result, module);
+                    }
+                        break;
+                    case Instruction::FPToUI:
+                    {
+                        lldb_private::Scalar result((unsigned long long)F);
+                        assigned = frame.AssignValue(inst, result, module);
+                    }
+                        break;
+                    case Instruction::FPExt:
+                    case Instruction::FPTrunc:
+                        assigned = frame.AssignFloatValue(inst, F, module);
+                        break;
+                }
+                
+                if (!assigned)
+                {
+                    if (log)
+                        log->Printf("Couldn't assign the result of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(memory_write_error);
+                    return false;
+                }
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Src : %s", frame.SummarizeValue(source).c_str());
+                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::Select:
+            {
+                const SelectInst *select_inst = dyn_cast<SelectInst>(inst);
+                
+                if (!select_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns Select, but instruction is not a SelectInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+                
+                Value *condition = select_inst->getCondition();
+                
+                lldb_private::Scalar C;
+                
+                if (!frame.EvaluateValue(C, condition, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(condition).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                Value *selected = C.GetRawBits64(0) ? select_inst->getTrueValue() : select_inst->getFalseValue();
+                
+                lldb_private::Scalar V;
+                
+                if (!frame.EvaluateValue(V, selected, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(selected).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                frame.AssignValue(inst, V, module);
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a SelectInst");
+                    log->Printf("  cond : %s", frame.SummarizeValue(condition).c_str());
+                    log->Printf("  =    : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::PHI:
+            {
+                // The PHI nodes at the top of a block all take their values
+                // at the same time, from the block we came from, so read
+                // every incoming value before assigning any of them.
+                if (!frame.m_prev_bb)
+                {
+                    if (log)
+                        log->Printf("Encountered a PHINode in the entry block");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+                
+                typedef SmallVector <std::pair <const PHINode *, lldb_private::Scalar>, 4> PHIValueList;
+                
+                PHIValueList phi_values;
+                BasicBlock::const_iterator last_phi = frame.m_ii;
+                
+                for (BasicBlock::const_iterator pi = frame.m_ii; pi != frame.m_ie; ++pi)
+                {
+                    const Instruction *phi_inst = pi;
+                    const PHINode *phi_node = dyn_cast<PHINode>(phi_inst);
+                    
+                    if (!phi_node)
+                        break;
+                    
+                    int incoming_index = phi_node->getBasicBlockIndex(frame.m_prev_bb);
+                    
+                    if (incoming_index < 0)
+                    {
+                        if (log)
+                            log->Printf("PHINode %s has no value for the block we came from", PrintValue(phi_node).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(interpreter_internal_error);
+                        return false;
+                    }
+                    
+                    Value *incoming_value = phi_node->getIncomingValue(incoming_index);
+                    
+                    lldb_private::Scalar V;
+                    
+                    if (!frame.EvaluateValue(V, incoming_value, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(incoming_value).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+                    
+                    phi_values.push_back(std::make_pair(phi_node, V));
+                    last_phi = pi;
+                }
+                
+                for (PHIValueList::iterator vi = phi_values.begin(), ve = phi_values.end();
+                     vi != ve;
+                     ++vi)
+                {
+                    frame.AssignValue(vi->first, vi->second, module);
+                    
+                    if (log)
+                    {
+                        log->Printf("Interpreted a PHINode");
+                        log->Printf("  = : %s", frame.SummarizeValue(vi->first).c_str());
+                    }
+                }
+                
+                // Continue after the last PHI node.
+                frame.m_ii = last_phi;
+            }
+                break;
+            case Instruction::Call:
+            {
+                const MemIntrinsic *mem_inst = dyn_cast<MemIntrinsic>(inst);
+                
+                // The other calls CanInterpret() allows don't do anything.
+                if (!mem_inst)
+                    break;
+                
+                lldb_private::Scalar D;
+                lldb_private::Scalar L;
+                
+                if (!frame.EvaluateValue(D, mem_inst->getRawDest(), module) ||
+                    !frame.EvaluateValue(L, mem_inst->getLength(), module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate the operands of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                const lldb::addr_t dest = D.ULongLong(LLDB_INVALID_ADDRESS);
+                const uint64_t length = L.ULongLong(0);
+                
+                if (length == 0)
+                    break;
+                
+                if (length > g_max_interpreted_memory_op_size)
+                {
+                    if (log)
+                        log->Printf("%s of %" PRIu64 " bytes is too large to interpret", inst->getOpcodeName(), length);
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(memory_allocation_error);
+                    return false;
+                }
+                
+                lldb_private::DataBufferHeap buffer(length, 0);
+                
+                if (const MemSetInst *memset_inst = dyn_cast<MemSetInst>(mem_inst))
+                {
+                    lldb_private::Scalar V;
+                    
+                    if (!frame.EvaluateValue(V, memset_inst->getValue(), module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(memset_inst->getValue()).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+                    
+                    ::memset (buffer.GetBytes(), (uint8_t)V.GetRawBits64(0), length);
+                }
+                else if (const MemTransferInst *transfer_inst = dyn_cast<MemTransferInst>(mem_inst))
+                {
+                    lldb_private::Scalar S;
+                    
+                    if (!frame.EvaluateValue(S, transfer_inst->getRawSource(), module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(transfer_inst->getRawSource()).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+                    
+                    // Reading the whole source before writing any of the
+                    // destination makes this a memmove as well.
+                    lldb_private::Error read_error;
+                    memory_map.ReadMemory(buffer.GetBytes(), S.ULongLong(LLDB_INVALID_ADDRESS), length, read_error);
+                    
+                    if (!read_error.Success())
+                    {
+                        if (log)
+                            log->Printf("Couldn't read from a region on behalf of %s", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(memory_read_error);
+                        return false;
+                    }
+                }
+                
+                lldb_private::Error write_error;
+                memory_map.WriteMemory(dest, buffer.GetBytes(), length, write_error);
+                
+                if (!write_error.Success())
+                {
+                    if (log)
+                        log->Printf("Couldn't write to a region on behalf of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(memory_write_error);
+                    return false;
+                }
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a memory intrinsic");
+                    log->Printf("  D : 0x%" PRIx64, dest);
+                    log->Printf("  L : %" PRIu64, length);
+                }
+            }
+                break;
             case Instruction::IntToPtr:
             {
                 const IntToPtrInst *int_to_ptr_inst = dyn_cast<IntToPtrInst>(inst);
@@ -1412,7 +2080,7 @@ IRInterpreter::Interpret (llvm::Module &module,
         ++frame.m_ii;
     }
     
-    if (num_insts >= 4096)
+    if (num_insts >= instruction_limit)
     {
         error.SetErrorToGenericError();
         error.SetErrorString(infinite_loop_error);
@@ -254,8 +254,11 @@ MonitorChildProcessThreadFunction (void *arg)
                     if (callback)
                         callback_return = callback (callback_baton, wait_pid, exited, signal, exit_status);
                     
-                    // If our process exited, then this thread should exit
-                    if (exited && wait_pid == abs(pid))
+                    // If our process exited, then this thread should exit.
+                    // Callers that monitor signals trace the whole process
+                    // group and decide themselves when they are done, since
+                    // they may have moved on to a child of the process.
+                    if (exited && wait_pid == abs(pid) && !monitor_signals)
                     {
                         if (log)
                             log->Printf ("%s (arg = %p) thread exiting because pid received exit signal...", __FUNCTION__, arg);
@@ -1037,6 +1037,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             static ConstString g_sect_name_dwarf_debug_ranges (".debug_ranges");
             static ConstString g_sect_name_dwarf_debug_str (".debug_str");
             static ConstString g_sect_name_eh_frame (".eh_frame");
+            static ConstString g_sect_name_eh_frame_hdr (".eh_frame_hdr");
 
             SectionType sect_type = eSectionTypeOther;
 
@@ -1081,6 +1082,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             else if (name == g_sect_name_dwarf_debug_ranges)    sect_type = eSectionTypeDWARFDebugRanges;
             else if (name == g_sect_name_dwarf_debug_str)       sect_type = eSectionTypeDWARFDebugStr;
             else if (name == g_sect_name_eh_frame)              sect_type = eSectionTypeEHFrame;
+            else if (name == g_sect_name_eh_frame_hdr)          sect_type = eSectionTypeEHFrameHdr;
 
             switch (header.sh_type)
             {
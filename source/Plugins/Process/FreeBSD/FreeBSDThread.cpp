@@ -45,6 +45,10 @@ FreeBSDThread::WillResume(lldb::StateType resume_state)
     ProcessSP process_sp(GetProcess());
     ProcessFreeBSD *process = static_cast<ProcessFreeBSD *>(process_sp.get());
     int signo = GetResumeSignal();
+
+    // The whole process is resumed after this, so the registers written
+    // while we were stopped have to reach the thread now.
+    FlushRegisters();
     bool signo_valid = process->GetUnixSignals().SignalIsValid(signo);
 
     switch (resume_state)
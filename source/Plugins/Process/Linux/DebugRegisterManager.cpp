@@ -0,0 +1,143 @@
+//===-- DebugRegisterManager.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-defines.h"
+
+#include "DebugRegisterManager.h"
+
+using namespace lldb;
+
+// dr7{7-0} holds the local/global enable bits of each debug address register
+// (dr0 -> bits{1-0}, ..., dr3 -> bits{7-6}), and dr7{31-16} holds four bits
+// of each: bits{x+1, x} are the type (0b00: execute, 0b01: write, 0b11: read
+// or write) and bits{x+3, x+2} are the length (0b00: 1 byte, 0b01: 2 bytes,
+// 0b11: 4 bytes, 0b10: 8 bytes), with dr0 -> bits{19-16}, ..., dr3 ->
+// bits{31-28}.  Only the local enable bit is used, like the kernel does.
+static uint64_t
+EnableBit(uint32_t slot)
+{
+    return 1ull << (2 * slot);
+}
+
+static uint64_t
+RWLenShift(uint32_t slot)
+{
+    return 16 + 4 * slot;
+}
+
+DebugRegisterManager::DebugRegisterManager()
+    : m_control(0),
+      m_generation(0)
+{
+    for (uint32_t slot = 0; slot < k_num_slots; ++slot)
+        m_addresses[slot] = 0;
+}
+
+DebugRegisterManager::~DebugRegisterManager()
+{
+}
+
+uint64_t
+DebugRegisterManager::GetSlotControlMask(uint32_t slot)
+{
+    return (3ull << (2 * slot)) | (0xfull << RWLenShift(slot));
+}
+
+uint32_t
+DebugRegisterManager::FindVacantSlot() const
+{
+    for (uint32_t slot = 0; slot < k_num_slots; ++slot)
+    {
+        if (IsSlotVacant(slot))
+            return slot;
+    }
+    return LLDB_INVALID_INDEX32;
+}
+
+bool
+DebugRegisterManager::IsSlotVacant(uint32_t slot) const
+{
+    return slot < k_num_slots && (m_control & EnableBit(slot)) == 0;
+}
+
+bool
+DebugRegisterManager::IsBreakpointSlot(uint32_t slot) const
+{
+    if (slot >= k_num_slots || IsSlotVacant(slot))
+        return false;
+    return ((m_control >> RWLenShift(slot)) & 0x3) == 0;
+}
+
+addr_t
+DebugRegisterManager::GetSlotAddress(uint32_t slot) const
+{
+    if (slot >= k_num_slots || IsSlotVacant(slot))
+        return LLDB_INVALID_ADDRESS;
+    return m_addresses[slot];
+}
+
+bool
+DebugRegisterManager::SetWatchpoint(uint32_t slot, addr_t addr, size_t size,
+                                    bool read, bool write)
+{
+    if (!read && !write)
+        return false;
+
+    uint64_t len;
+    switch (size)
+    {
+    case 1: len = 0x0; break;
+    case 2: len = 0x1; break;
+    case 4: len = 0x3; break;
+    case 8: len = 0x2; break;
+    default:
+        return false;
+    }
+
+    // The watched range has to be aligned to its size; the kernel refuses to
+    // set the register otherwise.
+    if (addr & (size - 1))
+        return false;
+
+    // There is no read-only type, so reads are watched together with writes.
+    const uint64_t rw = read ? 0x3 : 0x1;
+    return SetSlot(slot, addr, (len << 2) | rw);
+}
+
+bool
+DebugRegisterManager::SetBreakpoint(uint32_t slot, addr_t addr)
+{
+    // Execute breakpoints must have a length of one byte.
+    return SetSlot(slot, addr, 0x0);
+}
+
+void
+DebugRegisterManager::ClearSlot(uint32_t slot)
+{
+    if (slot >= k_num_slots || IsSlotVacant(slot))
+        return;
+    m_control &= ~GetSlotControlMask(slot);
+    ++m_generation;
+}
+
+bool
+DebugRegisterManager::SetSlot(uint32_t slot, addr_t addr, uint64_t rw_len_bits)
+{
+    if (!IsSlotVacant(slot))
+        return false;
+
+    m_addresses[slot] = addr;
+    m_control |= EnableBit(slot) | (rw_len_bits << RWLenShift(slot));
+    ++m_generation;
+    return true;
+}
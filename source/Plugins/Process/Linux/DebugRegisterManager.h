@@ -0,0 +1,109 @@
+//===-- DebugRegisterManager.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_DebugRegisterManager_H_
+#define liblldb_DebugRegisterManager_H_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-types.h"
+
+/// @class DebugRegisterManager
+/// @brief Keeps the x86 debug registers of all threads of a process in step.
+///
+/// Hardware watchpoints and breakpoints apply to the whole process, but the
+/// debug registers that implement them (dr0-dr3 for the addresses and dr7 for
+/// their types and lengths) belong to each thread, and Linux doesn't copy them
+/// to new threads.  Instead of writing the registers of every thread one at a
+/// time whenever a watchpoint or breakpoint changes, the manager holds the
+/// values that all threads should have along with a generation count that
+/// changes with them.  Each thread remembers the generation it was last
+/// brought up to date with, and the writes for the threads that are behind
+/// are queued with their resume (see LinuxThread::AddResume), so they are made
+/// in the same trip to the monitor's operation thread.  A thread that doesn't
+/// run can't hit a watchpoint, so nothing is written to the threads that stay
+/// stopped, and new threads get the current values the first time they are
+/// resumed.
+class DebugRegisterManager
+{
+public:
+    /// The number of debug address registers (dr0-dr3).
+    static const uint32_t k_num_slots = 4;
+
+    DebugRegisterManager();
+
+    ~DebugRegisterManager();
+
+    uint32_t
+    GetNumSlots() const { return k_num_slots; }
+
+    /// Returns the index of a debug address register that isn't in use, or
+    /// LLDB_INVALID_INDEX32 if they all are.
+    uint32_t
+    FindVacantSlot() const;
+
+    bool
+    IsSlotVacant(uint32_t slot) const;
+
+    /// Returns true if @p slot holds a hardware breakpoint rather than a
+    /// watchpoint.
+    bool
+    IsBreakpointSlot(uint32_t slot) const;
+
+    lldb::addr_t
+    GetSlotAddress(uint32_t slot) const;
+
+    /// Watches the @p size bytes at @p addr for reads and/or writes with the
+    /// vacant debug address register @p slot.  Fails if the hardware can't
+    /// watch that range.
+    bool
+    SetWatchpoint(uint32_t slot, lldb::addr_t addr, size_t size,
+                  bool read, bool write);
+
+    /// Stops at the instruction at @p addr with the vacant debug address
+    /// register @p slot.
+    bool
+    SetBreakpoint(uint32_t slot, lldb::addr_t addr);
+
+    /// Frees @p slot.
+    void
+    ClearSlot(uint32_t slot);
+
+    /// Returns the value all threads should have in debug address register
+    /// @p slot.
+    uint64_t
+    GetAddressRegister(uint32_t slot) const { return m_addresses[slot]; }
+
+    /// Returns the value all threads should have in the debug control
+    /// register (dr7).
+    uint64_t
+    GetControlRegister() const { return m_control; }
+
+    /// Returns a count that changes every time the registers do.
+    uint32_t
+    GetGeneration() const { return m_generation; }
+
+    /// Returns the bits of dr7 that belong to @p slot.
+    static uint64_t
+    GetSlotControlMask(uint32_t slot);
+
+private:
+    bool
+    SetSlot(uint32_t slot, lldb::addr_t addr, uint64_t rw_len_bits);
+
+    uint64_t m_addresses[k_num_slots];
+    uint64_t m_control;
+    uint32_t m_generation;
+};
+
+#endif // #ifndef liblldb_DebugRegisterManager_H_
@@ -11,7 +11,18 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/StreamFile.h"
+#include "lldb/Core/State.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+
+#include "DebugRegisterManager.h"
 #include "LinuxThread.h"
+#include "ProcessLinux.h"
+#include "ProcessMonitor.h"
+#include "ProcessPOSIXLog.h"
+#include "RegisterContextPOSIXProcessMonitor_x86.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -20,7 +31,8 @@ using namespace lldb_private;
 // Constructors and destructors.
 
 LinuxThread::LinuxThread(Process &process, lldb::tid_t tid)
-    : POSIXThread(process, tid)
+    : POSIXThread(process, tid),
+      m_debug_register_generation(0)
 {
 }
 
@@ -40,3 +52,168 @@ LinuxThread::RefreshStateAfterStop()
 
     POSIXThread::RefreshStateAfterStop();
 }
+
+void
+LinuxThread::AddRegisterReads(OperationBatch &batch)
+{
+    lldb::RegisterContextSP reg_ctx_sp = GetRegisterContext();
+    if (!reg_ctx_sp)
+        return;
+
+    // Drop the registers of the previous stop first, so that they aren't
+    // thrown away again after they have been read.
+    const bool force = false;
+    reg_ctx_sp->InvalidateIfNeeded (force);
+
+    switch (GetProcess()->GetTarget().GetArchitecture().GetCore())
+    {
+        case ArchSpec::eCore_x86_32_i386:
+        case ArchSpec::eCore_x86_32_i486:
+        case ArchSpec::eCore_x86_32_i486sx:
+        case ArchSpec::eCore_x86_64_x86_64:
+            static_cast<RegisterContextPOSIXProcessMonitor_x86_64 *>(reg_ctx_sp.get())->AddRegisterReads(batch);
+            break;
+        default:
+            break;
+    }
+}
+
+void
+LinuxThread::AddRegisterWrites(OperationBatch &batch)
+{
+    if (!m_reg_context_sp)
+        return;
+
+    switch (GetProcess()->GetTarget().GetArchitecture().GetCore())
+    {
+        case ArchSpec::eCore_x86_32_i386:
+        case ArchSpec::eCore_x86_32_i486:
+        case ArchSpec::eCore_x86_32_i486sx:
+        case ArchSpec::eCore_x86_64_x86_64:
+            static_cast<RegisterContextPOSIXProcessMonitor_x86_64 *>(m_reg_context_sp.get())->AddRegisterWrites(batch);
+            break;
+        default:
+            break;
+    }
+
+    // Anything that wasn't queued is written now, and the registers that were
+    // read are stale once the thread runs.
+    FlushRegisters();
+}
+
+void
+LinuxThread::AddDebugRegisterWrites(OperationBatch &batch)
+{
+    const DebugRegisterManager &manager =
+        static_cast<ProcessLinux *>(GetProcess().get())->GetDebugRegisterManager();
+    if (m_debug_register_generation == manager.GetGeneration())
+        return;
+
+    lldb::RegisterContextSP reg_ctx_sp = GetRegisterContext();
+    if (!reg_ctx_sp)
+        return;
+
+    switch (GetProcess()->GetTarget().GetArchitecture().GetCore())
+    {
+        case ArchSpec::eCore_x86_32_i386:
+        case ArchSpec::eCore_x86_32_i486:
+        case ArchSpec::eCore_x86_32_i486sx:
+        case ArchSpec::eCore_x86_64_x86_64:
+            static_cast<RegisterContextPOSIXProcessMonitor_x86_64 *>(reg_ctx_sp.get())->AddDebugRegisterWrites(batch, manager);
+            break;
+        default:
+            break;
+    }
+    m_debug_register_generation = manager.GetGeneration();
+}
+
+void
+LinuxThread::CheckBatchedWrites()
+{
+    if (!m_reg_context_sp)
+        return;
+
+    switch (GetProcess()->GetTarget().GetArchitecture().GetCore())
+    {
+        case ArchSpec::eCore_x86_32_i386:
+        case ArchSpec::eCore_x86_32_i486:
+        case ArchSpec::eCore_x86_32_i486sx:
+        case ArchSpec::eCore_x86_64_x86_64:
+            {
+                RegisterContextPOSIXProcessMonitor_x86_64 *reg_ctx =
+                    static_cast<RegisterContextPOSIXProcessMonitor_x86_64 *>(m_reg_context_sp.get());
+                if (!reg_ctx->CheckRegisterWrites())
+                {
+                    StreamFileSP error_sp (GetProcess()->GetTarget().GetDebugger().GetErrorFile());
+                    error_sp->Printf ("warning: failed to write the registers of thread 0x%" PRIx64 " before resuming it\n",
+                                      GetID());
+                }
+                if (!reg_ctx->CheckDebugRegisterWrites())
+                {
+                    // Write all the debug registers again the next time the
+                    // thread is resumed.
+                    m_debug_register_generation = UINT32_MAX;
+                    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
+                    if (log)
+                        log->Printf ("LinuxThread::%s () failed to write the debug registers of thread 0x%" PRIx64,
+                                     __FUNCTION__, GetID());
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool
+LinuxThread::CanResumePastHardwareBreakpoint()
+{
+    return true;
+}
+
+void
+LinuxThread::AddResume(OperationBatch &batch, bool &result)
+{
+    lldb::StateType resume_state = GetResumeState();
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+    if (log)
+        log->Printf ("LinuxThread::%s (), resume_state = %s", __FUNCTION__,
+                         StateAsCString(resume_state));
+
+    // In non-stop mode the threads that didn't stop are still running.
+    // ProcessLinux stops them before it changes the debug registers, so
+    // they don't have any writes to pick up.
+    if (StateIsRunningState(GetState()) && GetProcess()->IsNonStopModeActive())
+    {
+        result = true;
+        return;
+    }
+
+    switch (resume_state)
+    {
+    default:
+        assert(false && "Unexpected state for resume!");
+        result = false;
+        break;
+
+    case lldb::eStateRunning:
+        SetState(resume_state);
+        AddRegisterWrites(batch);
+        AddDebugRegisterWrites(batch);
+        batch.AddResume(GetID(), GetResumeSignal(), result);
+        break;
+
+    case lldb::eStateStepping:
+        SetState(resume_state);
+        AddRegisterWrites(batch);
+        AddDebugRegisterWrites(batch);
+        batch.AddSingleStep(GetID(), GetResumeSignal(), result);
+        break;
+
+    case lldb::eStateStopped:
+    case lldb::eStateSuspended:
+        result = true;
+        break;
+    }
+}
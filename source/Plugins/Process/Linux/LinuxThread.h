@@ -13,6 +13,8 @@
 // Other libraries and framework includes
 #include "POSIXThread.h"
 
+class OperationBatch;
+
 //------------------------------------------------------------------------------
 // @class LinuxThread
 // @brief Abstraction of a Linux thread.
@@ -34,6 +36,45 @@ public:
     // POSIXThread override
     virtual void
     RefreshStateAfterStop();
+
+    // Queues reads of the registers of this thread that aren't cached yet in
+    // @p batch, so they can be read together with those of other threads.
+    void
+    AddRegisterReads(OperationBatch &batch);
+
+    // Like POSIXThread::Resume, but queues the request to resume this thread
+    // in @p batch.  @p result is set to whether the thread was resumed once
+    // the batch has run (or right away if the thread stays stopped).
+    void
+    AddResume(OperationBatch &batch, bool &result);
+
+    // Checks the register writes AddResume queued once the batch has run.
+    // The user is warned about failed writes of the general purpose and
+    // floating point registers, failed debug register writes are logged and
+    // retried on the next resume.
+    void
+    CheckBatchedWrites();
+
+    // Thread override.  The kernel sets the resume flag when a thread stops
+    // at a hardware breakpoint, so the thread runs the instruction at the
+    // breakpoint when it is resumed.
+    virtual bool
+    CanResumePastHardwareBreakpoint();
+
+private:
+    // Queues writes of the debug registers in @p batch if they have changed
+    // since this thread was last resumed.
+    void
+    AddDebugRegisterWrites(OperationBatch &batch);
+
+    // The DebugRegisterManager generation the debug registers of this thread
+    // were last written for, or UINT32_MAX if writing them failed.
+    uint32_t m_debug_register_generation;
+
+    // Queues writes of the registers changed while this thread was stopped in
+    // @p batch, ahead of its resume.
+    void
+    AddRegisterWrites(OperationBatch &batch);
 };
 
 #endif // #ifndef liblldb_LinuxThread_H_
@@ -9,11 +9,23 @@
 
 // C Includes
 #include <errno.h>
+#include <signal.h>
+#include <unistd.h>
 
 // C++ Includes
+#include <memory>
+#include <queue>
+#include <set>
+#include <vector>
+
 // Other libraries and framework includes
+#include "lldb/Breakpoint/BreakpointSite.h"
+#include "lldb/Breakpoint/Watchpoint.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/StreamFile.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Target/DynamicLoader.h"
@@ -21,6 +33,7 @@
 
 #include "ProcessLinux.h"
 #include "ProcessPOSIXLog.h"
+#include "POSIXStopInfo.h"
 #include "Plugins/Process/Utility/InferiorCallPOSIX.h"
 #include "ProcessMonitor.h"
 #include "LinuxThread.h"
@@ -64,7 +77,8 @@ ProcessLinux::Initialize()
 // Constructors and destructors.
 
 ProcessLinux::ProcessLinux(Target& target, Listener &listener, FileSpec *core_file)
-    : ProcessPOSIX(target, listener), m_core_file(core_file), m_stopping_threads(false)
+    : ProcessPOSIX(target, listener), m_core_file(core_file), m_stopping_threads(false), m_halt_requested(false),
+      m_debug_registers(), m_num_vfork_children(0)
 {
 #if 0
     // FIXME: Putting this code in the ctor and saving the byte order in a
@@ -148,6 +162,11 @@ ProcessLinux::DoDetach(bool keep_stopped)
         return error;
     }
 
+    // Only stopped threads can be detached from.
+    error = StopRunningThreads();
+    if (error.Fail())
+        return error;
+
     Mutex::Locker lock(m_thread_list.GetMutex());
 
     uint32_t thread_count = m_thread_list.GetSize(false);
@@ -155,6 +174,7 @@ ProcessLinux::DoDetach(bool keep_stopped)
     {
         POSIXThread *thread = static_cast<POSIXThread*>(
             m_thread_list.GetThreadAtIndex(i, false).get());
+        thread->FlushRegisters();
         error = m_monitor->Detach(thread->GetID());
     }
 
@@ -174,9 +194,19 @@ ProcessLinux::StopAllThreads(lldb::tid_t stop_tid)
     // thread calls this function, so we don't need to protect this flag.
     if (m_stopping_threads)
       return;
-    m_stopping_threads = true;
 
     Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+
+    // In non-stop mode only the thread that reported the event stops, unless
+    // the user interrupted the process.
+    if (IsNonStopModeActive() && !m_halt_requested.GetValue())
+    {
+        if (log)
+            log->Printf ("ProcessLinux::%s() non-stop mode, only tid %" PRIu64 " stops", __FUNCTION__, stop_tid);
+        return;
+    }
+    m_stopping_threads = true;
+
     if (log)
         log->Printf ("ProcessLinux::%s() stopping all threads", __FUNCTION__);
 
@@ -184,21 +214,567 @@ ProcessLinux::StopAllThreads(lldb::tid_t stop_tid)
     // the stop should already be marked as stopped before we get here.
     Mutex::Locker thread_list_lock(m_thread_list.GetMutex());
 
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    TimeValue start_time (TimeValue::Now());
+
+    // Signal all of them at once and wait for the stops together, rather than
+    // waiting for each thread to stop before signalling the next one.
+    std::vector<lldb::tid_t> tids;
     uint32_t thread_count = m_thread_list.GetSize(false);
     for (uint32_t i = 0; i < thread_count; ++i)
     {
         POSIXThread *thread = static_cast<POSIXThread*>(
             m_thread_list.GetThreadAtIndex(i, false).get());
         assert(thread);
-        lldb::tid_t tid = thread->GetID();
         if (!StateIsStoppedState(thread->GetState(), false))
-            m_monitor->StopThread(tid);
+            tids.push_back(thread->GetID());
     }
 
+    if (!tids.empty())
+        m_monitor->StopThreads(tids);
+
+    const uint64_t elapsed_usec = (TimeValue::Now() - start_time) / TimeValue::NanoSecPerMicroSec;
+    Timer::RecordSample ("ProcessLinux::StopAllThreads() threads", thread_count);
+    Timer::RecordSample ("ProcessLinux::StopAllThreads() threads signalled", tids.size());
+    Timer::RecordSample ("ProcessLinux::StopAllThreads() latency (usec)", elapsed_usec);
+
     m_stopping_threads = false;
+    m_halt_requested.SetValue(false, eBroadcastAlways);
+
+    if (log)
+        log->Printf ("ProcessLinux::%s() finished, stopped %" PRIu64 " of %" PRIu32 " threads in %" PRIu64 " usec",
+                     __FUNCTION__, (uint64_t)tids.size(), thread_count, elapsed_usec);
+}
+
+Error
+ProcessLinux::DoResume()
+{
+    StateType state = GetPrivateState();
+
+    assert(state == eStateStopped);
+
+    SetPrivateState(eStateRunning);
+
+    // Hold off messages from the monitor while we decide what to resume, so
+    // that a thread can't stop for an event in between.
+    Mutex::Locker message_lock(m_message_mutex);
+    Mutex::Locker lock(m_thread_list.GetMutex());
+
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+
+    // In non-stop mode other threads can stop for events while the process is
+    // stopped.  Those events haven't been reported yet, so keep the threads
+    // stopped and report them right away.
+    std::set<lldb::tid_t> pending_tids;
+    if (IsNonStopModeActive())
+    {
+        std::queue<ProcessMessage> messages(m_message_queue);
+        for (; !messages.empty(); messages.pop())
+            pending_tids.insert(messages.front().GetTID());
+    }
+
+    // Resume all the threads in one trip to the monitor's operation thread
+    // instead of one trip per thread.
+    const uint32_t thread_count = m_thread_list.GetSize(false);
+    std::unique_ptr<bool[]> resumed(new bool[thread_count]);
+    OperationBatch batch;
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        LinuxThread *thread = static_cast<LinuxThread*>(
+            m_thread_list.GetThreadAtIndex(i, false).get());
+        if (pending_tids.count(thread->GetID()))
+            resumed[i] = false;
+        else
+            thread->AddResume(batch, resumed[i]);
+    }
+    m_monitor->DoBatch(batch);
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        LinuxThread *thread = static_cast<LinuxThread*>(
+            m_thread_list.GetThreadAtIndex(i, false).get());
+        if (!pending_tids.count(thread->GetID()))
+            thread->CheckBatchedWrites();
+    }
+
+    bool did_resume = false;
+    for (uint32_t i = 0; i < thread_count; ++i)
+        did_resume = resumed[i] || did_resume;
+    assert((did_resume || !pending_tids.empty()) && "Process resume failed!");
+
+    Timer::RecordSample ("ProcessLinux::DoResume() threads", thread_count);
+
+    if (!pending_tids.empty())
+    {
+        Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+        if (log)
+            log->Printf ("ProcessLinux::%s() %" PRIu64 " threads have pending stop events",
+                         __FUNCTION__, (uint64_t)pending_tids.size());
+        SetPrivateState(eStateStopped);
+    }
+
+    return Error();
+}
+
+Error
+ProcessLinux::DoHalt(bool &caused_stop)
+{
+    // An interrupt stops all threads, even in non-stop mode.
+    if (!IsStopped())
+    {
+        m_halt_requested.SetValue(true, eBroadcastNever);
+        return ProcessPOSIX::DoHalt(caused_stop);
+    }
+
+    // In non-stop mode some threads may still be running.  Stopping them
+    // doesn't change the state of the process, so there is no stop event.
+    caused_stop = false;
+    return StopRunningThreads();
+}
+
+Error
+ProcessLinux::StopRunningThreads()
+{
+    Error error;
+    if (!IsNonStopModeActive() || !m_monitor || !IsStopped())
+        return error;
+
+    lldb::tid_t interrupt_tid = LLDB_INVALID_THREAD_ID;
+    {
+        Mutex::Locker lock(m_thread_list.GetMutex());
+        const uint32_t thread_count = m_thread_list.GetSize(false);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            ThreadSP thread_sp = m_thread_list.GetThreadAtIndex(i, false);
+            if (StateIsRunningState(thread_sp->GetState()))
+            {
+                interrupt_tid = thread_sp->GetID();
+                break;
+            }
+        }
+    }
+    if (interrupt_tid == LLDB_INVALID_THREAD_ID)
+        return error;
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+    if (log)
+        log->Printf ("ProcessLinux::%s() interrupting tid %" PRIu64, __FUNCTION__, interrupt_tid);
+
+    // Only the monitor thread may wait for the threads, so interrupt one of
+    // them and let the monitor stop the others when it sees that stop.
+    m_halt_requested.SetValue(true, eBroadcastNever);
+    if (!m_monitor->InterruptThread(interrupt_tid))
+    {
+        m_halt_requested.SetValue(false, eBroadcastNever);
+        error.SetErrorStringWithFormat("failed to interrupt thread %" PRIu64, interrupt_tid);
+        return error;
+    }
+
+    TimeValue timeout_time (TimeValue::Now());
+    timeout_time.OffsetWithSeconds(10);
+    bool timed_out = false;
+    m_halt_requested.WaitForValueEqualTo(false, &timeout_time, &timed_out);
+    if (timed_out)
+    {
+        m_halt_requested.SetValue(false, eBroadcastNever);
+        error.SetErrorString("timed out waiting for the running threads to stop");
+        return error;
+    }
+
+    // The stop of the interrupted thread is ours, not one to report to the
+    // user.  SendMessage queues it before it lets go of the message mutex.
+    Mutex::Locker message_lock(m_message_mutex);
+    std::queue<ProcessMessage> messages;
+    for (; !m_message_queue.empty(); m_message_queue.pop())
+    {
+        const ProcessMessage &message = m_message_queue.front();
+        if (message.GetTID() == interrupt_tid &&
+            message.GetKind() == ProcessMessage::eSignalDeliveredMessage &&
+            message.GetSignal() == SIGSTOP)
+            continue;
+        messages.push(message);
+    }
+    m_message_queue.swap(messages);
+    return error;
+}
+
+bool
+ProcessLinux::IsNonStopModeActive()
+{
+    return GetNonStopModeEnabled();
+}
+
+bool
+ProcessLinux::HasDebugRegisters()
+{
+    switch (GetTarget().GetArchitecture().GetCore())
+    {
+        case ArchSpec::eCore_x86_32_i386:
+        case ArchSpec::eCore_x86_32_i486:
+        case ArchSpec::eCore_x86_32_i486sx:
+        case ArchSpec::eCore_x86_64_x86_64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The breakpoints and watchpoints below only change the values held by
+// m_debug_registers.  The threads are brought up to date with them together
+// with their resume (see LinuxThread::AddResume), so setting one costs no
+// ptrace calls, and a thread that stays stopped is never written to.
+// In non-stop mode the threads that are still running would miss the
+// change, so they are stopped first and pick it up when they are resumed.
+
+Error
+ProcessLinux::EnableBreakpointSite(BreakpointSite *bp_site)
+{
+    if (!bp_site->HardwareRequired())
+        return EnableSoftwareBreakpoint(bp_site);
+
+    Error error;
+    const addr_t addr = bp_site->GetLoadAddress();
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("ProcessLinux::%s (site_id = %" PRIu64 ") addr = 0x%" PRIx64,
+                     __FUNCTION__, (uint64_t)bp_site->GetID(), (uint64_t)addr);
+
+    if (bp_site->IsEnabled())
+        return error;
+
+    if (!HasDebugRegisters())
+    {
+        error.SetErrorString("hardware breakpoints are not supported");
+        return error;
+    }
+
+    error = StopRunningThreads();
+    if (error.Fail())
+        return error;
+
+    const uint32_t slot = m_debug_registers.FindVacantSlot();
+    if (slot == LLDB_INVALID_INDEX32 || !m_debug_registers.SetBreakpoint(slot, addr))
+    {
+        error.SetErrorString("failed to set hardware breakpoint (hardware breakpoint resources might be exhausted or unavailable)");
+        return error;
+    }
+
+    bp_site->SetHardwareIndex(slot);
+    bp_site->SetType(BreakpointSite::eHardware);
+    bp_site->SetEnabled(true);
+    return error;
+}
+
+Error
+ProcessLinux::DisableBreakpointSite(BreakpointSite *bp_site)
+{
+    if (!bp_site->IsHardware())
+        return DisableSoftwareBreakpoint(bp_site);
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("ProcessLinux::%s (site_id = %" PRIu64 ") addr = 0x%" PRIx64,
+                     __FUNCTION__, (uint64_t)bp_site->GetID(), (uint64_t)bp_site->GetLoadAddress());
+
+    Error error = StopRunningThreads();
+    if (error.Fail() && log)
+        log->Printf ("ProcessLinux::%s failed to stop the running threads: %s", __FUNCTION__, error.AsCString());
+
+    m_debug_registers.ClearSlot(bp_site->GetHardwareIndex());
+    bp_site->SetHardwareIndex(LLDB_INVALID_INDEX32);
+    bp_site->SetEnabled(false);
+    return Error();
+}
 
+Error
+ProcessLinux::EnableWatchpoint(Watchpoint *wp, bool notify)
+{
+    if (wp == NULL || !HasDebugRegisters())
+        return ProcessPOSIX::EnableWatchpoint(wp, notify);
+
+    Error error;
+    const user_id_t watchID = wp->GetID();
+    const addr_t addr = wp->GetLoadAddress();
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_WATCHPOINTS));
     if (log)
-        log->Printf ("ProcessLinux::%s() finished", __FUNCTION__);
+        log->Printf ("ProcessLinux::%s (watchID = %" PRIu64 ") addr = 0x%" PRIx64,
+                     __FUNCTION__, watchID, (uint64_t)addr);
+
+    if (wp->IsEnabled())
+        return error;
+
+    error = StopRunningThreads();
+    if (error.Fail())
+        return error;
+
+    const uint32_t slot = m_debug_registers.FindVacantSlot();
+    if (slot == LLDB_INVALID_INDEX32 ||
+        !m_debug_registers.SetWatchpoint(slot, addr, wp->GetByteSize(),
+                                         wp->WatchpointRead(), wp->WatchpointWrite()))
+    {
+        error.SetErrorString("Setting hardware watchpoint failed.");
+        return error;
+    }
+
+    wp->SetHardwareIndex(slot);
+    wp->SetEnabled(true, notify);
+    return error;
+}
+
+Error
+ProcessLinux::DisableWatchpoint(Watchpoint *wp, bool notify)
+{
+    if (wp == NULL || !HasDebugRegisters())
+        return ProcessPOSIX::DisableWatchpoint(wp, notify);
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf ("ProcessLinux::%s (watchID = %" PRIu64 ")",
+                     __FUNCTION__, wp->GetID());
+
+    if (wp->IsEnabled() && wp->IsHardware())
+    {
+        Error error = StopRunningThreads();
+        if (error.Fail() && log)
+            log->Printf ("ProcessLinux::%s failed to stop the running threads: %s", __FUNCTION__, error.AsCString());
+        m_debug_registers.ClearSlot(wp->GetHardwareIndex());
+        wp->SetHardwareIndex(LLDB_INVALID_INDEX32);
+    }
+    wp->SetEnabled(false, notify);
+    return Error();
+}
+
+void
+ProcessLinux::RefreshStateAfterStop()
+{
+    // Handling the stop reads the registers of the threads that stopped and
+    // of those with plans or frames that will be looked at again.  Reading
+    // them all at once is much cheaper than a trip to the monitor for each.
+    PrefetchThreadRegisters();
+
+    UpdateMemoryThread();
+
+    // Forks are followed once all the threads know why they stopped, since
+    // following the child lets go of the threads of this process.
+    std::vector<ProcessMessage> fork_messages;
+    {
+        Mutex::Locker message_lock(m_message_mutex);
+        std::queue<ProcessMessage> messages(m_message_queue);
+        for (; !messages.empty(); messages.pop())
+        {
+            switch (messages.front().GetKind())
+            {
+            case ProcessMessage::eForkMessage:
+            case ProcessMessage::eVForkMessage:
+            case ProcessMessage::eVForkDoneMessage:
+                fork_messages.push_back(messages.front());
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    ProcessPOSIX::RefreshStateAfterStop();
+
+    std::vector<ProcessMessage>::const_iterator pos, end = fork_messages.end();
+    for (pos = fork_messages.begin(); pos != end; ++pos)
+    {
+        if (pos->GetKind() == ProcessMessage::eVForkDoneMessage)
+            DidVForkDone(pos->GetTID());
+        else
+            FollowFork(pos->GetTID(), pos->GetChildTID(),
+                       pos->GetKind() == ProcessMessage::eVForkMessage);
+    }
+}
+
+void
+ProcessLinux::FollowFork(lldb::tid_t parent_tid, lldb::pid_t child_pid, bool is_vfork)
+{
+    // Forks are only traced when the child is to be followed (see
+    // ProcessMonitor::SetDefaultPtraceOpts).  The forking thread is gone if
+    // an earlier fork at this stop was followed into its child.  The
+    // children of the process it left are let go.
+    ThreadSP parent_thread_sp (m_thread_list.FindThreadByID(parent_tid, false));
+    bool follow_child = GetFollowForkMode() == eFollowForkChild && parent_thread_sp;
+
+    // The monitor only hears from the process group it waits on.
+    if (follow_child && ::getpgid(child_pid) != m_monitor->GetGroupPID())
+    {
+        GetTarget().GetDebugger().GetErrorFile()->Printf ("warning: not following child process %" PRIu64 ", it isn't in process group %" PRIu64 "\n",
+                                                          child_pid, m_monitor->GetGroupPID());
+        follow_child = false;
+    }
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+    if (log)
+        log->Printf ("ProcessLinux::%s() %" PRIu64 " %s %" PRIu64 ", following the %s",
+                     __FUNCTION__, GetID(), is_vfork ? "vforked" : "forked",
+                     child_pid, follow_child ? "child" : "parent");
+
+    if (!follow_child)
+    {
+        // The child inherited the breakpoints, which would kill it with a
+        // SIGTRAP once nobody traces it.  A vforked child shares its memory
+        // with this process until it execs or exits, so they come out of
+        // both until then, but the sites stay enabled.
+        WriteBreakpointSiteBytes(child_pid, false);
+        if (is_vfork)
+            ++m_num_vfork_children;
+
+        Error error = m_monitor->Detach(child_pid);
+        if (log && error.Fail())
+            log->Printf ("ProcessLinux::%s() failed to detach from %" PRIu64 ": %s",
+                         __FUNCTION__, child_pid, error.AsCString());
+        m_seen_initial_stop.erase(child_pid);
+        return;
+    }
+
+    Mutex::Locker thread_list_lock(m_thread_list.GetMutex());
+
+    // A step the forking thread was doing can't carry on in the child, whose
+    // thread starts out without plans.  Rather than let the child run off,
+    // which is what dropping the step would do, stop it where it forked.
+    const bool stop_in_child = parent_thread_sp->HasPublicPlans();
+
+    // The plans of the threads go with them.  Discard them first, since
+    // the ones stepping over breakpoints put them back when they go.
+    m_thread_list.DiscardThreadPlans();
+
+    // Take the breakpoints out of this process before letting it go; the
+    // child keeps them.  The vforked child shares its memory, so they come
+    // out of both, and are set again when the child execs.
+    if (is_vfork)
+    {
+        std::vector<lldb::break_id_t> site_ids;
+        DisableSoftwareBreakpointSites(site_ids);
+    }
+    else
+        WriteBreakpointSiteBytes(parent_tid, false);
+
+    // Detaching also clears the debug registers of the threads.
+    const uint32_t thread_count = m_thread_list.GetSize(false);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        const lldb::tid_t tid = m_thread_list.GetThreadAtIndex(i, false)->GetID();
+        Error error = m_monitor->Detach(tid);
+        if (log && error.Fail())
+            log->Printf ("ProcessLinux::%s() failed to detach from %" PRIu64 ": %s",
+                         __FUNCTION__, tid, error.AsCString());
+    }
+
+    // The child's address space is a copy of this process's, so the target
+    // with its modules, symbols and breakpoints carries on with the child
+    // and nothing has to be loaded again.
+    SetID(child_pid);
+    m_monitor->FollowChild(child_pid);
+    m_thread_list.Clear();
+    m_seen_initial_stop.clear();
+    m_seen_initial_stop.insert(child_pid);
+    m_num_vfork_children = 0;
+
+    POSIXThread *child_thread = CreateNewPOSIXThread(*this, child_pid);
+    ThreadSP thread_sp(child_thread);
+    m_thread_list.AddThread(thread_sp);
+    thread_sp->RefreshStateAfterStop();
+    if (stop_in_child)
+    {
+        const ProcessMessage::Kind kind = is_vfork ? ProcessMessage::eVForkMessage : ProcessMessage::eForkMessage;
+        thread_sp->SetStopInfo(StopInfoSP(new POSIXForkStopInfo(*child_thread, kind, true)));
+        m_thread_list.SetSelectedThreadByID(child_pid);
+    }
+
+    // Breakpoints that a discarded plan had taken out while stepping over
+    // them were just put back into this process, but not the child.
+    if (!is_vfork)
+        WriteBreakpointSiteBytes(child_pid, true);
+
+    UpdateMemoryThread();
+}
+
+void
+ProcessLinux::DidVForkDone(lldb::tid_t tid)
+{
+    if (m_num_vfork_children == 0 || --m_num_vfork_children > 0)
+        return;
+
+    // Sites that were added or removed in the meantime were written to the
+    // shared memory as usual, so this puts back exactly the enabled ones.
+    WriteBreakpointSiteBytes(tid, true);
+}
+
+void
+ProcessLinux::WriteBreakpointSiteBytes(lldb::tid_t tid, bool insert)
+{
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_BREAKPOINTS));
+
+    // ptrace accesses the memory of the process the thread belongs to.
+    m_monitor->SetMemoryThreadID(tid);
+    m_breakpoint_site_list.ForEach([this, log, tid, insert](BreakpointSite *bp_site) -> void {
+        if (!bp_site->IsEnabled() || bp_site->IsHardware())
+            return;
+        const size_t size = bp_site->GetByteSize();
+        const uint8_t *bytes = insert ? bp_site->GetTrapOpcodeBytes() : bp_site->GetSavedOpcodeBytes();
+        Error error;
+        if (m_monitor->WriteMemory(bp_site->GetLoadAddress(), bytes, size, error) != size && log)
+            log->Printf ("ProcessLinux::WriteBreakpointSiteBytes() failed to write site %" PRIu64 " of %" PRIu64 ": %s",
+                         (uint64_t)bp_site->GetID(), tid, error.AsCString());
+    });
+    UpdateMemoryThread();
+}
+
+void
+ProcessLinux::DisableSoftwareBreakpointSites(std::vector<lldb::break_id_t> &site_ids)
+{
+    m_breakpoint_site_list.ForEach([this, &site_ids](BreakpointSite *bp_site) -> void {
+        if (!bp_site->IsEnabled() || bp_site->IsHardware())
+            return;
+        if (DisableBreakpointSite(bp_site).Success())
+            site_ids.push_back(bp_site->GetID());
+    });
+}
+
+void
+ProcessLinux::PrefetchThreadRegisters()
+{
+    if (!m_monitor)
+        return;
+
+    // The batch stores the results in the threads' register contexts, so
+    // keep the threads from going away until it is done.
+    Mutex::Locker message_lock(m_message_mutex);
+    Mutex::Locker thread_list_lock(m_thread_list.GetMutex());
+
+    // The threads that the messages are about are going to be looked at.
+    // The others are usually idle (see Thread::IsIdle()) and nobody reads
+    // their registers unless the user asks about them.
+    std::set<lldb::tid_t> message_tids;
+    std::queue<ProcessMessage> messages(m_message_queue);
+    for (; !messages.empty(); messages.pop())
+        message_tids.insert(messages.front().GetTID());
+
+    OperationBatch batch;
+    uint32_t num_read = 0;
+    const uint32_t thread_count = m_thread_list.GetSize(false);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        LinuxThread *thread = static_cast<LinuxThread*>(
+            m_thread_list.GetThreadAtIndex(i, false).get());
+        // In non-stop mode the registers of running threads can't be read.
+        if (!thread || StateIsRunningState(thread->GetState()))
+            continue;
+        if (!message_tids.count(thread->GetID()) && thread->IsIdle())
+            continue;
+        thread->AddRegisterReads(batch);
+        ++num_read;
+    }
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
+    if (log)
+        log->Printf ("ProcessLinux::%s() reading registers of %" PRIu32 " of %" PRIu32 " threads with %" PRIu64 " operations",
+                     __FUNCTION__, num_read, thread_count, (uint64_t)batch.GetSize());
+
+    m_monitor->DoBatch(batch);
 }
 
 // ProcessPOSIX override
@@ -221,3 +797,36 @@ ProcessLinux::CanDebug(Target &target, bool plugin_specified_by_name)
     return ProcessPOSIX::CanDebug(target, plugin_specified_by_name);
 }
 
+void
+ProcessLinux::UpdateMemoryThread()
+{
+    if (!m_monitor)
+        return;
+
+    if (!IsNonStopModeActive())
+    {
+        m_monitor->SetMemoryThreadID(LLDB_INVALID_THREAD_ID);
+        return;
+    }
+
+    Mutex::Locker thread_list_lock(m_thread_list.GetMutex());
+
+    // Prefer the main thread, so that we don't switch threads needlessly.
+    ThreadSP thread_sp = m_thread_list.FindThreadByID(GetID(), false);
+    if (!thread_sp || StateIsRunningState(thread_sp->GetState()))
+    {
+        thread_sp.reset();
+        const uint32_t thread_count = m_thread_list.GetSize(false);
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            ThreadSP candidate_sp = m_thread_list.GetThreadAtIndex(i, false);
+            if (!StateIsRunningState(candidate_sp->GetState()))
+            {
+                thread_sp = candidate_sp;
+                break;
+            }
+        }
+    }
+
+    m_monitor->SetMemoryThreadID(thread_sp ? thread_sp->GetID() : LLDB_INVALID_THREAD_ID);
+}
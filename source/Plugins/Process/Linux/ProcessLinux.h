@@ -14,9 +14,12 @@
 
 // C++ Includes
 #include <queue>
+#include <vector>
 
 // Other libraries and framework includes
+#include "lldb/Host/Predicate.h"
 #include "lldb/Target/Process.h"
+#include "DebugRegisterManager.h"
 #include "LinuxSignals.h"
 #include "ProcessMessage.h"
 #include "ProcessPOSIX.h"
@@ -60,6 +63,30 @@ public:
     virtual bool
     UpdateThreadList(lldb_private::ThreadList &old_thread_list, lldb_private::ThreadList &new_thread_list);
 
+    virtual void
+    RefreshStateAfterStop();
+
+    virtual lldb_private::Error
+    DoResume();
+
+    virtual lldb_private::Error
+    DoHalt(bool &caused_stop);
+
+    virtual bool
+    IsNonStopModeActive();
+
+    virtual lldb_private::Error
+    EnableBreakpointSite(lldb_private::BreakpointSite *bp_site);
+
+    virtual lldb_private::Error
+    DisableBreakpointSite(lldb_private::BreakpointSite *bp_site);
+
+    virtual lldb_private::Error
+    EnableWatchpoint(lldb_private::Watchpoint *wp, bool notify = true);
+
+    virtual lldb_private::Error
+    DisableWatchpoint(lldb_private::Watchpoint *wp, bool notify = true);
+
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
@@ -101,8 +128,59 @@ public:
     virtual POSIXThread *
     CreateNewPOSIXThread(lldb_private::Process &process, lldb::tid_t tid);
 
+    //------------------------------------------------------------------
+    // ProcessLinux internal API.
+    //------------------------------------------------------------------
+
+    /// Provides the debug register values the threads of this process are
+    /// brought up to date with when they are resumed.
+    const DebugRegisterManager &
+    GetDebugRegisterManager() const { return m_debug_registers; }
+
 private:
 
+    /// Returns true if hardware watchpoints and breakpoints are set with
+    /// the DebugRegisterManager on this architecture.
+    bool
+    HasDebugRegisters();
+
+    /// Reads the registers of all threads in one trip to the monitor's
+    /// operation thread.
+    void
+    PrefetchThreadRegisters();
+
+    /// Stops the threads that are still running while the process is
+    /// stopped in non-stop mode, and waits until they are.  The process
+    /// stays stopped, so no stop event is sent.
+    lldb_private::Error
+    StopRunningThreads();
+
+    /// Picks a stopped thread for the monitor to access memory through.
+    void
+    UpdateMemoryThread();
+
+    /// Follows the fork of @p child_pid by the thread @p parent_tid as the
+    /// follow-fork-mode setting says, and lets go of the other process.
+    void
+    FollowFork(lldb::tid_t parent_tid, lldb::pid_t child_pid, bool is_vfork);
+
+    /// Puts the software breakpoints back in through the thread @p tid once
+    /// no vforked child shares the memory of the process any more.
+    void
+    DidVForkDone(lldb::tid_t tid);
+
+    /// Writes the original bytes of the enabled software breakpoint sites,
+    /// or their trap opcodes if @p insert is true, to the memory of the
+    /// process that the thread @p tid belongs to.  The sites themselves are
+    /// left alone, so this is for processes that have forked.
+    void
+    WriteBreakpointSiteBytes(lldb::tid_t tid, bool insert);
+
+    /// Disables the enabled software breakpoint sites and returns their IDs
+    /// in @p site_ids.
+    void
+    DisableSoftwareBreakpointSites(std::vector<lldb::break_id_t> &site_ids);
+
     /// Linux-specific signal set.
     LinuxSignals m_linux_signals;
 
@@ -110,6 +188,18 @@ private:
 
     // Flag to avoid recursion when stopping all threads.
     bool m_stopping_threads;
+
+    // Set when the process is being halted, so that all threads are stopped
+    // even in non-stop mode.  Set on the private state thread, and cleared
+    // on the monitor thread once all threads are stopped.
+    lldb_private::Predicate<bool> m_halt_requested;
+
+    // The hardware watchpoints and breakpoints of all threads.
+    DebugRegisterManager m_debug_registers;
+
+    // How many vforked children that were let go share the memory of the
+    // process, with the software breakpoints taken out of it.
+    uint32_t m_num_vfork_children;
 };
 
 #endif  // liblldb_ProcessLinux_H_
@@ -23,6 +23,8 @@
 #include <sys/wait.h>
 
 // C++ Includes
+#include <set>
+
 // Other libraries and framework includes
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Error.h"
@@ -426,7 +428,7 @@ private:
 void
 ReadOperation::Execute(ProcessMonitor *monitor)
 {
-    lldb::pid_t pid = monitor->GetPID();
+    lldb::pid_t pid = monitor->GetMemoryThreadID();
 
     m_result = DoReadMemory(pid, m_addr, m_buff, m_size, m_error);
 }
@@ -456,7 +458,7 @@ private:
 void
 WriteOperation::Execute(ProcessMonitor *monitor)
 {
-    lldb::pid_t pid = monitor->GetPID();
+    lldb::pid_t pid = monitor->GetMemoryThreadID();
 
     m_result = DoWriteMemory(pid, m_addr, m_buff, m_size, m_error);
 }
@@ -712,6 +714,68 @@ WriteRegisterSetOperation::Execute(ProcessMonitor *monitor)
         m_result = true;
 }
 
+//------------------------------------------------------------------------------
+/// @class WriteDebugRegistersOperation
+/// @brief Implements OperationBatch::AddWriteDebugRegisters.
+class WriteDebugRegistersOperation : public Operation
+{
+public:
+    WriteDebugRegistersOperation(lldb::tid_t tid,
+                                 const OperationBatch::UserAreaWrites &writes,
+                                 bool &result)
+        : m_tid(tid), m_writes(writes), m_result(result)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    lldb::tid_t m_tid;
+    const OperationBatch::UserAreaWrites m_writes;
+    bool &m_result;
+};
+
+void
+WriteDebugRegistersOperation::Execute(ProcessMonitor *monitor)
+{
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
+
+    m_result = true;
+    OperationBatch::UserAreaWrites::const_iterator pos, end = m_writes.end();
+    for (pos = m_writes.begin(); pos != end; ++pos)
+    {
+        void *buf = (void *)pos->second;
+        if (log)
+            log->Printf ("ProcessMonitor::%s() tid %" PRIu64 " offset 0x%x: %p",
+                         __FUNCTION__, m_tid, pos->first, buf);
+        if (PTRACE(PTRACE_POKEUSER, m_tid, (void *)(uintptr_t)pos->first, buf, 0))
+            m_result = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @class BatchOperation
+/// @brief Implements ProcessMonitor::DoBatch.
+class BatchOperation : public Operation
+{
+public:
+    BatchOperation(const std::vector<Operation *> &operations)
+        : m_operations(operations)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    const std::vector<Operation *> &m_operations;
+};
+
+void
+BatchOperation::Execute(ProcessMonitor *monitor)
+{
+    std::vector<Operation *>::const_iterator pos, end = m_operations.end();
+    for (pos = m_operations.begin(); pos != end; ++pos)
+        (*pos)->Execute(monitor);
+}
+
 //------------------------------------------------------------------------------
 /// @class ReadThreadPointerOperation
 /// @brief Implements ProcessMonitor::ReadThreadPointer.
@@ -1013,6 +1077,8 @@ ProcessMonitor::ProcessMonitor(ProcessPOSIX *process,
       m_operation_thread(LLDB_INVALID_HOST_THREAD),
       m_monitor_thread(LLDB_INVALID_HOST_THREAD),
       m_pid(LLDB_INVALID_PROCESS_ID),
+      m_group_pid(LLDB_INVALID_PROCESS_ID),
+      m_memory_tid(LLDB_INVALID_THREAD_ID),
       m_terminal_fd(-1),
       m_operation(0)
 {
@@ -1049,8 +1115,9 @@ WAIT_AGAIN:
     }
 
     // Finally, start monitoring the child process for change in state.
+    m_group_pid = GetPID();
     m_monitor_thread = Host::StartMonitoringChildProcess(
-        ProcessMonitor::MonitorCallback, this, GetPID(), true);
+        ProcessMonitor::MonitorCallback, this, m_group_pid, true);
     if (!IS_VALID_LLDB_HOST_THREAD(m_monitor_thread))
     {
         error.SetErrorToGenericError();
@@ -1066,6 +1133,8 @@ ProcessMonitor::ProcessMonitor(ProcessPOSIX *process,
       m_operation_thread(LLDB_INVALID_HOST_THREAD),
       m_monitor_thread(LLDB_INVALID_HOST_THREAD),
       m_pid(LLDB_INVALID_PROCESS_ID),
+      m_group_pid(LLDB_INVALID_PROCESS_ID),
+      m_memory_tid(LLDB_INVALID_THREAD_ID),
       m_terminal_fd(-1),
       m_operation(0)
 {
@@ -1100,8 +1169,9 @@ WAIT_AGAIN:
     }
 
     // Finally, start monitoring the child process for change in state.
+    m_group_pid = GetPID();
     m_monitor_thread = Host::StartMonitoringChildProcess(
-        ProcessMonitor::MonitorCallback, this, GetPID(), true);
+        ProcessMonitor::MonitorCallback, this, m_group_pid, true);
     if (!IS_VALID_LLDB_HOST_THREAD(m_monitor_thread))
     {
         error.SetErrorToGenericError();
@@ -1271,7 +1341,7 @@ ProcessMonitor::Launch(LaunchArgs *args)
     assert(WIFSTOPPED(status) && wpid == pid &&
            "Could not sync with inferior process.");
 
-    if (!SetDefaultPtraceOpts(pid))
+    if (!SetDefaultPtraceOpts(pid, process.GetFollowForkMode() == eFollowForkChild))
     {
         args->m_error.SetErrorToErrno();
         goto FINISH;
@@ -1397,7 +1467,7 @@ ProcessMonitor::Attach(AttachArgs *args)
                     }
                 }
 
-                if (!SetDefaultPtraceOpts(tid))
+                if (!SetDefaultPtraceOpts(tid, process.GetFollowForkMode() == eFollowForkChild))
                 {
                     args->m_error.SetErrorToErrno();
                     goto FINISH;
@@ -1432,7 +1502,7 @@ ProcessMonitor::Attach(AttachArgs *args)
 }
 
 bool
-ProcessMonitor::SetDefaultPtraceOpts(lldb::pid_t pid)
+ProcessMonitor::SetDefaultPtraceOpts(lldb::pid_t pid, bool trace_forks)
 {
     long ptrace_opts = 0;
 
@@ -1441,10 +1511,15 @@ ProcessMonitor::SetDefaultPtraceOpts(lldb::pid_t pid)
     ptrace_opts |= PTRACE_O_TRACEEXIT;
 
     // Have the tracer trace threads which spawn in the inferior process.
-    // TODO: if we want to support tracing the inferiors' child, add the
-    // appropriate ptrace flags here (PTRACE_O_TRACEFORK, PTRACE_O_TRACEVFORK)
     ptrace_opts |= PTRACE_O_TRACECLONE;
 
+    // Have the tracer trace the inferior's children when they are to be
+    // followed, so that the breakpoints can be taken out of the parent
+    // before it is let go (see ProcessLinux::FollowFork).  Otherwise forks,
+    // including the ones posix_spawn() and system() do, don't stop anything.
+    if (trace_forks)
+        ptrace_opts |= PTRACE_O_TRACEFORK | PTRACE_O_TRACEVFORK | PTRACE_O_TRACEVFORKDONE;
+
     // Have the tracer notify us before execve returns
     // (needed to disable legacy SIGTRAP generation)
     ptrace_opts |= PTRACE_O_TRACEEXEC;
@@ -1473,6 +1548,10 @@ ProcessMonitor::MonitorCallback(void *callback_baton,
     {
         if (log)
             log->Printf ("ProcessMonitor::%s() got exit signal, tid = %"  PRIu64, __FUNCTION__, pid);
+        // A process that forked the one we followed is still our child, but
+        // we aren't debugging it any more.
+        if (pid != process->GetID() && !process->GetThreadList().FindThreadByID(pid, false))
+            return false;
         message = ProcessMessage::Exit(pid, status);
         process->SendMessage(message);
         return pid == process->GetID();
@@ -1539,10 +1618,31 @@ ProcessMonitor::MonitorSIGTRAP(ProcessMonitor *monitor,
         assert(false && "Unexpected SIGTRAP code!");
         break;
 
-    // TODO: these two cases are required if we want to support tracing
-    // of the inferiors' children
-    // case (SIGTRAP | (PTRACE_EVENT_FORK << 8)):
-    // case (SIGTRAP | (PTRACE_EVENT_VFORK << 8)):
+    case (SIGTRAP | (PTRACE_EVENT_FORK << 8)):
+    case (SIGTRAP | (PTRACE_EVENT_VFORK << 8)):
+    {
+        if (log)
+            log->Printf ("ProcessMonitor::%s() received fork event, code = %d", __FUNCTION__, info->si_code ^ SIGTRAP);
+
+        unsigned long child_pid = 0;
+        if (!monitor->GetEventMessage(pid, &child_pid))
+        {
+            // Without the child there is nothing to follow.
+            monitor->Resume(pid, eResumeSignalNone);
+            break;
+        }
+        if (info->si_code == (SIGTRAP | (PTRACE_EVENT_VFORK << 8)))
+            message = ProcessMessage::VFork(pid, child_pid);
+        else
+            message = ProcessMessage::Fork(pid, child_pid);
+        break;
+    }
+
+    case (SIGTRAP | (PTRACE_EVENT_VFORK_DONE << 8)):
+        if (log)
+            log->Printf ("ProcessMonitor::%s() received vfork done event, pid = %" PRIu64, __FUNCTION__, pid);
+        message = ProcessMessage::VForkDone(pid);
+        break;
 
     case (SIGTRAP | (PTRACE_EVENT_CLONE << 8)):
     {
@@ -1749,25 +1849,52 @@ ProcessMonitor::WaitForInitialTIDStop(lldb::tid_t tid)
 bool
 ProcessMonitor::StopThread(lldb::tid_t tid)
 {
-    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+    std::vector<lldb::tid_t> tids(1, tid);
+    return StopThreads(tids);
+}
 
-    // FIXME: Try to use tgkill or tkill
+bool
+ProcessMonitor::InterruptThread(lldb::tid_t tid)
+{
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
     int ret = tgkill(m_pid, tid, SIGSTOP);
     if (log)
-        log->Printf ("ProcessMonitor::%s(bp) stopping thread, tid = %" PRIu64 ", ret = %d", __FUNCTION__, tid, ret);
+        log->Printf ("ProcessMonitor::%s() interrupting thread, tid = %" PRIu64 ", ret = %d", __FUNCTION__, tid, ret);
+    return ret == 0;
+}
+
+bool
+ProcessMonitor::StopThreads(const std::vector<lldb::tid_t> &tids)
+{
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
 
-    // This can happen if a thread exited while we were trying to stop it.  That's OK.
-    // We'll get the signal for that later.
-    if (ret < 0)
+    // Signal all the threads first so they stop concurrently, then collect
+    // the stops in whatever order they arrive.
+    std::set<lldb::tid_t> pending;
+    std::vector<lldb::tid_t>::const_iterator pos, end = tids.end();
+    for (pos = tids.begin(); pos != end; ++pos)
+    {
+        const lldb::tid_t tid = *pos;
+        int ret = tgkill(m_pid, tid, SIGSTOP);
+        if (log)
+            log->Printf ("ProcessMonitor::%s(bp) stopping thread, tid = %" PRIu64 ", ret = %d", __FUNCTION__, tid, ret);
+
+        // This can happen if a thread exited while we were trying to stop it.
+        // That's OK.  We'll get the signal for that later.
+        if (ret == 0)
+            pending.insert(tid);
+    }
+
+    if (pending.empty())
         return false;
 
-    // Wait for the thread to stop
-    while (true)
+    // Wait for the threads to stop
+    while (!pending.empty())
     {
         int status = -1;
         if (log)
             log->Printf ("ProcessMonitor::%s(bp) waitpid...", __FUNCTION__);
-        lldb::pid_t wait_pid = ::waitpid (-1*m_pid, &status, __WALL);
+        lldb::pid_t wait_pid = ::waitpid (-1*m_group_pid, &status, __WALL);
         if (log)
             log->Printf ("ProcessMonitor::%s(bp) waitpid, pid = %" PRIu64 ", status = %d", __FUNCTION__, wait_pid, status);
 
@@ -1785,8 +1912,7 @@ ProcessMonitor::StopThread(lldb::tid_t tid)
         if (WIFEXITED(status))
         {
             m_process->SendMessage(ProcessMessage::Exit(wait_pid, WEXITSTATUS(status)));
-            if (wait_pid == tid)
-                return true;
+            pending.erase(wait_pid);
             continue;
         }
 
@@ -1854,11 +1980,10 @@ ProcessMonitor::StopThread(lldb::tid_t tid)
                     log->Printf ("ProcessMonitor::%s(bp) handling message", __FUNCTION__);
                 // SendMessage will set the thread state as needed.
                 m_process->SendMessage(message);
-                // If this is the thread we're waiting for, stop waiting. Even
-                // though this wasn't the signal we expected, it's the last
-                // signal we'll see while this thread is alive.
-                if (wait_pid == tid)
-                    return true;
+                // If this is a thread we're waiting for, stop waiting for it.
+                // Even though this wasn't the signal we expected, it's the
+                // last signal we'll see while this thread is alive.
+                pending.erase(wait_pid);
                 break;
 
             case ProcessMessage::eSignalMessage:
@@ -1866,7 +1991,7 @@ ProcessMonitor::StopThread(lldb::tid_t tid)
                     log->Printf ("ProcessMonitor::%s(bp) handling message", __FUNCTION__);
                 if (WSTOPSIG(status) == SIGSTOP)
                 {
-                    m_process->AddThreadForInitialStopIfNeeded(tid);
+                    m_process->AddThreadForInitialStopIfNeeded(wait_pid);
                     thread->SetState(lldb::eStateStopped);
                 }
                 else
@@ -1877,19 +2002,20 @@ ProcessMonitor::StopThread(lldb::tid_t tid)
                     // but we need to resume here to get the stop we are waiting
                     // for (otherwise the thread will stop again immediately when
                     // we try to resume).
-                    if (wait_pid == tid)
+                    if (pending.count(wait_pid))
                         Resume(wait_pid, eResumeSignalNone);
                 }
                 break;
 
             case ProcessMessage::eSignalDeliveredMessage:
                 // This is the stop we're expecting.
-                if (wait_pid == tid && WIFSTOPPED(status) && WSTOPSIG(status) == SIGSTOP && info.si_code == SI_TKILL)
+                if (pending.count(wait_pid) && WIFSTOPPED(status) && WSTOPSIG(status) == SIGSTOP && info.si_code == SI_TKILL)
                 {
                     if (log)
-                        log->Printf ("ProcessMonitor::%s(bp) received signal, done waiting", __FUNCTION__);
+                        log->Printf ("ProcessMonitor::%s(bp) received signal, done waiting for tid %" PRIu64, __FUNCTION__, wait_pid);
                     thread->SetState(lldb::eStateStopped);
-                    return true;
+                    pending.erase(wait_pid);
+                    break;
                 }
                 // else fall-through
             case ProcessMessage::eBreakpointMessage:
@@ -1897,6 +2023,9 @@ ProcessMonitor::StopThread(lldb::tid_t tid)
             case ProcessMessage::eWatchpointMessage:
             case ProcessMessage::eCrashMessage:
             case ProcessMessage::eNewThreadMessage:
+            case ProcessMessage::eForkMessage:
+            case ProcessMessage::eVForkMessage:
+            case ProcessMessage::eVForkDoneMessage:
                 if (log)
                     log->Printf ("ProcessMonitor::%s(bp) handling message", __FUNCTION__);
                 // SendMessage will set the thread state as needed.
@@ -1906,12 +2035,12 @@ ProcessMonitor::StopThread(lldb::tid_t tid)
                 // but we need to resume here to get the stop we are waiting
                 // for (otherwise the thread will stop again immediately when
                 // we try to resume).
-                if (wait_pid == tid)
+                if (pending.count(wait_pid))
                     Resume(wait_pid, eResumeSignalNone);
                 break;
         }
     }
-    return false;
+    return true;
 }
 
 ProcessMessage::CrashReason
@@ -2055,6 +2184,82 @@ ProcessMonitor::GetCrashReasonForSIGBUS(const siginfo_t *info)
     return reason;
 }
 
+OperationBatch::OperationBatch()
+    : m_operations()
+{
+}
+
+OperationBatch::~OperationBatch()
+{
+    Clear();
+}
+
+void
+OperationBatch::Clear()
+{
+    std::vector<Operation *>::iterator pos, end = m_operations.end();
+    for (pos = m_operations.begin(); pos != end; ++pos)
+        delete *pos;
+    m_operations.clear();
+}
+
+void
+OperationBatch::AddReadGPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result)
+{
+    m_operations.push_back(new ReadGPROperation(tid, buf, buf_size, result));
+}
+
+void
+OperationBatch::AddReadFPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result)
+{
+    m_operations.push_back(new ReadFPROperation(tid, buf, buf_size, result));
+}
+
+void
+OperationBatch::AddWriteGPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result)
+{
+    m_operations.push_back(new WriteGPROperation(tid, buf, buf_size, result));
+}
+
+void
+OperationBatch::AddWriteFPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result)
+{
+    m_operations.push_back(new WriteFPROperation(tid, buf, buf_size, result));
+}
+
+void
+OperationBatch::AddWriteRegisterSet(lldb::tid_t tid, void *buf, size_t buf_size,
+                                    unsigned int regset, bool &result)
+{
+    m_operations.push_back(new WriteRegisterSetOperation(tid, buf, buf_size, regset, result));
+}
+
+void
+OperationBatch::AddWriteDebugRegisters(lldb::tid_t tid, const UserAreaWrites &writes,
+                                       bool &result)
+{
+    m_operations.push_back(new WriteDebugRegistersOperation(tid, writes, result));
+}
+
+void
+OperationBatch::AddResume(lldb::tid_t tid, uint32_t signo, bool &result)
+{
+    m_operations.push_back(new ResumeOperation(tid, signo, result));
+}
+
+void
+OperationBatch::AddSingleStep(lldb::tid_t tid, uint32_t signo, bool &result)
+{
+    m_operations.push_back(new SingleStepOperation(tid, signo, result));
+}
+
+void
+OperationBatch::AddReadRegisterSet(lldb::tid_t tid, void *buf, size_t buf_size,
+                                   unsigned int regset, bool &result)
+{
+    m_operations.push_back(new ReadRegisterSetOperation(tid, buf, buf_size, regset, result));
+}
+
 void
 ProcessMonitor::ServeOperation(OperationArgs *args)
 {
@@ -2194,6 +2399,21 @@ ProcessMonitor::WriteRegisterSet(lldb::tid_t tid, void *buf, size_t buf_size, un
     return result;
 }
 
+void
+ProcessMonitor::DoBatch(OperationBatch &batch)
+{
+    if (batch.IsEmpty())
+        return;
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+    if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
+        log->Printf ("ProcessMonitor::%s() executing %" PRIu64 " operations", __FUNCTION__, (uint64_t)batch.GetSize());
+
+    BatchOperation op(batch.m_operations);
+    DoOperation(&op);
+    batch.Clear();
+}
+
 bool
 ProcessMonitor::ReadThreadPointer(lldb::tid_t tid, lldb::addr_t &value)
 {
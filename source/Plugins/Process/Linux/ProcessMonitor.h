@@ -15,7 +15,11 @@
 #include <signal.h>
 
 // C++ Includes
+#include <utility>
+#include <vector>
+
 // Other libraries and framework includes
+#include "lldb/lldb-defines.h"
 #include "lldb/lldb-types.h"
 #include "lldb/Host/Mutex.h"
 
@@ -29,6 +33,86 @@ class Scalar;
 class ProcessLinux;
 class Operation;
 
+/// @class OperationBatch
+/// @brief A list of operations to be done in a single trip to the operation
+/// thread.
+///
+/// Every ProcessMonitor operation is handed to the thread that is allowed to
+/// ptrace the inferior, and the caller waits for it to finish.  That handoff
+/// costs more than most of the ptrace calls, so reads of the same state from
+/// many threads (the registers of all threads after a stop, for example), and
+/// the requests to write back changed registers and resume all threads, are
+/// queued here and run with ProcessMonitor::DoBatch.  The results are stored
+/// through the references passed to the Add* methods once DoBatch returns.
+class OperationBatch
+{
+public:
+    /// Pairs of a user area offset and the value to write there.
+    typedef std::vector<std::pair<unsigned, uint64_t> > UserAreaWrites;
+
+    OperationBatch();
+
+    ~OperationBatch();
+
+    /// Queues ProcessMonitor::ReadGPR.
+    void
+    AddReadGPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result);
+
+    /// Queues ProcessMonitor::ReadFPR.
+    void
+    AddReadFPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result);
+
+    /// Queues ProcessMonitor::ReadRegisterSet.
+    void
+    AddReadRegisterSet(lldb::tid_t tid, void *buf, size_t buf_size,
+                       unsigned int regset, bool &result);
+
+    /// Queues ProcessMonitor::WriteGPR.
+    void
+    AddWriteGPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result);
+
+    /// Queues ProcessMonitor::WriteFPR.
+    void
+    AddWriteFPR(lldb::tid_t tid, void *buf, size_t buf_size, bool &result);
+
+    /// Queues ProcessMonitor::WriteRegisterSet.
+    void
+    AddWriteRegisterSet(lldb::tid_t tid, void *buf, size_t buf_size,
+                        unsigned int regset, bool &result);
+
+    /// Queues writes of the debug registers of thread @p tid.  The values in
+    /// @p writes are written in order, and @p result is set to false if any
+    /// of them couldn't be.
+    void
+    AddWriteDebugRegisters(lldb::tid_t tid, const UserAreaWrites &writes,
+                           bool &result);
+
+    /// Queues ProcessMonitor::Resume.
+    void
+    AddResume(lldb::tid_t tid, uint32_t signo, bool &result);
+
+    /// Queues ProcessMonitor::SingleStep.
+    void
+    AddSingleStep(lldb::tid_t tid, uint32_t signo, bool &result);
+
+    size_t
+    GetSize() const { return m_operations.size(); }
+
+    bool
+    IsEmpty() const { return m_operations.empty(); }
+
+    void
+    Clear();
+
+private:
+    friend class ProcessMonitor;
+
+    std::vector<Operation *> m_operations;
+
+    OperationBatch(const OperationBatch &);
+    const OperationBatch &operator=(const OperationBatch &);
+};
+
 /// @class ProcessMonitor
 /// @brief Manages communication with the inferior (debugee) process.
 ///
@@ -72,10 +156,39 @@ public:
     lldb::pid_t
     GetPID() const { return m_pid; }
 
+    /// Provides the process group whose members are waited on.
+    lldb::pid_t
+    GetGroupPID() const { return m_group_pid; }
+
+    /// Debugs @p pid, a child that the process forked, from now on instead
+    /// of the process.  The child has to be in the process group that is
+    /// waited on, so its events come in the same way.  Its events are lost
+    /// if it leaves the group.
+    void
+    FollowChild(lldb::pid_t pid)
+    {
+        m_pid = pid;
+        m_memory_tid = LLDB_INVALID_THREAD_ID;
+    }
+
     /// Returns the process associated with this ProcessMonitor.
     ProcessLinux &
     GetProcess() { return *m_process; }
 
+    /// Provides the thread that memory is read and written through.  ptrace
+    /// only works on stopped threads, so in non-stop mode this has to be a
+    /// thread that is stopped rather than the main thread.
+    lldb::tid_t
+    GetMemoryThreadID() const
+    {
+        return m_memory_tid != LLDB_INVALID_THREAD_ID ? m_memory_tid : m_pid;
+    }
+
+    /// Sets the thread that memory is read and written through, or
+    /// LLDB_INVALID_THREAD_ID to use the main thread.
+    void
+    SetMemoryThreadID(lldb::tid_t tid) { m_memory_tid = tid; }
+
     /// Returns a file descriptor to the controlling terminal of the inferior
     /// process.
     ///
@@ -147,6 +260,11 @@ public:
     bool
     WriteRegisterSet(lldb::tid_t tid, void *buf, size_t buf_size, unsigned int regset);
 
+    /// Runs all the operations in @p batch in order on the operation thread,
+    /// and then empties it.
+    void
+    DoBatch(OperationBatch &batch);
+
     /// Reads the value of the thread-specific pointer for a given thread ID.
     bool
     ReadThreadPointer(lldb::tid_t tid, lldb::addr_t &value);
@@ -189,6 +307,20 @@ public:
     bool
     StopThread(lldb::tid_t tid);
 
+    /// Sends a SIGSTOP to the requested thread without waiting for it to
+    /// stop.  The monitor thread handles the stop like any other.  Unlike
+    /// StopThread, this can be called on any thread.
+    bool
+    InterruptThread(lldb::tid_t tid);
+
+    /// Stops the requested threads and waits for their stop signals.  All
+    /// the threads are signalled before any stop is waited for, and stops of
+    /// other threads that are reported in the meantime are handled as in
+    /// StopThread.  Returns false if no thread could be signalled or waiting
+    /// failed.
+    bool
+    StopThreads(const std::vector<lldb::tid_t> &tids);
+
     // Waits for the initial stop message from a new thread.
     bool
     WaitForInitialTIDStop(lldb::tid_t tid);
@@ -199,6 +331,9 @@ private:
     lldb::thread_t m_operation_thread;
     lldb::thread_t m_monitor_thread;
     lldb::pid_t m_pid;
+    lldb::pid_t m_group_pid;    // The process group waited on, that of the
+                                // process the monitor was started for.
+    lldb::tid_t m_memory_tid;
     int m_terminal_fd;
 
     // current operation which must be executed on the priviliged thread
@@ -277,7 +412,7 @@ private:
     Attach(AttachArgs *args);
 
     static bool
-    SetDefaultPtraceOpts(const lldb::pid_t);
+    SetDefaultPtraceOpts(const lldb::pid_t, bool trace_forks);
 
     static void
     ServeOperation(OperationArgs *args);
@@ -87,3 +87,41 @@ POSIXNewThreadStopInfo::ShouldNotify(Event *event_ptr)
 {
     return false;
 }
+
+//===----------------------------------------------------------------------===//
+// POSIXForkStopInfo
+
+POSIXForkStopInfo::~POSIXForkStopInfo() { }
+
+lldb::StopReason
+POSIXForkStopInfo::GetStopReason() const
+{
+    // The child's thread stops as if the step had ended there.
+    return m_stop_in_child ? lldb::eStopReasonTrace : lldb::eStopReasonNone;
+}
+
+const char *
+POSIXForkStopInfo::GetDescription()
+{
+    switch (m_kind)
+    {
+    case ProcessMessage::eVForkMessage:
+        return m_stop_in_child ? "process vforked, stopped in the child" : "process vforked";
+    case ProcessMessage::eVForkDoneMessage:
+        return "vforked child done";
+    default:
+        return m_stop_in_child ? "process forked, stopped in the child" : "process forked";
+    }
+}
+
+bool
+POSIXForkStopInfo::ShouldStop(Event *event_ptr)
+{
+    return m_stop_in_child;
+}
+
+bool
+POSIXForkStopInfo::ShouldNotify(Event *event_ptr)
+{
+    return m_stop_in_child;
+}
@@ -117,4 +117,43 @@ public:
     ShouldNotify(lldb_private::Event *event_ptr);
 };
 
+//===----------------------------------------------------------------------===//
+/// @class POSIXForkStopInfo
+/// @brief Represents the stop state of process when it forks or vforks, or
+/// when a vforked child stops sharing its memory.
+///
+/// These stops are not reported, except when a thread that was stepping
+/// forked and the child was followed.  The plans of the thread can't go
+/// with it into the child, so the child's thread stops where it was forked.
+///
+class POSIXForkStopInfo
+    : public POSIXStopInfo
+{
+public:
+    POSIXForkStopInfo (POSIXThread &thread, ProcessMessage::Kind kind,
+                       bool stop_in_child = false)
+        : POSIXStopInfo (thread, 0),
+          m_kind (kind),
+          m_stop_in_child (stop_in_child)
+        { }
+
+    ~POSIXForkStopInfo();
+
+    lldb::StopReason
+    GetStopReason() const;
+
+    const char *
+    GetDescription();
+
+    bool
+    ShouldStop(lldb_private::Event *event_ptr);
+
+    bool
+    ShouldNotify(lldb_private::Event *event_ptr);
+
+private:
+    ProcessMessage::Kind m_kind;
+    bool m_stop_in_child;
+};
+
 #endif
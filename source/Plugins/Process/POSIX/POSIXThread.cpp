@@ -274,6 +274,12 @@ POSIXThread::CalculateStopInfo()
     return true;
 }
 
+bool
+POSIXThread::KnownToHaveNoStopReason()
+{
+    return !m_stop_info_sp;
+}
+
 Unwind *
 POSIXThread::GetUnwinder()
 {
@@ -301,6 +307,19 @@ POSIXThread::DidStop()
     // Don't set the thread state to stopped unless we really stopped.
 }
 
+void
+POSIXThread::FlushRegisters()
+{
+    // Register writes may be cached until the thread runs, and the registers
+    // that were read are stale once it does.
+    if (!m_reg_context_sp)
+        return;
+    POSIXBreakpointProtocol *reg_ctx = GetPOSIXBreakpointProtocol();
+    if (reg_ctx)
+        reg_ctx->FlushRegisters();
+    m_reg_context_sp->InvalidateAllRegisters();
+}
+
 bool
 POSIXThread::Resume()
 {
@@ -322,11 +341,13 @@ POSIXThread::Resume()
 
     case lldb::eStateRunning:
         SetState(resume_state);
+        FlushRegisters();
         status = monitor.Resume(GetID(), GetResumeSignal());
         break;
 
     case lldb::eStateStepping:
         SetState(resume_state);
+        FlushRegisters();
         status = monitor.SingleStep(GetID(), GetResumeSignal());
         break;
     case lldb::eStateStopped:
@@ -391,6 +412,12 @@ POSIXThread::Notify(const ProcessMessage &message)
     case ProcessMessage::eExecMessage:
         ExecNotify(message);
         break;
+
+    case ProcessMessage::eForkMessage:
+    case ProcessMessage::eVForkMessage:
+    case ProcessMessage::eVForkDoneMessage:
+        ForkNotify(message);
+        break;
     }
 }
 
@@ -474,7 +501,12 @@ POSIXThread::BreakNotify(const ProcessMessage &message)
     if (log)
         log->Printf ("POSIXThread::%s () PC=0x%8.8" PRIx64, __FUNCTION__, pc);
     lldb::BreakpointSiteSP bp_site(GetProcess()->GetBreakpointSiteList().FindByAddress(pc));
+    SetBreakpointStopInfo(bp_site);
+}
 
+void
+POSIXThread::SetBreakpointStopInfo(const lldb::BreakpointSiteSP &bp_site)
+{
     // If the breakpoint is for this thread, then we'll report the hit, but if it is for another thread,
     // we create a stop reason with should_stop=false.  If there is no breakpoint location, then report
     // an invalid stop reason. We don't need to worry about stepping over the breakpoint here, that will
@@ -524,6 +556,19 @@ POSIXThread::WatchNotify(const ProcessMessage &message)
 
         Target &target = GetProcess()->GetTarget();
         lldb::addr_t wp_monitor_addr = reg_ctx->GetWatchpointAddress(wp_idx);
+
+        // Hardware breakpoints use the same registers, and stop the thread
+        // before the instruction at the breakpoint runs.
+        lldb::BreakpointSiteSP bp_site(GetProcess()->GetBreakpointSiteList().FindByAddress(wp_monitor_addr));
+        if (bp_site && bp_site->IsHardware() && GetRegisterContext()->GetPC() == wp_monitor_addr)
+        {
+            if (log)
+                log->Printf ("POSIXThread::%s () Hardware Breakpoint Address = 0x%8.8"
+                             PRIx64, __FUNCTION__, wp_monitor_addr);
+            SetBreakpointStopInfo(bp_site);
+            return;
+        }
+
         const WatchpointList &wp_list = target.GetWatchpointList();
         lldb::WatchpointSP wp_sp = wp_list.FindByAddress(wp_monitor_addr);
 
@@ -603,6 +648,14 @@ POSIXThread::ThreadNotify(const ProcessMessage &message)
     SetStopInfo (lldb::StopInfoSP(new POSIXNewThreadStopInfo(*this)));
 }
 
+void
+POSIXThread::ForkNotify(const ProcessMessage &message)
+{
+    // The process plug-in follows the fork once all the threads know why
+    // they stopped.
+    SetStopInfo (lldb::StopInfoSP(new POSIXForkStopInfo(*this, message.GetKind())));
+}
+
 unsigned
 POSIXThread::GetRegisterIndexFromOffset(unsigned offset)
 {
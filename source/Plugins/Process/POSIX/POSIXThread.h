@@ -83,6 +83,10 @@ public:
 
     void Notify(const ProcessMessage &message);
 
+    // Writes the registers that were changed while the thread was stopped,
+    // and forgets the cached ones.  Called before the thread runs.
+    void FlushRegisters();
+
     //--------------------------------------------------------------------------
     // These methods provide an interface to watchpoints
     //
@@ -117,7 +121,13 @@ protected:
     virtual bool
     CalculateStopInfo();
 
+    /// The stop reasons are set when the process hands the thread its
+    /// messages (see Notify()), so a thread that didn't get one has none.
+    virtual bool
+    KnownToHaveNoStopReason();
+
     void BreakNotify(const ProcessMessage &message);
+    void SetBreakpointStopInfo(const lldb::BreakpointSiteSP &bp_site);
     void WatchNotify(const ProcessMessage &message);
     virtual void TraceNotify(const ProcessMessage &message);
     void LimboNotify(const ProcessMessage &message);
@@ -127,6 +137,7 @@ protected:
     void ThreadNotify(const ProcessMessage &message);
     void ExitNotify(const ProcessMessage &message);
     void ExecNotify(const ProcessMessage &message);
+    void ForkNotify(const ProcessMessage &message);
 
     lldb_private::Unwind *
     GetUnwinder();
@@ -251,6 +251,15 @@ ProcessMessage::PrintKind(Kind kind)
     case eExecMessage:
         str = "eExecMessage";
         break;
+    case eForkMessage:
+        str = "eForkMessage";
+        break;
+    case eVForkMessage:
+        str = "eVForkMessage";
+        break;
+    case eVForkDoneMessage:
+        str = "eVForkDoneMessage";
+        break;
     }
 #endif
 
@@ -33,7 +33,10 @@ public:
         eWatchpointMessage,
         eCrashMessage,
         eNewThreadMessage,
-        eExecMessage
+        eExecMessage,
+        eForkMessage,
+        eVForkMessage,
+        eVForkDoneMessage
     };
 
     enum CrashReason
@@ -139,6 +142,23 @@ public:
         return ProcessMessage(tid, eExecMessage);
     }
 
+    /// Indicates that the thread @p tid forked the process @p child_pid.
+    static ProcessMessage Fork(lldb::tid_t tid, lldb::pid_t child_pid) {
+        return ProcessMessage(tid, eForkMessage, child_pid);
+    }
+
+    /// Indicates that the thread @p tid vforked the process @p child_pid,
+    /// which shares its memory until it execs or exits.
+    static ProcessMessage VFork(lldb::tid_t tid, lldb::pid_t child_pid) {
+        return ProcessMessage(tid, eVForkMessage, child_pid);
+    }
+
+    /// Indicates that the child the thread @p tid vforked no longer shares
+    /// its memory.
+    static ProcessMessage VForkDone(lldb::tid_t tid) {
+        return ProcessMessage(tid, eVForkDoneMessage);
+    }
+
     int GetExitStatus() const {
         assert(GetKind() == eExitMessage || GetKind() == eLimboMessage);
         return m_status;
@@ -171,7 +191,8 @@ public:
     }
 
     lldb::tid_t GetChildTID() const {
-        assert(GetKind() == eNewThreadMessage);
+        assert(GetKind() == eNewThreadMessage || GetKind() == eForkMessage ||
+               GetKind() == eVForkMessage);
         return m_child_tid;
     }
 
@@ -471,6 +471,24 @@ ProcessPOSIX::SendMessage(const ProcessMessage &message)
         SetPrivateState(eStateStopped);
         break;
     }
+
+    case ProcessMessage::eForkMessage:
+    case ProcessMessage::eVForkMessage:
+    {
+        // The child starts out stopped like a new thread.  Wait for that,
+        // so that it can be followed or let go when the stop is handled.
+        lldb::pid_t child_pid = message.GetChildTID();
+        if (WaitingForInitialStop(child_pid))
+            m_monitor->WaitForInitialTIDStop(child_pid);
+        // Intentional fall-through
+    }
+
+    case ProcessMessage::eVForkDoneMessage:
+        assert(thread);
+        thread->SetState(eStateStopped);
+        StopAllThreads(message.GetTID());
+        SetPrivateState(eStateStopped);
+        break;
     }
 
 
@@ -517,6 +535,12 @@ ProcessPOSIX::RefreshStateAfterStop()
 
     Mutex::Locker lock(m_message_mutex);
 
+    // Refresh the threads once for the stop rather than once per message;
+    // with many threads stopping together that is quadratic.  Threads added
+    // by the messages below are refreshed as they are created.
+    if (!m_message_queue.empty())
+        m_thread_list.RefreshStateAfterStop();
+
     // This method used to only handle one message.  Changing it to loop allows
     // it to handle the case where we hit a breakpoint while handling a different
     // breakpoint.
@@ -540,10 +564,9 @@ ProcessPOSIX::RefreshStateAfterStop()
             Mutex::Locker lock(m_thread_list.GetMutex());
 
             m_thread_list.AddThread(thread_sp);
+            thread_sp->RefreshStateAfterStop();
         }
 
-        m_thread_list.RefreshStateAfterStop();
-
         POSIXThread *thread = static_cast<POSIXThread*>(
             GetThreadList().FindThreadByID(tid, false).get());
         if (thread)
@@ -70,6 +70,16 @@ public:
     void
     ForceWatchpointsInitialized () {m_watchpoints_initialized = true;}
 
+    /// Writes register values that were changed but not written to the
+    /// thread yet.  This must be done before the thread runs.  The default
+    /// implementation does nothing, for register contexts that write each
+    /// register right away.
+    ///
+    /// @return
+    ///    True if the operation succeeded and false otherwise.
+    virtual bool
+    FlushRegisters () { return true; }
+
 protected:
     bool m_watchpoints_initialized;
 };
@@ -13,6 +13,9 @@
 #include "ProcessPOSIX.h"
 #include "RegisterContextPOSIXProcessMonitor_x86.h"
 #include "ProcessMonitor.h"
+#if defined(__linux__)
+#include "DebugRegisterManager.h"
+#endif
 
 using namespace lldb_private;
 using namespace lldb;
@@ -54,8 +57,167 @@ size_and_rw_bits(size_t size, bool read, bool write)
 RegisterContextPOSIXProcessMonitor_x86_64::RegisterContextPOSIXProcessMonitor_x86_64(Thread &thread,
                                                                                      uint32_t concrete_frame_idx,
                                                                                      RegisterInfoInterface *register_info)
-    : RegisterContextPOSIX_x86(thread, concrete_frame_idx, register_info)
+    : RegisterContextPOSIX_x86(thread, concrete_frame_idx, register_info),
+      m_gpr_valid(false),
+      m_fpr_valid(false),
+      m_gpr_dirty(false),
+      m_fpr_dirty(false),
+      m_gpr_flushed(true),
+      m_fpr_flushed(true),
+      m_dr_control(0),
+      m_dr_flushed(true),
+      m_dr_unknown(false)
+{
+    for (uint32_t i = 0; i < sizeof(m_dr_addresses) / sizeof(m_dr_addresses[0]); ++i)
+        m_dr_addresses[i] = 0;
+}
+
+void
+RegisterContextPOSIXProcessMonitor_x86_64::InvalidateAllRegisters()
+{
+    // Don't lose register writes that haven't reached the thread yet.
+    FlushRegisters();
+    m_gpr_valid = false;
+    m_fpr_valid = false;
+}
+
+bool
+RegisterContextPOSIXProcessMonitor_x86_64::FlushRegisters()
 {
+    bool success = true;
+    if (m_gpr_dirty)
+        success = WriteGPR();
+    if (m_fpr_dirty)
+        success = WriteFPR() && success;
+    return success;
+}
+
+#if defined(__linux__)
+void
+RegisterContextPOSIXProcessMonitor_x86_64::AddRegisterReads(OperationBatch &batch)
+{
+    const lldb::tid_t tid = m_thread.GetID();
+    if (!m_gpr_valid)
+        batch.AddReadGPR(tid, &m_gpr_x86_64, GetGPRSize(), m_gpr_valid);
+
+    // Finding out the FPR type reads the FPRs the first time.
+    const FPRType fpr_type = GetFPRType();
+    if (!m_fpr_valid)
+    {
+        if (fpr_type == eFXSAVE)
+            batch.AddReadFPR(tid, &m_fpr.xstate.fxsave, sizeof(m_fpr.xstate.fxsave), m_fpr_valid);
+        else if (fpr_type == eXSAVE)
+            batch.AddReadRegisterSet(tid, &m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE, m_fpr_valid);
+    }
+}
+
+void
+RegisterContextPOSIXProcessMonitor_x86_64::AddRegisterWrites(OperationBatch &batch)
+{
+    const lldb::tid_t tid = m_thread.GetID();
+    if (m_gpr_dirty)
+    {
+        batch.AddWriteGPR(tid, &m_gpr_x86_64, GetGPRSize(), m_gpr_flushed);
+        m_gpr_dirty = false;
+    }
+    if (m_fpr_dirty)
+    {
+        if (GetFPRType() == eFXSAVE)
+            batch.AddWriteFPR(tid, &m_fpr.xstate.fxsave, sizeof(m_fpr.xstate.fxsave), m_fpr_flushed);
+        else if (GetFPRType() == eXSAVE)
+            batch.AddWriteRegisterSet(tid, &m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE, m_fpr_flushed);
+        m_fpr_dirty = false;
+    }
+}
+
+void
+RegisterContextPOSIXProcessMonitor_x86_64::AddDebugRegisterWrites(OperationBatch &batch,
+                                                                  const DebugRegisterManager &manager)
+{
+    const uint64_t control = manager.GetControlRegister();
+    uint64_t changed_mask = 0;
+    OperationBatch::UserAreaWrites writes;
+
+    // The kernel checks each address against the type and length dr7 gives
+    // its register, so disable the registers that change before setting
+    // their new addresses, and enable them again last.
+    for (uint32_t slot = 0; slot < manager.GetNumSlots(); ++slot)
+    {
+        const uint64_t slot_mask = DebugRegisterManager::GetSlotControlMask(slot);
+        const bool enabled = (control & slot_mask) != 0;
+        if ((control & slot_mask) != (m_dr_control & slot_mask) ||
+            (enabled && manager.GetAddressRegister(slot) != m_dr_addresses[slot]))
+            changed_mask |= slot_mask;
+    }
+    if (changed_mask == 0 && !m_dr_unknown)
+        return;
+
+    if (m_dr_unknown || (m_dr_control & changed_mask))
+    {
+        m_dr_control &= ~changed_mask;
+        writes.push_back(std::make_pair(GetRegisterOffset(m_reg_info.first_dr + 7), m_dr_control));
+    }
+    for (uint32_t slot = 0; slot < manager.GetNumSlots(); ++slot)
+    {
+        const uint64_t address = manager.GetAddressRegister(slot);
+        if ((control & DebugRegisterManager::GetSlotControlMask(slot) & changed_mask) &&
+            address != m_dr_addresses[slot])
+        {
+            m_dr_addresses[slot] = address;
+            writes.push_back(std::make_pair(GetRegisterOffset(m_reg_info.first_dr + slot), address));
+        }
+    }
+    if (control != m_dr_control)
+    {
+        m_dr_control = control;
+        writes.push_back(std::make_pair(GetRegisterOffset(m_reg_info.first_dr + 7), control));
+    }
+
+    batch.AddWriteDebugRegisters(m_thread.GetID(), writes, m_dr_flushed);
+    m_dr_unknown = false;
+
+    // dr7 is set up now, so it must not be cleared when it is first looked
+    // at.
+    ForceWatchpointsInitialized();
+}
+
+bool
+RegisterContextPOSIXProcessMonitor_x86_64::CheckRegisterWrites()
+{
+    const bool success = m_gpr_flushed && m_fpr_flushed;
+    // The cached registers no longer match the thread's.
+    if (!m_gpr_flushed)
+        m_gpr_valid = false;
+    if (!m_fpr_flushed)
+        m_fpr_valid = false;
+    m_gpr_flushed = true;
+    m_fpr_flushed = true;
+    return success;
+}
+
+bool
+RegisterContextPOSIXProcessMonitor_x86_64::CheckDebugRegisterWrites()
+{
+    if (m_dr_flushed)
+        return true;
+
+    // Some of the writes may have made it, so forget what was written and
+    // disable and rewrite all of the registers next time.
+    for (uint32_t i = 0; i < sizeof(m_dr_addresses) / sizeof(m_dr_addresses[0]); ++i)
+        m_dr_addresses[i] = LLDB_INVALID_ADDRESS;
+    m_dr_control = 0;
+    m_dr_unknown = true;
+    m_dr_flushed = true;
+    return false;
+}
+#endif
+
+bool
+RegisterContextPOSIXProcessMonitor_x86_64::IsCachedGPR(unsigned reg)
+{
+    // The debug registers are read from the user area, not with the GPRs.
+    return IsGPR(reg) && reg < m_reg_info.first_dr &&
+           GetRegisterOffset(reg) + GetRegisterSize(reg) <= GetGPRSize();
 }
 
 ProcessMonitor &
@@ -69,27 +231,35 @@ RegisterContextPOSIXProcessMonitor_x86_64::GetMonitor()
 bool
 RegisterContextPOSIXProcessMonitor_x86_64::ReadGPR()
 {
-     ProcessMonitor &monitor = GetMonitor();
-     return monitor.ReadGPR(m_thread.GetID(), &m_gpr_x86_64, GetGPRSize());
+    if (m_gpr_valid)
+        return true;
+
+    ProcessMonitor &monitor = GetMonitor();
+    m_gpr_valid = monitor.ReadGPR(m_thread.GetID(), &m_gpr_x86_64, GetGPRSize());
+    return m_gpr_valid;
 }
 
 bool
 RegisterContextPOSIXProcessMonitor_x86_64::ReadFPR()
 {
+    if (m_fpr_valid)
+        return true;
+
     ProcessMonitor &monitor = GetMonitor();
     if (GetFPRType() == eFXSAVE)
-        return monitor.ReadFPR(m_thread.GetID(), &m_fpr.xstate.fxsave, sizeof(m_fpr.xstate.fxsave));
-
-    if (GetFPRType() == eXSAVE)
-        return monitor.ReadRegisterSet(m_thread.GetID(), &m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
-    return false;
+        m_fpr_valid = monitor.ReadFPR(m_thread.GetID(), &m_fpr.xstate.fxsave, sizeof(m_fpr.xstate.fxsave));
+    else if (GetFPRType() == eXSAVE)
+        m_fpr_valid = monitor.ReadRegisterSet(m_thread.GetID(), &m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
+    return m_fpr_valid;
 }
 
 bool
 RegisterContextPOSIXProcessMonitor_x86_64::WriteGPR()
 {
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.WriteGPR(m_thread.GetID(), &m_gpr_x86_64, GetGPRSize());
+    m_gpr_valid = monitor.WriteGPR(m_thread.GetID(), &m_gpr_x86_64, GetGPRSize());
+    m_gpr_dirty = false;
+    return m_gpr_valid;
 }
 
 bool
@@ -97,11 +267,13 @@ RegisterContextPOSIXProcessMonitor_x86_64::WriteFPR()
 {
     ProcessMonitor &monitor = GetMonitor();
     if (GetFPRType() == eFXSAVE)
-        return monitor.WriteFPR(m_thread.GetID(), &m_fpr.xstate.fxsave, sizeof(m_fpr.xstate.fxsave));
-
-    if (GetFPRType() == eXSAVE)
-        return monitor.WriteRegisterSet(m_thread.GetID(), &m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
-    return false;
+        m_fpr_valid = monitor.WriteFPR(m_thread.GetID(), &m_fpr.xstate.fxsave, sizeof(m_fpr.xstate.fxsave));
+    else if (GetFPRType() == eXSAVE)
+        m_fpr_valid = monitor.WriteRegisterSet(m_thread.GetID(), &m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
+    else
+        m_fpr_valid = false;
+    m_fpr_dirty = false;
+    return m_fpr_valid;
 }
 
 bool
@@ -180,6 +352,14 @@ RegisterContextPOSIXProcessMonitor_x86_64::WriteRegister(const unsigned reg,
                                                GetRegisterName(reg_to_write),
                                                value_to_write);
 #endif
+    // Change the cached GPRs, and write them all before the thread runs again.
+    if (IsCachedGPR(reg_to_write) && ReadGPR())
+    {
+        uint64_t data = value_to_write.GetAsUInt64();
+        ::memcpy ((uint8_t *)&m_gpr_x86_64 + GetRegisterOffset(reg_to_write), &data, GetRegisterSize(reg_to_write));
+        m_gpr_dirty = true;
+        return true;
+    }
     return monitor.WriteRegisterValue(m_thread.GetID(),
                                       GetRegisterOffset(reg_to_write),
                                       GetRegisterName(reg_to_write),
@@ -210,7 +390,18 @@ RegisterContextPOSIXProcessMonitor_x86_64::ReadRegister(const RegisterInfo *reg_
             full_reg = reg_info->invalidate_regs[0];
         }
 
-        bool success = ReadRegister(full_reg, value);
+        bool success;
+        if (IsCachedGPR(full_reg) && ReadGPR())
+        {
+            // Pick the register out of the GPRs read for this stop, the same
+            // way it would have been peeked from the user area.
+            uint64_t data = 0;
+            ::memcpy (&data, (uint8_t *)&m_gpr_x86_64 + GetRegisterOffset(full_reg), GetRegisterSize(full_reg));
+            value.SetUInt64(data);
+            success = true;
+        }
+        else
+            success = ReadRegister(full_reg, value);
 
         if (success)
         {
@@ -281,6 +472,10 @@ RegisterContextPOSIXProcessMonitor_x86_64::WriteRegister(const RegisterInfo *reg
 
     if (IsFPR(reg, GetFPRType()))
     {
+        // Only the one register changes, so start from the current FPRs.
+        if (!ReadFPR())
+            return false;
+
         if (reg_info->encoding == eEncodingVector)
         {
             if (reg >= m_reg_info.first_st && reg <= m_reg_info.last_st)
@@ -325,12 +520,11 @@ RegisterContextPOSIXProcessMonitor_x86_64::WriteRegister(const RegisterInfo *reg
             }
         }
 
-        if (WriteFPR())
-        {
-            if (IsAVX(reg))
-                return CopyYMMtoXSTATE(reg, GetByteOrder());
-            return true;
-        }
+        // The FPRs are written before the thread runs again.
+        m_fpr_dirty = true;
+        if (IsAVX(reg))
+            return CopyYMMtoXSTATE(reg, GetByteOrder());
+        return true;
     }
     return false;
 }
@@ -12,6 +12,9 @@
 
 #include "Plugins/Process/POSIX/RegisterContextPOSIX_x86.h"
 
+class DebugRegisterManager;
+class OperationBatch;
+
 class RegisterContextPOSIXProcessMonitor_x86_64:
     public RegisterContextPOSIX_x86,
     public POSIXBreakpointProtocol
@@ -21,6 +24,48 @@ public:
                                               uint32_t concrete_frame_idx,
                                               RegisterInfoInterface *register_info);
 
+    void
+    InvalidateAllRegisters();
+
+#if defined(__linux__)
+    /// Queues reads of the general purpose and floating point registers that
+    /// aren't cached yet in @p batch.  The registers are cached once the batch
+    /// has been run.
+    void
+    AddRegisterReads(OperationBatch &batch);
+
+    /// Queues writes of the general purpose and floating point registers that
+    /// were changed in @p batch, so they are written before the thread is
+    /// resumed by the same batch.
+    void
+    AddRegisterWrites(OperationBatch &batch);
+
+    /// Queues the writes that bring the debug registers of the thread in line
+    /// with @p manager in @p batch.  Only the registers that differ from what
+    /// was written last are written.
+    void
+    AddDebugRegisterWrites(OperationBatch &batch,
+                           const DebugRegisterManager &manager);
+
+    /// Checks the register writes queued by AddRegisterWrites once the batch
+    /// has run.
+    ///
+    /// @return
+    ///     False if the general purpose or floating point registers could not
+    ///     be written, so the thread was resumed with its old values.
+    bool
+    CheckRegisterWrites();
+
+    /// Checks the debug register writes queued by AddDebugRegisterWrites once
+    /// the batch has run.  If any of them failed, the state of the debug
+    /// registers is unknown, and all of them are written again the next time.
+    ///
+    /// @return
+    ///     False if a write failed.
+    bool
+    CheckDebugRegisterWrites();
+#endif
+
 protected:
     bool
     ReadGPR();
@@ -87,9 +132,26 @@ protected:
     uint32_t
     NumSupportedHardwareWatchpoints();
 
+    bool
+    FlushRegisters();
+
 private:
     ProcessMonitor &
     GetMonitor();
+
+    bool
+    IsCachedGPR(unsigned reg);
+
+    bool m_gpr_valid;   // True if m_gpr_x86_64 holds the registers for the current stop.
+    bool m_fpr_valid;   // True if m_fpr holds the registers for the current stop.
+    bool m_gpr_dirty;   // True if m_gpr_x86_64 was changed and not written to the thread yet.
+    bool m_fpr_dirty;   // True if m_fpr was changed and not written to the thread yet.
+    bool m_gpr_flushed; // False if the last batched write of m_gpr_x86_64 failed.
+    bool m_fpr_flushed; // False if the last batched write of m_fpr failed.
+    uint64_t m_dr_addresses[4]; // dr0-dr3 as last written by AddDebugRegisterWrites.
+    uint64_t m_dr_control;      // dr7 as last written by AddDebugRegisterWrites.
+    bool m_dr_flushed;          // False if the last batched write of the debug registers failed.
+    bool m_dr_unknown;          // True if the debug registers may not match m_dr_addresses and m_dr_control.
 };
 
 #endif
@@ -754,6 +754,17 @@ RegisterContextLLDB::GetFullUnwindPlanForFrame ()
             else
                 unwind_plan_sp.reset();
         }
+
+        DWARFCallFrameInfo *debug_frame = pc_module_sp && pc_module_sp->GetObjectFile() ?
+            pc_module_sp->GetObjectFile()->GetUnwindTable().GetDebugFrameInfo() : nullptr;
+        if (debug_frame && m_current_pc.IsValid())
+        {
+            unwind_plan_sp.reset (new UnwindPlan (lldb::eRegisterKindGeneric));
+            if (debug_frame->GetUnwindPlan (m_current_pc, *unwind_plan_sp))
+                return unwind_plan_sp;
+            else
+                unwind_plan_sp.reset();
+        }
         return arch_default_unwind_plan_sp;
     }
 
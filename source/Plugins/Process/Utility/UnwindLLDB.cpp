@@ -11,7 +11,10 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Target/ABI.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Process.h"
@@ -27,7 +30,8 @@ UnwindLLDB::UnwindLLDB (Thread &thread) :
     Unwind (thread),
     m_frames(),
     m_unwind_complete(false),
-    m_user_supplied_trap_handler_functions()
+    m_user_supplied_trap_handler_functions(),
+    m_fp_unwind_plan_sp()
 {
     ProcessSP process_sp(thread.GetProcess());
     if (process_sp)
@@ -299,6 +303,196 @@ UnwindLLDB::DoGetFrameInfoAtIndex (uint32_t idx, addr_t& cfa, addr_t& pc)
     return false;
 }
 
+// The PC-only stack walk.  Only the pc, stack pointer and frame pointer are
+// tracked from frame to frame.  Each caller is found from the eh_frame CFA
+// rule for the function (through the same per-module FuncUnwinders cache the
+// full unwinder uses, without a symbol context), falling back to following the
+// frame pointer chain as the ABI's default unwind plan lays it out.  No
+// RegisterContextLLDB, SymbolContext or StackFrame objects are created, and the
+// full unwind state in m_frames is left alone.
+
+uint32_t
+UnwindLLDB::DoGetStackPCs (std::vector<addr_t> &pcs, uint32_t max_frames)
+{
+    // If the full unwind already got this far, use its answers so the two
+    // views of the stack agree.
+    if (m_unwind_complete || (max_frames > 0 && m_frames.size() >= max_frames))
+    {
+        for (size_t idx = 0; idx < m_frames.size() && idx < max_frames; ++idx)
+            pcs.push_back (m_frames[idx]->start_pc);
+        return pcs.size();
+    }
+
+    ProcessSP process_sp (m_thread.GetProcess());
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+    if (!process_sp || !reg_ctx_sp)
+        return 0;
+
+    Target &target = process_sp->GetTarget();
+
+    PCOnlyFrame frame;
+    frame.pc = reg_ctx_sp->GetPC (LLDB_INVALID_ADDRESS);
+    frame.sp = reg_ctx_sp->GetSP (LLDB_INVALID_ADDRESS);
+    frame.fp = reg_ctx_sp->GetFP (LLDB_INVALID_ADDRESS);
+
+    while (frame.pc != 0 && frame.pc != LLDB_INVALID_ADDRESS && pcs.size() < max_frames)
+    {
+        pcs.push_back (frame.pc);
+
+        const bool is_frame_zero = pcs.size() == 1;
+        PCOnlyFrame caller;
+        if (!GetCallerFromCallFrameInfo (target, *reg_ctx_sp, is_frame_zero, frame, caller) &&
+            !GetCallerFromFramePointer (*process_sp, *reg_ctx_sp, frame, caller))
+            break;
+
+        // Stacks grow down, so each caller's frame has to be above its callee's;
+        // this also keeps a corrupt stack from sending us around in circles.
+        if (caller.sp == LLDB_INVALID_ADDRESS || caller.sp <= frame.sp)
+            break;
+
+        frame = caller;
+    }
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (log)
+        log->Printf ("th%d PC-only stack walk found %" PRIu64 " frames", m_thread.GetIndexID(), (uint64_t)pcs.size());
+    return pcs.size();
+}
+
+bool
+UnwindLLDB::GetCallerFromCallFrameInfo (Target &target,
+                                        RegisterContext &reg_ctx,
+                                        bool is_frame_zero,
+                                        const PCOnlyFrame &frame,
+                                        PCOnlyFrame &caller)
+{
+    // Past frame zero the pc is a return address which may be the first
+    // instruction of the next function; look up the call instruction instead.
+    const addr_t lookup_pc = is_frame_zero ? frame.pc : frame.pc - 1;
+
+    Address addr;
+    if (!target.GetSectionLoadList().ResolveLoadAddress (lookup_pc, addr))
+        return false;
+    ModuleSP module_sp (addr.GetModule());
+    if (!module_sp || module_sp->GetObjectFile() == NULL)
+        return false;
+
+    // An empty symbol context makes the UnwindTable take the function bounds
+    // from the eh_frame rather than from the symbol tables.
+    SymbolContext no_sc;
+    FuncUnwindersSP func_unwinders_sp (module_sp->GetObjectFile()->GetUnwindTable().GetFuncUnwindersContainingAddress (addr, no_sc));
+    if (!func_unwinders_sp)
+        return false;
+
+    const addr_t func_offset = addr.GetFileAddress() - func_unwinders_sp->GetFunctionStartAddress().GetFileAddress();
+    UnwindPlanSP plan_sp (func_unwinders_sp->GetUnwindPlanAtCallSite ((int)func_offset));
+    if (!plan_sp || !plan_sp->PlanValidAtAddress (addr))
+        return false;
+
+    const addr_t plan_offset = addr.GetFileAddress() - plan_sp->GetAddressRange().GetBaseAddress().GetFileAddress();
+    UnwindPlan::RowSP row_sp (plan_sp->GetRowForFunctionOffset ((int)plan_offset));
+    if (!row_sp)
+        return false;
+
+    return GetCallerFromUnwindRow (*m_thread.GetProcess(), reg_ctx, *plan_sp, *row_sp, frame, caller);
+}
+
+bool
+UnwindLLDB::GetCallerFromUnwindRow (Process &process,
+                                    RegisterContext &reg_ctx,
+                                    UnwindPlan &plan,
+                                    const UnwindPlan::Row &row,
+                                    const PCOnlyFrame &frame,
+                                    PCOnlyFrame &caller)
+{
+    const RegisterKind kind = plan.GetRegisterKind();
+    uint32_t sp_regnum = LLDB_INVALID_REGNUM;
+    uint32_t fp_regnum = LLDB_INVALID_REGNUM;
+    uint32_t pc_regnum = plan.GetReturnAddressRegister();
+    reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_SP, kind, sp_regnum);
+    reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_FP, kind, fp_regnum);
+    if (pc_regnum == LLDB_INVALID_REGNUM)
+        reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC, kind, pc_regnum);
+
+    // We only know the sp and fp values, so the CFA must be based on one of those
+    addr_t cfa;
+    const uint32_t cfa_regnum = row.GetCFARegister();
+    if (cfa_regnum == sp_regnum && frame.sp != LLDB_INVALID_ADDRESS)
+        cfa = frame.sp + row.GetCFAOffset();
+    else if (cfa_regnum == fp_regnum && frame.fp != LLDB_INVALID_ADDRESS)
+        cfa = frame.fp + row.GetCFAOffset();
+    else
+        return false;
+
+    Error error;
+
+    UnwindPlan::Row::RegisterLocation pc_loc;
+    if (pc_regnum == LLDB_INVALID_REGNUM || !row.GetRegisterInfo (pc_regnum, pc_loc))
+        return false;
+    if (pc_loc.IsAtCFAPlusOffset())
+    {
+        caller.pc = process.ReadPointerFromMemory (cfa + pc_loc.GetOffset(), error);
+        if (error.Fail())
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    caller.fp = frame.fp;
+    UnwindPlan::Row::RegisterLocation fp_loc;
+    if (fp_regnum != LLDB_INVALID_REGNUM && row.GetRegisterInfo (fp_regnum, fp_loc))
+    {
+        if (fp_loc.IsAtCFAPlusOffset())
+        {
+            caller.fp = process.ReadPointerFromMemory (cfa + fp_loc.GetOffset(), error);
+            if (error.Fail())
+                caller.fp = LLDB_INVALID_ADDRESS;
+        }
+        else if (!fp_loc.IsSame())
+        {
+            caller.fp = LLDB_INVALID_ADDRESS;
+        }
+    }
+
+    // The caller's stack pointer is the CFA by definition
+    caller.sp = cfa;
+    return true;
+}
+
+bool
+UnwindLLDB::GetCallerFromFramePointer (Process &process,
+                                       RegisterContext &reg_ctx,
+                                       const PCOnlyFrame &frame,
+                                       PCOnlyFrame &caller)
+{
+    if (frame.fp == 0 || frame.fp == LLDB_INVALID_ADDRESS || frame.fp < frame.sp)
+        return false;
+
+    const uint32_t addr_size = process.GetAddressByteSize();
+    if (addr_size == 0 || (frame.fp % addr_size) != 0)
+        return false;
+
+    // Where the frame pointer chain keeps the caller's frame pointer and
+    // return address is up to the ABI, so use its default unwind plan.
+    if (!m_fp_unwind_plan_sp)
+    {
+        ABI *abi = process.GetABI().get();
+        if (abi == NULL)
+            return false;
+        UnwindPlanSP plan_sp (new UnwindPlan (eRegisterKindGeneric));
+        if (!abi->CreateDefaultUnwindPlan (*plan_sp) || plan_sp->GetRowCount() == 0)
+            return false;
+        m_fp_unwind_plan_sp = plan_sp;
+    }
+
+    UnwindPlan::RowSP row_sp (m_fp_unwind_plan_sp->GetRowAtIndex (0));
+    if (!row_sp)
+        return false;
+    return GetCallerFromUnwindRow (process, reg_ctx, *m_fp_unwind_plan_sp, *row_sp, frame, caller);
+}
+
 lldb::RegisterContextSP
 UnwindLLDB::DoCreateRegisterContextForFrame (StackFrame *frame)
 {
@@ -78,6 +78,9 @@ protected:
     lldb::RegisterContextSP
     DoCreateRegisterContextForFrame (lldb_private::StackFrame *frame);
 
+    virtual uint32_t
+    DoGetStackPCs (std::vector<lldb::addr_t> &pcs, uint32_t max_frames);
+
     typedef std::shared_ptr<RegisterContextLLDB> RegisterContextLLDBSP;
 
     // Needed to retrieve the "next" frame (e.g. frame 2 needs to retrieve frame 1's RegisterContextLLDB)
@@ -134,6 +137,37 @@ private:
     bool AddOneMoreFrame (ABI *abi);
     bool AddFirstFrame ();
 
+    // The register values the PC-only stack walk tracks for each frame
+    struct PCOnlyFrame
+    {
+        lldb::addr_t pc;
+        lldb::addr_t sp;
+        lldb::addr_t fp;
+    };
+
+    bool
+    GetCallerFromCallFrameInfo (lldb_private::Target &target,
+                                lldb_private::RegisterContext &reg_ctx,
+                                bool is_frame_zero,
+                                const PCOnlyFrame &frame,
+                                PCOnlyFrame &caller);
+
+    bool
+    GetCallerFromUnwindRow (lldb_private::Process &process,
+                            lldb_private::RegisterContext &reg_ctx,
+                            lldb_private::UnwindPlan &plan,
+                            const lldb_private::UnwindPlan::Row &row,
+                            const PCOnlyFrame &frame,
+                            PCOnlyFrame &caller);
+
+    bool
+    GetCallerFromFramePointer (lldb_private::Process &process,
+                               lldb_private::RegisterContext &reg_ctx,
+                               const PCOnlyFrame &frame,
+                               PCOnlyFrame &caller);
+
+    lldb::UnwindPlanSP m_fp_unwind_plan_sp; // The ABI's default unwind plan, used by the PC-only stack walk
+
     //------------------------------------------------------------------
     // For UnwindLLDB only
     //------------------------------------------------------------------
@@ -0,0 +1,935 @@
+//===-- GDBRemoteAgentExpression.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "GDBRemoteAgentExpression.h"
+
+// C Includes
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// C++ Includes
+#include <algorithm>
+#include <map>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Expression/CompiledCondition.h"
+#include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/ClangASTType.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Target.h"
+#include "Plugins/Process/Utility/DynamicRegisterInfo.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+GDBRemoteAgentExpression::GDBRemoteAgentExpression () :
+    m_bytes ()
+{
+}
+
+GDBRemoteAgentExpression::~GDBRemoteAgentExpression ()
+{
+}
+
+void
+GDBRemoteAgentExpression::AppendOpcode (OpCode op)
+{
+    m_bytes.push_back (op);
+}
+
+void
+GDBRemoteAgentExpression::AppendConstant (uint64_t value)
+{
+    // constN zero extends, so negative numbers need the full 64 bits.
+    uint32_t byte_size;
+    if (value <= UINT8_MAX)
+    {
+        m_bytes.push_back (eOpConst8);
+        byte_size = 1;
+    }
+    else if (value <= UINT16_MAX)
+    {
+        m_bytes.push_back (eOpConst16);
+        byte_size = 2;
+    }
+    else if (value <= UINT32_MAX)
+    {
+        m_bytes.push_back (eOpConst32);
+        byte_size = 4;
+    }
+    else
+    {
+        m_bytes.push_back (eOpConst64);
+        byte_size = 8;
+    }
+    // Operands are big endian.
+    for (int shift = (byte_size - 1) * 8; shift >= 0; shift -= 8)
+        m_bytes.push_back ((uint8_t)(value >> shift));
+}
+
+void
+GDBRemoteAgentExpression::AppendRegister (uint32_t reg_num)
+{
+    m_bytes.push_back (eOpReg);
+    m_bytes.push_back ((uint8_t)(reg_num >> 8));
+    m_bytes.push_back ((uint8_t)reg_num);
+}
+
+bool
+GDBRemoteAgentExpression::AppendMemoryRef (uint32_t byte_size)
+{
+    switch (byte_size)
+    {
+    case 1: m_bytes.push_back (eOpRef8); return true;
+    case 2: m_bytes.push_back (eOpRef16); return true;
+    case 4: m_bytes.push_back (eOpRef32); return true;
+    case 8: m_bytes.push_back (eOpRef64); return true;
+    default:
+        break;
+    }
+    return false;
+}
+
+void
+GDBRemoteAgentExpression::AppendExtend (uint32_t byte_size, bool is_signed)
+{
+    if (byte_size >= 8)
+        return;
+    m_bytes.push_back (is_signed ? eOpExt : eOpZeroExt);
+    m_bytes.push_back ((uint8_t)(byte_size * 8));
+}
+
+size_t
+GDBRemoteAgentExpression::AppendBranch (OpCode op)
+{
+    const size_t branch_offset = m_bytes.size();
+    m_bytes.push_back (op);
+    m_bytes.push_back (0);
+    m_bytes.push_back (0);
+    return branch_offset;
+}
+
+void
+GDBRemoteAgentExpression::PatchBranch (size_t branch_offset, size_t target_offset)
+{
+    m_bytes[branch_offset + 1] = (uint8_t)(target_offset >> 8);
+    m_bytes[branch_offset + 2] = (uint8_t)target_offset;
+}
+
+void
+GDBRemoteAgentExpression::AppendToPacket (std::string &packet) const
+{
+    char buffer[32];
+    ::snprintf (buffer, sizeof(buffer), ";X%" PRIx64 ",", (uint64_t)m_bytes.size());
+    packet.append (buffer);
+    for (size_t i = 0; i < m_bytes.size(); ++i)
+    {
+        ::snprintf (buffer, sizeof(buffer), "%2.2x", m_bytes[i]);
+        packet.append (buffer);
+    }
+}
+
+namespace {
+
+//----------------------------------------------------------------------
+// Translates CompiledCondition bytecode into an agent expression for a
+// breakpoint address.
+//
+// Every value on the agent expression stack is kept sign or zero
+// extended to 64 bits according to its C type, and the C type of each
+// stack slot is tracked so that the usual arithmetic conversions can be
+// applied by truncating and re-extending values where C would.
+//----------------------------------------------------------------------
+class AgentConditionCompiler
+{
+public:
+    AgentConditionCompiler (const CompiledCondition &condition,
+                            const Address &addr,
+                            Target &target,
+                            const DynamicRegisterInfo &reg_info,
+                            GDBRemoteAgentExpression &expr,
+                            Error &error) :
+        m_condition (condition),
+        m_addr (addr),
+        m_target (target),
+        m_reg_info (reg_info),
+        m_expr (expr),
+        m_error (error),
+        m_sc (),
+        m_variables (),
+        m_stack ()
+    {
+    }
+
+    bool
+    Compile ()
+    {
+        m_addr.CalculateSymbolContext (&m_sc, eSymbolContextEverything);
+        if (!m_sc.module_sp || !m_sc.function)
+        {
+            m_error.SetErrorString ("no debug information for the breakpoint address");
+            return false;
+        }
+
+        // The frame base of a variable in an inlined function is that of
+        // the function it was inlined into; don't try to sort that out.
+        if (m_sc.block && m_sc.block->GetContainingInlinedBlock())
+        {
+            m_error.SetErrorString ("breakpoint address is in an inlined function");
+            return false;
+        }
+
+        if (m_sc.block)
+            m_sc.block->AppendVariables (true, true, true, &m_variables);
+        else
+        {
+            Block &function_block = m_sc.function->GetBlock (true);
+            function_block.AppendVariables (true, true, true, &m_variables);
+        }
+        if (m_sc.comp_unit)
+        {
+            VariableListSP globals_sp (m_sc.comp_unit->GetVariableList (true));
+            if (globals_sp)
+                m_variables.AddVariables (globals_sp.get());
+        }
+
+        const std::vector<CompiledCondition::Instruction> &code = m_condition.GetInstructions();
+        std::vector<size_t> inst_offsets (code.size() + 1, 0);
+        std::vector<std::pair<size_t, uint32_t> > branches;
+        // The stack at the target of each forward branch
+        std::map<uint32_t, std::vector<SlotType> > branch_stacks;
+        bool reachable = true;
+
+        for (uint32_t i = 0; i <= code.size(); ++i)
+        {
+            std::map<uint32_t, std::vector<SlotType> >::const_iterator pos = branch_stacks.find (i);
+            if (pos != branch_stacks.end() && !reachable)
+            {
+                m_stack = pos->second;
+                reachable = true;
+            }
+            inst_offsets[i] = m_expr.GetBytes().size();
+            if (i == code.size())
+                break;
+
+            const CompiledCondition::Instruction &inst = code[i];
+            switch (inst.op)
+            {
+            case CompiledCondition::eOpPushConstant:
+                if (!PushConstant (m_condition.GetConstantAtIndex (inst.operand)))
+                    return false;
+                break;
+
+            case CompiledCondition::eOpPushVariable:
+                if (!PushVariable (m_condition.GetVariablePathAtIndex (inst.operand)))
+                    return false;
+                break;
+
+            case CompiledCondition::eOpBranch:
+            case CompiledCondition::eOpBranchIfZero:
+            case CompiledCondition::eOpBranchIfNotZero:
+                {
+                    GDBRemoteAgentExpression::OpCode branch_op = GDBRemoteAgentExpression::eOpIfGoto;
+                    if (inst.op == CompiledCondition::eOpBranch)
+                        branch_op = GDBRemoteAgentExpression::eOpGoto;
+                    else
+                    {
+                        if (m_stack.empty())
+                            return Unsupported ("malformed condition");
+                        if (inst.op == CompiledCondition::eOpBranchIfZero)
+                            m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpLogNot);
+                        m_stack.pop_back();
+                    }
+                    if (inst.operand <= i)
+                        return Unsupported ("backward branch in condition");
+                    branches.push_back (std::make_pair (m_expr.AppendBranch (branch_op), inst.operand));
+                    branch_stacks[inst.operand] = m_stack;
+                    if (inst.op == CompiledCondition::eOpBranch)
+                        reachable = false;
+                }
+                break;
+
+            case CompiledCondition::eOpLogicalNot:
+                if (m_stack.empty())
+                    return Unsupported ("malformed condition");
+                m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpLogNot);
+                m_stack.back() = SlotType (4, true);
+                break;
+
+            case CompiledCondition::eOpNegate:
+            case CompiledCondition::eOpComplement:
+                {
+                    if (m_stack.empty())
+                        return Unsupported ("malformed condition");
+                    if (m_stack.back().is_pointer)
+                        return Unsupported ("arithmetic on a pointer");
+                    const SlotType type (Promote (m_stack.back()));
+                    if (inst.op == CompiledCondition::eOpNegate)
+                    {
+                        // 0 - x
+                        m_expr.AppendConstant (0);
+                        m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpSwap);
+                        m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpSub);
+                    }
+                    else
+                        m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpBitNot);
+                    m_expr.AppendExtend (type.byte_size, type.is_signed);
+                    m_stack.back() = type;
+                }
+                break;
+
+            default:
+                if (!AppendBinaryOperator (inst.op))
+                    return false;
+                break;
+            }
+        }
+
+        if (m_stack.size() != 1)
+            return Unsupported ("malformed condition");
+        m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpEnd);
+
+        for (size_t i = 0; i < branches.size(); ++i)
+        {
+            const size_t target_offset = inst_offsets[branches[i].second];
+            if (target_offset > UINT16_MAX)
+                return Unsupported ("condition is too large");
+            m_expr.PatchBranch (branches[i].first, target_offset);
+        }
+        return true;
+    }
+
+private:
+    struct SlotType
+    {
+        SlotType (uint32_t size = 4, bool sign = true, bool pointer = false) :
+            byte_size (size),
+            is_signed (sign),
+            is_pointer (pointer)
+        {
+        }
+
+        uint32_t byte_size;
+        bool is_signed;
+        bool is_pointer;
+    };
+
+    // Where the value a variable path names currently is.
+    enum LocationKind
+    {
+        eLocationRegister,  // In register m_register
+        eLocationMemory,    // At the address on top of the stack
+        eLocationValue      // On top of the stack
+    };
+
+    bool
+    Unsupported (const char *reason)
+    {
+        m_error.SetErrorString (reason);
+        return false;
+    }
+
+    // Integer promotion
+    static SlotType
+    Promote (const SlotType &type)
+    {
+        if (type.byte_size < 4)
+            return SlotType (4, true);
+        return type;
+    }
+
+    // The usual arithmetic conversions
+    static SlotType
+    CommonType (const SlotType &lhs_type, const SlotType &rhs_type)
+    {
+        const SlotType lhs (Promote (lhs_type));
+        const SlotType rhs (Promote (rhs_type));
+        if (lhs.is_signed == rhs.is_signed)
+            return SlotType (std::max (lhs.byte_size, rhs.byte_size), lhs.is_signed);
+        const SlotType &signed_type = lhs.is_signed ? lhs : rhs;
+        const SlotType &unsigned_type = lhs.is_signed ? rhs : lhs;
+        if (unsigned_type.byte_size >= signed_type.byte_size)
+            return unsigned_type;
+        return signed_type;
+    }
+
+    // Convert both operands on top of the stack to \a type.
+    void
+    ConvertOperands (const SlotType &lhs, const SlotType &rhs, const SlotType &type)
+    {
+        if (type.byte_size >= 8)
+            return;     // The 64 bit representation of both is already right
+        if (rhs.byte_size != type.byte_size || rhs.is_signed != type.is_signed)
+            m_expr.AppendExtend (type.byte_size, type.is_signed);
+        if (lhs.byte_size != type.byte_size || lhs.is_signed != type.is_signed)
+        {
+            m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpSwap);
+            m_expr.AppendExtend (type.byte_size, type.is_signed);
+            m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpSwap);
+        }
+    }
+
+    bool
+    AppendBinaryOperator (CompiledCondition::OpCode op)
+    {
+        typedef GDBRemoteAgentExpression AX;
+
+        if (m_stack.size() < 2)
+            return Unsupported ("malformed condition");
+        const SlotType rhs = m_stack.back();
+        m_stack.pop_back();
+        const SlotType lhs = m_stack.back();
+
+        // Pointers may only be compared, arithmetic on them would need to
+        // be scaled by the pointee size.
+        if (lhs.is_pointer || rhs.is_pointer)
+        {
+            switch (op)
+            {
+            case CompiledCondition::eOpLessThan:
+            case CompiledCondition::eOpLessThanOrEqual:
+            case CompiledCondition::eOpGreaterThan:
+            case CompiledCondition::eOpGreaterThanOrEqual:
+            case CompiledCondition::eOpEqual:
+            case CompiledCondition::eOpNotEqual:
+                break;
+            default:
+                return Unsupported ("arithmetic on a pointer");
+            }
+        }
+
+        // Shifts have the type of the promoted left operand.
+        if (op == CompiledCondition::eOpShiftLeft || op == CompiledCondition::eOpShiftRight)
+        {
+            const SlotType type (Promote (lhs));
+            if (op == CompiledCondition::eOpShiftLeft)
+                m_expr.AppendOpcode (AX::eOpLsh);
+            else
+                m_expr.AppendOpcode (type.is_signed ? AX::eOpRshSigned : AX::eOpRshUnsigned);
+            m_expr.AppendExtend (type.byte_size, type.is_signed);
+            m_stack.back() = type;
+            return true;
+        }
+
+        const SlotType type (CommonType (lhs, rhs));
+        ConvertOperands (lhs, rhs, type);
+
+        bool is_comparison = true;
+        switch (op)
+        {
+        case CompiledCondition::eOpLessThan:
+            m_expr.AppendOpcode (type.is_signed ? AX::eOpLessSigned : AX::eOpLessUnsigned);
+            break;
+        case CompiledCondition::eOpGreaterThan:         // b < a
+            m_expr.AppendOpcode (AX::eOpSwap);
+            m_expr.AppendOpcode (type.is_signed ? AX::eOpLessSigned : AX::eOpLessUnsigned);
+            break;
+        case CompiledCondition::eOpLessThanOrEqual:     // !(b < a)
+            m_expr.AppendOpcode (AX::eOpSwap);
+            m_expr.AppendOpcode (type.is_signed ? AX::eOpLessSigned : AX::eOpLessUnsigned);
+            m_expr.AppendOpcode (AX::eOpLogNot);
+            break;
+        case CompiledCondition::eOpGreaterThanOrEqual:  // !(a < b)
+            m_expr.AppendOpcode (type.is_signed ? AX::eOpLessSigned : AX::eOpLessUnsigned);
+            m_expr.AppendOpcode (AX::eOpLogNot);
+            break;
+        case CompiledCondition::eOpEqual:
+            m_expr.AppendOpcode (AX::eOpEqual);
+            break;
+        case CompiledCondition::eOpNotEqual:
+            m_expr.AppendOpcode (AX::eOpEqual);
+            m_expr.AppendOpcode (AX::eOpLogNot);
+            break;
+        default:
+            is_comparison = false;
+            break;
+        }
+        if (is_comparison)
+        {
+            m_stack.back() = SlotType (4, true);
+            return true;
+        }
+
+        switch (op)
+        {
+        case CompiledCondition::eOpMultiply:    m_expr.AppendOpcode (AX::eOpMul); break;
+        case CompiledCondition::eOpDivide:      m_expr.AppendOpcode (type.is_signed ? AX::eOpDivSigned : AX::eOpDivUnsigned); break;
+        case CompiledCondition::eOpRemainder:   m_expr.AppendOpcode (type.is_signed ? AX::eOpRemSigned : AX::eOpRemUnsigned); break;
+        case CompiledCondition::eOpAdd:         m_expr.AppendOpcode (AX::eOpAdd); break;
+        case CompiledCondition::eOpSubtract:    m_expr.AppendOpcode (AX::eOpSub); break;
+        case CompiledCondition::eOpBitwiseAnd:  m_expr.AppendOpcode (AX::eOpBitAnd); break;
+        case CompiledCondition::eOpBitwiseXor:  m_expr.AppendOpcode (AX::eOpBitXor); break;
+        case CompiledCondition::eOpBitwiseOr:   m_expr.AppendOpcode (AX::eOpBitOr); break;
+        default:
+            return Unsupported ("unsupported operator");
+        }
+        m_expr.AppendExtend (type.byte_size, type.is_signed);
+        m_stack.back() = type;
+        return true;
+    }
+
+    bool
+    PushConstant (const Scalar &value)
+    {
+        SlotType type;
+        switch (value.GetType())
+        {
+        case Scalar::e_sint:        type = SlotType (sizeof(int), true); break;
+        case Scalar::e_uint:        type = SlotType (sizeof(int), false); break;
+        case Scalar::e_slong:       type = SlotType (sizeof(long), true); break;
+        case Scalar::e_ulong:       type = SlotType (sizeof(long), false); break;
+        case Scalar::e_slonglong:   type = SlotType (sizeof(long long), true); break;
+        case Scalar::e_ulonglong:   type = SlotType (sizeof(long long), false); break;
+        default:
+            return Unsupported ("floating point values can't be evaluated by the remote stub");
+        }
+        m_expr.AppendConstant (type.is_signed ? (uint64_t)value.SLongLong() : value.ULongLong());
+        m_stack.push_back (type);
+        return true;
+    }
+
+    // Map a DWARF register number to the register number the stub uses.
+    bool
+    GetRemoteRegister (uint32_t kind, uint32_t reg, uint32_t &remote_reg)
+    {
+        remote_reg = m_reg_info.ConvertRegisterKindToRegisterNumber (kind, reg);
+        if (remote_reg == LLDB_INVALID_REGNUM || remote_reg > UINT16_MAX)
+        {
+            m_error.SetErrorStringWithFormat ("register %u is not known to the remote stub", reg);
+            return false;
+        }
+        return true;
+    }
+
+    // Push the address of a register relative location.
+    bool
+    PushRegisterPlusOffset (uint32_t kind, uint32_t reg, int64_t offset)
+    {
+        uint32_t remote_reg;
+        if (!GetRemoteRegister (kind, reg, remote_reg))
+            return false;
+        m_expr.AppendRegister (remote_reg);
+        if (offset != 0)
+        {
+            m_expr.AppendConstant ((uint64_t)offset);
+            m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpAdd);
+        }
+        return true;
+    }
+
+    // Push the canonical frame address from the unwind information.
+    bool
+    PushCFA ()
+    {
+        ObjectFile *objfile = m_sc.module_sp->GetObjectFile();
+        if (objfile == NULL)
+            return Unsupported ("no object file for the breakpoint address");
+        SymbolContext no_sc;
+        FuncUnwindersSP func_unwinders_sp (objfile->GetUnwindTable().GetFuncUnwindersContainingAddress (m_addr, no_sc));
+        if (!func_unwinders_sp)
+            return Unsupported ("no unwind information for the breakpoint address");
+
+        const addr_t func_offset = m_addr.GetFileAddress() - func_unwinders_sp->GetFunctionStartAddress().GetFileAddress();
+        UnwindPlanSP plan_sp (func_unwinders_sp->GetUnwindPlanAtCallSite ((int)func_offset));
+        if (!plan_sp || !plan_sp->PlanValidAtAddress (m_addr))
+            return Unsupported ("no unwind plan for the breakpoint address");
+
+        const addr_t plan_offset = m_addr.GetFileAddress() - plan_sp->GetAddressRange().GetBaseAddress().GetFileAddress();
+        UnwindPlan::RowSP row_sp (plan_sp->GetRowForFunctionOffset ((int)plan_offset));
+        if (!row_sp)
+            return Unsupported ("no unwind plan row for the breakpoint address");
+        return PushRegisterPlusOffset (plan_sp->GetRegisterKind(), row_sp->GetCFARegister(), row_sp->GetCFAOffset());
+    }
+
+    bool
+    PushFrameBase ()
+    {
+        DWARFExpression &frame_base = m_sc.function->GetFrameBaseExpression();
+        const addr_t func_file_addr = m_sc.function->GetAddressRange().GetBaseAddress().GetFileAddress();
+        DataExtractor data;
+        if (!frame_base.GetExpressionDataAtAddress (func_file_addr, m_addr.GetFileAddress(), data))
+            return Unsupported ("no frame base for the breakpoint address");
+
+        lldb::offset_t offset = 0;
+        const uint8_t op = data.GetU8 (&offset);
+        bool success = false;
+        if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+        {
+            const int64_t reg_offset = data.GetSLEB128 (&offset);
+            success = PushRegisterPlusOffset (eRegisterKindDWARF, op - DW_OP_breg0, reg_offset);
+        }
+        else if (op == DW_OP_bregx)
+        {
+            const uint32_t reg = data.GetULEB128 (&offset);
+            const int64_t reg_offset = data.GetSLEB128 (&offset);
+            success = PushRegisterPlusOffset (eRegisterKindDWARF, reg, reg_offset);
+        }
+        else if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+            success = PushRegisterPlusOffset (eRegisterKindDWARF, op - DW_OP_reg0, 0);
+        else if (op == DW_OP_regx)
+            success = PushRegisterPlusOffset (eRegisterKindDWARF, data.GetULEB128 (&offset), 0);
+        else if (op == DW_OP_call_frame_cfa)
+            success = PushCFA();
+        else
+            return Unsupported ("unsupported frame base expression");
+
+        if (success && offset != data.GetByteSize())
+            return Unsupported ("unsupported frame base expression");
+        return success;
+    }
+
+    // Work out where \a var_sp lives, leaving its address on the stack if
+    // it is in memory.
+    bool
+    LocateVariable (const VariableSP &var_sp, LocationKind &location, uint32_t &remote_reg)
+    {
+        if (!var_sp->LocationIsValidForAddress (m_addr))
+        {
+            m_error.SetErrorStringWithFormat ("'%s' is not available at the breakpoint address", var_sp->GetName().GetCString());
+            return false;
+        }
+
+        const addr_t func_file_addr = m_sc.function->GetAddressRange().GetBaseAddress().GetFileAddress();
+        DataExtractor data;
+        if (!var_sp->LocationExpression().GetExpressionDataAtAddress (func_file_addr, m_addr.GetFileAddress(), data))
+        {
+            m_error.SetErrorStringWithFormat ("'%s' has no location", var_sp->GetName().GetCString());
+            return false;
+        }
+
+        lldb::offset_t offset = 0;
+        const uint8_t op = data.GetU8 (&offset);
+        bool success = false;
+        location = eLocationMemory;
+        if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+        {
+            location = eLocationRegister;
+            success = GetRemoteRegister (eRegisterKindDWARF, op - DW_OP_reg0, remote_reg);
+        }
+        else if (op == DW_OP_regx)
+        {
+            location = eLocationRegister;
+            success = GetRemoteRegister (eRegisterKindDWARF, data.GetULEB128 (&offset), remote_reg);
+        }
+        else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+        {
+            const int64_t reg_offset = data.GetSLEB128 (&offset);
+            success = PushRegisterPlusOffset (eRegisterKindDWARF, op - DW_OP_breg0, reg_offset);
+        }
+        else if (op == DW_OP_bregx)
+        {
+            const uint32_t reg = data.GetULEB128 (&offset);
+            const int64_t reg_offset = data.GetSLEB128 (&offset);
+            success = PushRegisterPlusOffset (eRegisterKindDWARF, reg, reg_offset);
+        }
+        else if (op == DW_OP_fbreg)
+        {
+            const int64_t fb_offset = data.GetSLEB128 (&offset);
+            success = PushFrameBase();
+            if (success && fb_offset != 0)
+            {
+                m_expr.AppendConstant ((uint64_t)fb_offset);
+                m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpAdd);
+            }
+        }
+        else if (op == DW_OP_addr)
+        {
+            const addr_t file_addr = data.GetAddress (&offset);
+            Address so_addr;
+            SymbolContext var_sc;
+            var_sp->CalculateSymbolContext (&var_sc);
+            ModuleSP module_sp (var_sc.module_sp ? var_sc.module_sp : m_sc.module_sp);
+            if (module_sp && module_sp->ResolveFileAddress (file_addr, so_addr))
+            {
+                const addr_t load_addr = so_addr.GetLoadAddress (&m_target);
+                if (load_addr != LLDB_INVALID_ADDRESS)
+                {
+                    m_expr.AppendConstant (load_addr);
+                    success = true;
+                }
+            }
+            if (!success)
+                m_error.SetErrorStringWithFormat ("'%s' is not loaded", var_sp->GetName().GetCString());
+        }
+        else
+        {
+            m_error.SetErrorStringWithFormat ("the location of '%s' is too complex", var_sp->GetName().GetCString());
+            return false;
+        }
+
+        if (success && offset != data.GetByteSize())
+        {
+            m_error.SetErrorStringWithFormat ("the location of '%s' is too complex", var_sp->GetName().GetCString());
+            return false;
+        }
+        return success;
+    }
+
+    // Turn the value a path names into a value on the stack.
+    bool
+    LoadValue (const ClangASTType &type, LocationKind &location, uint32_t remote_reg)
+    {
+        const uint64_t byte_size = type.GetByteSize();
+        if (byte_size == 0 || byte_size > 8)
+            return Unsupported ("value is not an integer, enumeration or pointer");
+        if (location == eLocationRegister)
+            m_expr.AppendRegister (remote_reg);
+        else if (location == eLocationMemory)
+        {
+            if (!m_expr.AppendMemoryRef ((uint32_t)byte_size))
+                return Unsupported ("value has an unsupported size");
+        }
+        location = eLocationValue;
+        return true;
+    }
+
+    static bool
+    IsSigned (const ClangASTType &type)
+    {
+        bool is_signed = false;
+        if (type.IsIntegerType (is_signed))
+            return is_signed;
+        return (type.GetTypeInfo() & ClangASTType::eTypeIsSigned) != 0;
+    }
+
+    bool
+    AccessMember (ClangASTType &type, const std::string &member_name)
+    {
+        std::vector<uint32_t> child_indexes;
+        if (type.GetIndexOfChildMemberWithName (member_name.c_str(), true, child_indexes) == 0)
+        {
+            m_error.SetErrorStringWithFormat ("no member named '%s'", member_name.c_str());
+            return false;
+        }
+
+        int64_t offset = 0;
+        for (size_t i = 0; i < child_indexes.size(); ++i)
+        {
+            std::string child_name;
+            uint32_t child_byte_size = 0;
+            int32_t child_byte_offset = 0;
+            uint32_t child_bitfield_bit_size = 0;
+            uint32_t child_bitfield_bit_offset = 0;
+            bool child_is_base_class = false;
+            bool child_is_deref_of_parent = false;
+            ClangASTType child_type (type.GetChildClangTypeAtIndex (NULL,
+                                                                    NULL,
+                                                                    child_indexes[i],
+                                                                    false,
+                                                                    true,
+                                                                    false,
+                                                                    child_name,
+                                                                    child_byte_size,
+                                                                    child_byte_offset,
+                                                                    child_bitfield_bit_size,
+                                                                    child_bitfield_bit_offset,
+                                                                    child_is_base_class,
+                                                                    child_is_deref_of_parent));
+            if (!child_type.IsValid() || child_is_deref_of_parent)
+                return Unsupported ("unsupported member access");
+            if (child_bitfield_bit_size != 0)
+                return Unsupported ("bitfields can't be evaluated by the remote stub");
+            offset += child_byte_offset;
+            type = child_type;
+        }
+        if (offset != 0)
+        {
+            m_expr.AppendConstant ((uint64_t)offset);
+            m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpAdd);
+        }
+        return true;
+    }
+
+    static bool
+    ParseIdentifier (const std::string &path, size_t &pos, std::string &identifier)
+    {
+        const size_t start = pos;
+        while (pos < path.size() && (isalnum(path[pos]) || path[pos] == '_' || path[pos] == '$'))
+            ++pos;
+        identifier.assign (path, start, pos - start);
+        return !identifier.empty();
+    }
+
+    bool
+    PushVariable (const std::string &path)
+    {
+        size_t pos = 0;
+        const char prefix = path[0] == '*' || path[0] == '&' ? path[0] : '\0';
+        if (prefix)
+            ++pos;
+
+        std::string identifier;
+        if (!ParseIdentifier (path, pos, identifier))
+            return Unsupported ("malformed variable path");
+
+        VariableSP var_sp (m_variables.FindVariable (ConstString (identifier.c_str())));
+        if (!var_sp || var_sp->GetType() == NULL)
+        {
+            m_error.SetErrorStringWithFormat ("no variable named '%s' found at the breakpoint address", identifier.c_str());
+            return false;
+        }
+
+        ClangASTType type (var_sp->GetType()->GetClangFullType());
+        LocationKind location;
+        uint32_t remote_reg = LLDB_INVALID_REGNUM;
+        if (!LocateVariable (var_sp, location, remote_reg))
+            return false;
+
+        while (pos < path.size())
+        {
+            if (path[pos] == '.' || path.compare (pos, 2, "->") == 0)
+            {
+                if (path[pos] == '-')
+                {
+                    ClangASTType pointee_type;
+                    if (!type.IsPointerType (&pointee_type))
+                        return Unsupported ("'->' applied to a value that is not a pointer");
+                    if (!LoadValue (type, location, remote_reg))
+                        return false;
+                    type = pointee_type;
+                    location = eLocationMemory;
+                    pos += 2;
+                }
+                else
+                    ++pos;
+
+                if (location != eLocationMemory)
+                    return Unsupported ("member access on a value that is not in memory");
+                std::string member_name;
+                if (!ParseIdentifier (path, pos, member_name) || !AccessMember (type, member_name))
+                    return false;
+            }
+            else if (path[pos] == '[')
+            {
+                char *index_end = NULL;
+                const uint64_t index = ::strtoull (path.c_str() + pos + 1, &index_end, 10);
+                pos = index_end - path.c_str();
+                if (pos >= path.size() || path[pos] != ']')
+                    return Unsupported ("malformed variable path");
+                ++pos;
+
+                ClangASTType element_type;
+                if (type.IsArrayType (&element_type, NULL, NULL))
+                {
+                    if (location != eLocationMemory)
+                        return Unsupported ("array that is not in memory");
+                }
+                else if (type.IsPointerType (&element_type))
+                {
+                    if (!LoadValue (type, location, remote_reg))
+                        return false;
+                    location = eLocationMemory;
+                }
+                else
+                    return Unsupported ("subscript of a value that is not an array or pointer");
+
+                const uint64_t offset = index * element_type.GetByteSize();
+                if (offset != 0)
+                {
+                    m_expr.AppendConstant (offset);
+                    m_expr.AppendOpcode (GDBRemoteAgentExpression::eOpAdd);
+                }
+                type = element_type;
+            }
+            else
+                return Unsupported ("malformed variable path");
+        }
+
+        if (prefix == '&')
+        {
+            if (location != eLocationMemory)
+                return Unsupported ("address of a value that is not in memory");
+            m_stack.push_back (SlotType (m_target.GetArchitecture().GetAddressByteSize(), false));
+            return true;
+        }
+
+        if (prefix == '*')
+        {
+            ClangASTType pointee_type;
+            if (!type.IsPointerType (&pointee_type))
+                return Unsupported ("'*' applied to a value that is not a pointer");
+            if (!LoadValue (type, location, remote_reg))
+                return false;
+            type = pointee_type;
+            location = eLocationMemory;
+        }
+
+        // Same rules as CompiledCondition::ReadVariable, minus floating point.
+        const uint32_t type_info = type.GetTypeInfo();
+        if ((type_info & (ClangASTType::eTypeIsScalar | ClangASTType::eTypeIsPointer | ClangASTType::eTypeIsEnumeration)) == 0 ||
+            (type_info & ClangASTType::eTypeIsReference))
+            return Unsupported ("value is not an integer, enumeration or pointer");
+        uint32_t float_count = 0;
+        bool is_complex = false;
+        if (type.IsFloatingPointType (float_count, is_complex))
+            return Unsupported ("floating point values can't be evaluated by the remote stub");
+
+        if (!LoadValue (type, location, remote_reg))
+            return false;
+        const bool is_pointer = (type_info & ClangASTType::eTypeIsPointer) != 0;
+        const SlotType slot_type ((uint32_t)type.GetByteSize(), is_pointer ? false : IsSigned (type), is_pointer);
+        m_expr.AppendExtend (slot_type.byte_size, slot_type.is_signed);
+        m_stack.push_back (slot_type);
+        return true;
+    }
+
+    const CompiledCondition &m_condition;
+    const Address &m_addr;
+    Target &m_target;
+    const DynamicRegisterInfo &m_reg_info;
+    GDBRemoteAgentExpression &m_expr;
+    Error &m_error;
+    SymbolContext m_sc;
+    VariableList m_variables;           // Innermost scope first
+    std::vector<SlotType> m_stack;      // The C type of each stack slot
+};
+
+} // anonymous namespace
+
+bool
+GDBRemoteAgentExpression::CompileBreakpointCondition (const char *condition,
+                                                      const Address &addr,
+                                                      Target &target,
+                                                      const DynamicRegisterInfo &reg_info,
+                                                      GDBRemoteAgentExpression &expr,
+                                                      Error &error)
+{
+    expr.Clear();
+
+    CompiledCondition compiled_condition;
+    if (!compiled_condition.Compile (condition))
+    {
+        error.SetErrorStringWithFormat ("'%s' is not a simple condition", condition);
+        return false;
+    }
+
+    AgentConditionCompiler compiler (compiled_condition, addr, target, reg_info, expr, error);
+    if (!compiler.Compile())
+    {
+        expr.Clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,159 @@
+//===-- GDBRemoteAgentExpression.h ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteAgentExpression_h_
+#define liblldb_GDBRemoteAgentExpression_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+class DynamicRegisterInfo;
+
+//----------------------------------------------------------------------
+/// @class GDBRemoteAgentExpression GDBRemoteAgentExpression.h
+/// @brief A GDB agent expression: the bytecode used to hand breakpoint
+///        conditions to a remote stub.
+///
+/// Conditions are sent along with a Z0 or Z1 packet as
+/// ";X<length>,<hex bytecode>" and the stub only reports a breakpoint
+/// hit when one of the conditions evaluates to a non-zero value. See
+/// the "Agent Expressions" appendix of the GDB manual for the bytecode.
+///
+/// Conditions are compiled with CompileBreakpointCondition.
+//----------------------------------------------------------------------
+class GDBRemoteAgentExpression
+{
+public:
+    enum OpCode
+    {
+        eOpAdd          = 0x02,
+        eOpSub          = 0x03,
+        eOpMul          = 0x04,
+        eOpDivSigned    = 0x05,
+        eOpDivUnsigned  = 0x06,
+        eOpRemSigned    = 0x07,
+        eOpRemUnsigned  = 0x08,
+        eOpLsh          = 0x09,
+        eOpRshSigned    = 0x0a,
+        eOpRshUnsigned  = 0x0b,
+        eOpLogNot       = 0x0e,
+        eOpBitAnd       = 0x0f,
+        eOpBitOr        = 0x10,
+        eOpBitXor       = 0x11,
+        eOpBitNot       = 0x12,
+        eOpEqual        = 0x13,
+        eOpLessSigned   = 0x14,
+        eOpLessUnsigned = 0x15,
+        eOpExt          = 0x16,     // 1 byte operand: sign extend from N bits
+        eOpRef8         = 0x17,
+        eOpRef16        = 0x18,
+        eOpRef32        = 0x19,
+        eOpRef64        = 0x1a,
+        eOpIfGoto       = 0x20,     // 2 byte operand: pop, branch if non-zero
+        eOpGoto         = 0x21,     // 2 byte operand
+        eOpConst8       = 0x22,
+        eOpConst16      = 0x23,
+        eOpConst32      = 0x24,
+        eOpConst64      = 0x25,
+        eOpReg          = 0x26,     // 2 byte operand: register number
+        eOpEnd          = 0x27,
+        eOpDup          = 0x28,
+        eOpPop          = 0x29,
+        eOpZeroExt      = 0x2a,     // 1 byte operand: zero extend from N bits
+        eOpSwap         = 0x2b
+    };
+
+    GDBRemoteAgentExpression ();
+
+    ~GDBRemoteAgentExpression ();
+
+    void
+    Clear ()
+    {
+        m_bytes.clear();
+    }
+
+    bool
+    IsEmpty () const
+    {
+        return m_bytes.empty();
+    }
+
+    const std::vector<uint8_t> &
+    GetBytes () const
+    {
+        return m_bytes;
+    }
+
+    //------------------------------------------------------------------
+    // Building expressions
+    //------------------------------------------------------------------
+    void
+    AppendOpcode (OpCode op);
+
+    // Push \a value with the smallest constN opcode that holds it.
+    void
+    AppendConstant (uint64_t value);
+
+    void
+    AppendRegister (uint32_t reg_num);
+
+    // Replace the address on the top of the stack with the \a byte_size
+    // byte value stored there.
+    bool
+    AppendMemoryRef (uint32_t byte_size);
+
+    // Sign or zero extend the top of the stack from \a byte_size bytes.
+    void
+    AppendExtend (uint32_t byte_size, bool is_signed);
+
+    // Append a goto or if_goto and return its offset for PatchBranch.
+    size_t
+    AppendBranch (OpCode op);
+
+    // Make the branch at \a branch_offset jump to \a target_offset.
+    void
+    PatchBranch (size_t branch_offset, size_t target_offset);
+
+    //------------------------------------------------------------------
+    /// Append the ";X<len>,<hex>" form of this expression used in
+    /// the condition list of a Z packet.
+    //------------------------------------------------------------------
+    void
+    AppendToPacket (std::string &packet) const;
+
+    //------------------------------------------------------------------
+    /// Compile the breakpoint condition \a condition for the code
+    /// address \a addr into an agent expression. Only conditions that
+    /// CompiledCondition accepts, that do not use floating point values,
+    /// and whose variables live in registers or at fixed offsets from a
+    /// register or the frame base can be compiled.
+    ///
+    /// @param[in] reg_info
+    ///     The register numbering of the remote stub.
+    //------------------------------------------------------------------
+    static bool
+    CompileBreakpointCondition (const char *condition,
+                                const lldb_private::Address &addr,
+                                lldb_private::Target &target,
+                                const DynamicRegisterInfo &reg_info,
+                                GDBRemoteAgentExpression &expr,
+                                lldb_private::Error &error);
+
+protected:
+    std::vector<uint8_t> m_bytes;
+};
+
+#endif  // liblldb_GDBRemoteAgentExpression_h_
@@ -70,6 +70,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient(bool is_platform) :
     m_supports_qXfer_libraries_read (eLazyBoolCalculate),
     m_supports_qXfer_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_augmented_libraries_svr4_read (eLazyBoolCalculate),
+    m_supports_conditional_breakpoints (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
     m_supports_qfProcessInfo (true),
     m_supports_qUserName (true),
@@ -188,6 +189,16 @@ GDBRemoteCommunicationClient::GetQXferLibrariesReadSupported ()
     return (m_supports_qXfer_libraries_read == eLazyBoolYes);
 }
 
+bool
+GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported ()
+{
+    if (m_supports_conditional_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return (m_supports_conditional_breakpoints == eLazyBoolYes);
+}
+
 bool
 GDBRemoteCommunicationClient::GetQXferAuxvReadSupported ()
 {
@@ -309,6 +320,7 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings()
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+    m_supports_conditional_breakpoints = eLazyBoolCalculate;
 
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
@@ -336,6 +348,7 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_read = eLazyBoolNo;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
+    m_supports_conditional_breakpoints = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
 
     StringExtractorGDBRemote response;
@@ -355,6 +368,8 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
         }
         if (::strstr (response_cstr, "qXfer:libraries:read+"))
             m_supports_qXfer_libraries_read = eLazyBoolYes;
+        if (::strstr (response_cstr, "ConditionalBreakpoints+"))
+            m_supports_conditional_breakpoints = eLazyBoolYes;
 
         const char *packet_size_str = ::strstr (response_cstr, "PacketSize=");
         if (packet_size_str)
@@ -2683,25 +2698,19 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (lldb::tid_t tid, StringExtracto
 
 
 uint8_t
-GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
+GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length, const char *cond_list)
 {
     // Check if the stub is known not to support this breakpoint type
     if (!SupportsGDBStoppointPacket(type))
         return UINT8_MAX;
     // Construct the breakpoint packet
-    char packet[64];
-    const int packet_len = ::snprintf (packet, 
-                                       sizeof(packet), 
-                                       "%c%i,%" PRIx64 ",%x",
-                                       insert ? 'Z' : 'z', 
-                                       type, 
-                                       addr, 
-                                       length);
-    // Check we havent overwritten the end of the packet buffer
-    assert (packet_len + 1 < (int)sizeof(packet));
+    StreamString packet;
+    packet.Printf ("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr, length);
+    if (insert && cond_list && cond_list[0])
+        packet.PutCString (cond_list);
     StringExtractorGDBRemote response;
     // Try to send the breakpoint packet, and check that it was correctly sent
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, true) == PacketResult::Success)
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) == PacketResult::Success)
     {
         // Receive and OK packet when the breakpoint successfully placed
         if (response.IsOKResponse())
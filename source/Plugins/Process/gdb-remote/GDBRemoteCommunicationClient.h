@@ -363,7 +363,8 @@ public:
     SendGDBStoppointTypePacket (GDBStoppointType type,   // Type of breakpoint or watchpoint
                                 bool insert,              // Insert or remove?
                                 lldb::addr_t addr,        // Address of breakpoint or watchpoint
-                                uint32_t length);         // Byte Size of breakpoint or watchpoint
+                                uint32_t length,          // Byte Size of breakpoint or watchpoint
+                                const char *cond_list = NULL); // Conditions appended to a Z0 or Z1 packet, e.g. ";X3,220127"
 
     void
     TestPacketSpeed (const uint32_t num_packets);
@@ -386,6 +387,13 @@ public:
     bool
     GetQXferAuxvReadSupported ();
 
+    //------------------------------------------------------------------
+    /// Returns true if the stub evaluates agent expression conditions
+    /// sent with Z0 and Z1 packets ("ConditionalBreakpoints+").
+    //------------------------------------------------------------------
+    bool
+    GetConditionalBreakpointsSupported ();
+
     bool
     GetQXferLibrariesReadSupported ();
 
@@ -532,6 +540,7 @@ protected:
     lldb_private::LazyBool m_supports_qXfer_libraries_read;
     lldb_private::LazyBool m_supports_qXfer_libraries_svr4_read;
     lldb_private::LazyBool m_supports_augmented_libraries_svr4_read;
+    lldb_private::LazyBool m_supports_conditional_breakpoints;
 
     bool
         m_supports_qProcessInfoPID:1,
@@ -28,6 +28,8 @@
 
 // Other libraries and framework includes
 
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointOptions.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ArchSpec.h"
@@ -64,6 +66,7 @@
 #include "Plugins/Process/Utility/StopInfoMachException.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Utility/StringExtractorGDBRemote.h"
+#include "GDBRemoteAgentExpression.h"
 #include "GDBRemoteRegisterContext.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
@@ -100,13 +103,15 @@ namespace {
     {
         { "packet-timeout" , OptionValue::eTypeUInt64 , true , 1, NULL, NULL, "Specify the default packet timeout in seconds." },
         { "target-definition-file" , OptionValue::eTypeFileSpec , true, 0 , NULL, NULL, "The file that provides the description for remote target registers." },
+        { "target-side-breakpoint-conditions" , OptionValue::eTypeBoolean , true, false, NULL, NULL, "If true, simple breakpoint conditions are handed to remote stubs that can evaluate them, so the stub only stops when the breakpoint should stop." },
         {  NULL            , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
     };
     
     enum
     {
         ePropertyPacketTimeout,
-        ePropertyTargetDefinitionFile
+        ePropertyTargetDefinitionFile,
+        ePropertyTargetSideBreakpointConditions
     };
     
     class PluginProperties : public Properties
@@ -151,6 +156,13 @@ namespace {
             const uint32_t idx = ePropertyTargetDefinitionFile;
             return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
         }
+
+        bool
+        GetTargetSideBreakpointConditions () const
+        {
+            const uint32_t idx = ePropertyTargetSideBreakpointConditions;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+        }
     };
     
     typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -281,7 +293,8 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_waiting_for_attach (false),
     m_destroy_tried_resuming (false),
     m_command_sp (),
-    m_breakpoint_pc_offset (0)
+    m_breakpoint_pc_offset (0),
+    m_stub_bp_conditions ()
 {
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncThreadShouldExit,   "async thread should exit");
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncContinue,           "async thread continue");
@@ -1159,6 +1172,8 @@ ProcessGDBRemote::DoResume ()
     if (log)
         log->Printf ("ProcessGDBRemote::Resume()");
     
+    SyncStubBreakpointConditions ();
+
     Listener listener ("gdb-remote.resume-packet-sent");
     if (listener.StartListeningForEvents (&m_gdb_comm, GDBRemoteCommunication::eBroadcastBitRunPacketSent))
     {
@@ -2341,14 +2356,20 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     // attempt to set a software breakpoint. HardwareRequired() also queries a boolean variable which
     // indicates if the user specifically asked for hardware breakpoints.  If true then we will
     // skip over software breakpoints.
+    // Stubs that can evaluate conditions get them along with the Z0 or Z1
+    // packet.
+    const std::string cond_list (GetStubConditionList (*bp_site));
+
     if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) && (!bp_site->HardwareRequired()))
     {
         // Try to send off a software breakpoint packet ($Z0)
-        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size) == 0)
+        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size, cond_list.c_str()) == 0)
         {
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
             bp_site->SetType(BreakpointSite::eExternal);
+            if (m_gdb_comm.GetConditionalBreakpointsSupported())
+                m_stub_bp_conditions[site_id].sent_conditions = cond_list;
             return error;
         }
 
@@ -2377,11 +2398,13 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointHardware))
     {
         // Try to send off a hardware breakpoint packet ($Z1)
-        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointHardware, true, addr, bp_op_size) == 0)
+        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointHardware, true, addr, bp_op_size, cond_list.c_str()) == 0)
         {
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
             bp_site->SetType(BreakpointSite::eHardware);
+            if (m_gdb_comm.GetConditionalBreakpointsSupported())
+                m_stub_bp_conditions[site_id].sent_conditions = cond_list;
             return error;
         }
 
@@ -2412,6 +2435,123 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     return EnableSoftwareBreakpoint(bp_site);
 }
 
+//----------------------------------------------------------------------
+// Build the conditions to send with the Z packet for a breakpoint site:
+// an agent expression for the breakpoint condition.  An empty list means
+// the stub stops on every hit and lldb sorts out whether to stop as usual.
+//----------------------------------------------------------------------
+std::string
+ProcessGDBRemote::GetStubConditionList (BreakpointSite &bp_site)
+{
+    std::string cond_list;
+
+    if (!GetGlobalPluginProperties()->GetTargetSideBreakpointConditions())
+        return cond_list;
+
+    if (!m_gdb_comm.GetConditionalBreakpointsSupported())
+        return cond_list;
+
+    // The stub only knows about addresses, so only sites that belong to a
+    // single breakpoint location can be handed off.
+    if (bp_site.GetNumberOfOwners() != 1)
+        return cond_list;
+    BreakpointLocationSP loc_sp (bp_site.GetOwnerAtIndex (0));
+    if (!loc_sp)
+        return cond_list;
+    Breakpoint &breakpoint = loc_sp->GetBreakpoint();
+
+    // Thread specific breakpoints are checked by lldb, and synchronous
+    // callbacks must see every hit whatever the condition says.
+    const BreakpointOptions *options = loc_sp->GetOptionsNoCreate();
+    if (options->GetThreadSpecNoCreate() != NULL)
+        return cond_list;
+    if ((options->HasCallback() && options->IsCallbackSynchronous()) ||
+        (breakpoint.GetOptions()->HasCallback() && breakpoint.GetOptions()->IsCallbackSynchronous()))
+        return cond_list;
+
+    // lldb ignores hits before looking at the condition, so the stub
+    // can't be handed the condition until the ignore count has run out.
+    size_t condition_hash = 0;
+    const char *condition = loc_sp->GetConditionText (&condition_hash);
+    if (condition == NULL || loc_sp->GetHitsToIgnore() > 0)
+        return cond_list;
+
+    StubBreakpointConditions &stub_conditions = m_stub_bp_conditions[bp_site.GetID()];
+    if (!stub_conditions.compiled || stub_conditions.condition_hash != condition_hash)
+    {
+        Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+        stub_conditions.compiled = true;
+        stub_conditions.condition_hash = condition_hash;
+        stub_conditions.compiled_conditions.clear();
+
+        GDBRemoteAgentExpression expr;
+        Error error;
+        if (GDBRemoteAgentExpression::CompileBreakpointCondition (condition,
+                                                                  loc_sp->GetAddress(),
+                                                                  GetTarget(),
+                                                                  m_register_info,
+                                                                  expr,
+                                                                  error))
+        {
+            expr.AppendToPacket (stub_conditions.compiled_conditions);
+            if (log)
+                log->Printf ("ProcessGDBRemote::GetStubConditionList (site_id = %" PRIu64 ") condition \"%s\" compiled to %s",
+                             (uint64_t)bp_site.GetID(), condition, stub_conditions.compiled_conditions.c_str());
+        }
+        else if (log)
+            log->Printf ("ProcessGDBRemote::GetStubConditionList (site_id = %" PRIu64 ") condition \"%s\" will be evaluated by lldb: %s",
+                         (uint64_t)bp_site.GetID(), condition, error.AsCString());
+    }
+    return stub_conditions.compiled_conditions;
+}
+
+//----------------------------------------------------------------------
+// Conditions and ignore counts can change while the process is stopped
+// without the breakpoint site being touched, so bring the stub up to
+// date before resuming.  Re-inserting a breakpoint replaces its
+// conditions.
+//----------------------------------------------------------------------
+void
+ProcessGDBRemote::SyncStubBreakpointConditions ()
+{
+    if (m_stub_bp_conditions.empty())
+        return;
+
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    BreakpointSiteList &bp_site_list = GetBreakpointSiteList();
+    StubBreakpointConditionsMap::iterator pos = m_stub_bp_conditions.begin();
+    while (pos != m_stub_bp_conditions.end())
+    {
+        BreakpointSiteSP bp_site_sp (bp_site_list.FindByID (pos->first));
+        if (!bp_site_sp)
+        {
+            m_stub_bp_conditions.erase (pos++);
+            continue;
+        }
+
+        const BreakpointSite::Type bp_type = bp_site_sp->GetType();
+        if (bp_site_sp->IsEnabled() && (bp_type == BreakpointSite::eExternal || bp_type == BreakpointSite::eHardware))
+        {
+            const std::string cond_list (GetStubConditionList (*bp_site_sp));
+            if (cond_list != pos->second.sent_conditions)
+            {
+                const GDBStoppointType stoppoint_type = bp_type == BreakpointSite::eHardware ? eBreakpointHardware : eBreakpointSoftware;
+                const addr_t addr = bp_site_sp->GetLoadAddress();
+                if (log)
+                    log->Printf ("ProcessGDBRemote::SyncStubBreakpointConditions (site_id = %" PRIu64 ") addr = 0x%" PRIx64 " conditions = \"%s\"",
+                                 (uint64_t)pos->first, (uint64_t)addr, cond_list.c_str());
+                if (m_gdb_comm.SendGDBStoppointTypePacket (stoppoint_type,
+                                                           true,
+                                                           addr,
+                                                           GetSoftwareBreakpointTrapOpcode (bp_site_sp.get()),
+                                                           cond_list.c_str()) == 0)
+                    pos->second.sent_conditions = cond_list;
+            }
+        }
+        ++pos;
+    }
+}
+
 Error
 ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
 {
@@ -2445,7 +2585,13 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
             break;
         }
         if (error.Success())
+        {
             bp_site->SetEnabled(false);
+            // Removing the breakpoint drops its conditions in the stub.
+            StubBreakpointConditionsMap::iterator pos = m_stub_bp_conditions.find (site_id);
+            if (pos != m_stub_bp_conditions.end())
+                pos->second.sent_conditions.clear();
+        }
     }
     else
     {
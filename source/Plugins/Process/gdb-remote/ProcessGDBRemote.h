@@ -14,6 +14,7 @@
 
 // C++ Includes
 #include <list>
+#include <map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -344,6 +345,33 @@ protected:
     bool m_destroy_tried_resuming;
     lldb::CommandObjectSP m_command_sp;
     int64_t m_breakpoint_pc_offset;
+
+    // What the stub was told to evaluate for a breakpoint site it inserted
+    // with a Z0 or Z1 packet.
+    struct StubBreakpointConditions
+    {
+        StubBreakpointConditions () :
+            condition_hash (0),
+            compiled (false),
+            compiled_conditions (),
+            sent_conditions ()
+        {
+        }
+
+        size_t condition_hash;              // The condition compiled_conditions was made from
+        bool compiled;
+        std::string compiled_conditions;    // ";X..." or empty if the condition couldn't be compiled
+        std::string sent_conditions;        // The cond_list sent with the last Z packet
+    };
+    typedef std::map<lldb::break_id_t, StubBreakpointConditions> StubBreakpointConditionsMap;
+    StubBreakpointConditionsMap m_stub_bp_conditions;
+
+    std::string
+    GetStubConditionList (lldb_private::BreakpointSite &bp_site);
+
+    void
+    SyncStubBreakpointConditions ();
+
     
     bool
     StartAsyncThread ();
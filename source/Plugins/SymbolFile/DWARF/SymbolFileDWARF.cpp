@@ -2784,16 +2784,11 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
                         bool force_check_line_table = false;
                         if (resolve_scope & (eSymbolContextFunction | eSymbolContextBlock))
                         {
+                            // Only look up the function DIE, the function
+                            // finds the block with its block range index
+                            // which is much faster than searching the DIEs.
                             DWARFDebugInfoEntry *function_die = NULL;
-                            DWARFDebugInfoEntry *block_die = NULL;
-                            if (resolve_scope & eSymbolContextBlock)
-                            {
-                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, &block_die);
-                            }
-                            else
-                            {
-                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, NULL);
-                            }
+                            dwarf_cu->LookupAddress(file_vm_addr, &function_die, NULL);
 
                             if (function_die != NULL)
                             {
@@ -2818,12 +2813,14 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
 
                                 if (resolve_scope & eSymbolContextBlock)
                                 {
-                                    Block& block = sc.function->GetBlock (true);
-
-                                    if (block_die != NULL)
-                                        sc.block = block.FindBlockByID (MakeUserID(block_die->GetOffset()));
-                                    else
-                                        sc.block = block.FindBlockByID (MakeUserID(function_die->GetOffset()));
+                                    // With a debug map, the function's address
+                                    // range is in the executable, not the .o file.
+                                    Address block_addr (so_addr);
+                                    sc.block = NULL;
+                                    if (FixupAddress (block_addr))
+                                        sc.block = sc.function->FindBlockContainingAddress (block_addr);
+                                    if (sc.block == NULL)
+                                        sc.block = &sc.function->GetBlock (true);
                                     if (sc.block)
                                         resolved |= eSymbolContextBlock;
                                 }
@@ -2939,8 +2936,7 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
                                             if (file_vm_addr != LLDB_INVALID_ADDRESS)
                                             {
                                                 DWARFDebugInfoEntry *function_die = NULL;
-                                                DWARFDebugInfoEntry *block_die = NULL;
-                                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, resolve_scope & eSymbolContextBlock ? &block_die : NULL);
+                                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, NULL);
 
                                                 if (function_die != NULL)
                                                 {
@@ -2951,12 +2947,10 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
 
                                                 if (sc.function != NULL)
                                                 {
-                                                    Block& block = sc.function->GetBlock (true);
-
-                                                    if (block_die != NULL)
-                                                        sc.block = block.FindBlockByID (MakeUserID(block_die->GetOffset()));
-                                                    else
-                                                        sc.block = block.FindBlockByID (MakeUserID(function_die->GetOffset()));
+                                                    if (resolve_scope & eSymbolContextBlock)
+                                                        sc.block = sc.function->FindBlockContainingAddress (sc.line_entry.range.GetBaseAddress());
+                                                    if (sc.block == NULL)
+                                                        sc.block = &sc.function->GetBlock (true);
                                                 }
                                             }
                                         }
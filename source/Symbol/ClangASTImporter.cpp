@@ -13,6 +13,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ClangASTImporter.h"
 #include "lldb/Symbol/ClangExternalASTSourceCommon.h"
@@ -21,8 +22,8 @@
 using namespace lldb_private;
 using namespace clang;
 
-ClangASTMetrics::Counters ClangASTMetrics::global_counters = { 0, 0, 0, 0, 0, 0 };
-ClangASTMetrics::Counters ClangASTMetrics::local_counters = { 0, 0, 0, 0, 0, 0 };
+ClangASTMetrics::Counters ClangASTMetrics::global_counters = { 0, 0, 0, 0, 0, 0, 0, 0 };
+ClangASTMetrics::Counters ClangASTMetrics::local_counters = { 0, 0, 0, 0, 0, 0, 0, 0 };
 
 void ClangASTMetrics::DumpCounters (Log *log, ClangASTMetrics::Counters &counters)
 {
@@ -32,6 +33,8 @@ void ClangASTMetrics::DumpCounters (Log *log, ClangASTMetrics::Counters &counter
     log->Printf("  Number of imports conducted by Clang       : %" PRIu64, counters.m_clang_import_count);
     log->Printf("  Number of Decls completed                  : %" PRIu64, counters.m_decls_completed_count);
     log->Printf("  Number of records laid out                 : %" PRIu64, counters.m_record_layout_count);
+    log->Printf("  Number of field types left incomplete      : %" PRIu64, counters.m_decls_deferred_count);
+    log->Printf("  Time spent importing and completing Decls  : %.6f sec", counters.m_import_time_nsec / 1000000000.0);
 }
 
 void ClangASTMetrics::DumpCounters (Log *log)
@@ -46,11 +49,50 @@ void ClangASTMetrics::DumpCounters (Log *log)
     DumpCounters (log, local_counters);
 }
 
+// Imports on different threads nest separately, so each thread keeps its
+// own import timer depth, stored directly in the thread local slot.
+static lldb::thread_key_t
+GetImportTimerDepthKey ()
+{
+    static lldb::thread_key_t g_key = Host::ThreadLocalStorageCreate (NULL);
+    return g_key;
+}
+
+static uintptr_t
+AdjustImportTimerDepth (intptr_t delta)
+{
+    const lldb::thread_key_t key = GetImportTimerDepthKey ();
+    const uintptr_t depth = (uintptr_t)Host::ThreadLocalStorageGet (key);
+    Host::ThreadLocalStorageSet (key, (void *)(depth + delta));
+    return depth;
+}
+
+ClangASTMetrics::ScopedImportTimer::ScopedImportTimer () :
+    m_start (),
+    m_outermost (AdjustImportTimerDepth (1) == 0)
+{
+    if (m_outermost)
+        m_start = TimeValue::Now();
+}
+
+ClangASTMetrics::ScopedImportTimer::~ScopedImportTimer ()
+{
+    AdjustImportTimerDepth (-1);
+    if (m_outermost)
+    {
+        const uint64_t elapsed_nsec = TimeValue::Now() - m_start;
+        global_counters.m_import_time_nsec += elapsed_nsec;
+        local_counters.m_import_time_nsec += elapsed_nsec;
+    }
+}
+
 clang::QualType
 ClangASTImporter::CopyType (clang::ASTContext *dst_ast,
                             clang::ASTContext *src_ast,
                             clang::QualType type)
 {
+    ClangASTMetrics::ScopedImportTimer import_timer;
+    
     MinionSP minion_sp (GetMinion(dst_ast, src_ast));
     
     if (minion_sp)
@@ -72,6 +114,8 @@ ClangASTImporter::CopyDecl (clang::ASTContext *dst_ast,
                             clang::ASTContext *src_ast,
                             clang::Decl *decl)
 {
+    ClangASTMetrics::ScopedImportTimer import_timer;
+    
     MinionSP minion_sp;
     
     minion_sp = GetMinion(dst_ast, src_ast);
@@ -114,6 +158,8 @@ ClangASTImporter::DeportType (clang::ASTContext *dst_ctx,
                               clang::ASTContext *src_ctx,
                               lldb::clang_type_t type)
 {    
+    ClangASTMetrics::ScopedImportTimer import_timer;
+    
     MinionSP minion_sp (GetMinion (dst_ctx, src_ctx));
     
     if (!minion_sp)
@@ -141,6 +187,8 @@ ClangASTImporter::DeportDecl (clang::ASTContext *dst_ctx,
                               clang::ASTContext *src_ctx,
                               clang::Decl *decl)
 {
+    ClangASTMetrics::ScopedImportTimer import_timer;
+    
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
     
     if (log)
@@ -220,6 +268,7 @@ bool
 ClangASTImporter::CompleteTagDecl (clang::TagDecl *decl)
 {
     ClangASTMetrics::RegisterDeclCompletion();
+    ClangASTMetrics::ScopedImportTimer import_timer;
     
     DeclOrigin decl_origin = GetDeclOrigin(decl);
     
@@ -241,6 +290,7 @@ bool
 ClangASTImporter::CompleteTagDeclWithOrigin(clang::TagDecl *decl, clang::TagDecl *origin_decl)
 {
     ClangASTMetrics::RegisterDeclCompletion();
+    ClangASTMetrics::ScopedImportTimer import_timer;
 
     clang::ASTContext *origin_ast_ctx = &origin_decl->getASTContext();
         
@@ -265,6 +315,7 @@ bool
 ClangASTImporter::CompleteObjCInterfaceDecl (clang::ObjCInterfaceDecl *interface_decl)
 {
     ClangASTMetrics::RegisterDeclCompletion();
+    ClangASTMetrics::ScopedImportTimer import_timer;
     
     DeclOrigin decl_origin = GetDeclOrigin(interface_decl);
     
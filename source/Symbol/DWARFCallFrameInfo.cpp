@@ -38,7 +38,15 @@ DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile& objfile, SectionSP& section_s
     m_cfi_data_initialized (false),
     m_fde_index (),
     m_fde_index_initialized (false),
-    m_is_eh_frame (is_eh_frame)
+    m_fde_index_mutex (Mutex::eMutexTypeRecursive),
+    m_is_eh_frame (is_eh_frame),
+    m_hdr_section_sp (),
+    m_hdr_data (),
+    m_hdr_parsed (false),
+    m_hdr_table_offset (0),
+    m_hdr_fde_count (0),
+    m_hdr_table_enc (DW_EH_PE_omit),
+    m_hdr_entry_size (0)
 {
 }
 
@@ -46,6 +54,16 @@ DWARFCallFrameInfo::~DWARFCallFrameInfo()
 {
 }
 
+void
+DWARFCallFrameInfo::SetEHFrameHdrSection (const SectionSP &section_sp)
+{
+    Mutex::Locker locker(m_fde_index_mutex);
+    m_hdr_section_sp = section_sp;
+    m_hdr_data.Clear();
+    m_hdr_parsed = false;
+    m_hdr_fde_count = 0;
+}
+
 
 bool
 DWARFCallFrameInfo::GetUnwindPlan (Address addr, UnwindPlan& unwind_plan)
@@ -73,14 +91,11 @@ DWARFCallFrameInfo::GetAddressRange (Address addr, AddressRange &range)
     if (module_sp.get() == NULL || module_sp->GetObjectFile() == NULL || module_sp->GetObjectFile() != &m_objfile)
         return false;
 
-    if (m_section_sp.get() == NULL || m_section_sp->IsEncrypted())
-        return false;
-    GetFDEIndex();
-    FDEEntryMap::Entry *fde_entry = m_fde_index.FindEntryThatContains (addr.GetFileAddress());
-    if (!fde_entry)
+    FDEEntryMap::Entry fde_entry;
+    if (GetFDEEntryByFileAddress (addr.GetFileAddress(), fde_entry) == false)
         return false;
 
-    range = AddressRange(fde_entry->base, fde_entry->size, m_objfile.GetSectionList());
+    range = AddressRange(fde_entry.base, fde_entry.size, m_objfile.GetSectionList());
     return true;
 }
 
@@ -90,6 +105,17 @@ DWARFCallFrameInfo::GetFDEEntryByFileAddress (addr_t file_addr, FDEEntryMap::Ent
     if (m_section_sp.get() == NULL || m_section_sp->IsEncrypted())
         return false;
 
+    // Until someone needs the complete FDE index, answer single address
+    // lookups with a binary search of the .eh_frame_hdr table.  When the
+    // table is usable it covers every FDE in the section, so a miss there
+    // is authoritative and there's no need to fall back to a full scan.
+    if (m_fde_index_initialized == false)
+    {
+        Mutex::Locker locker(m_fde_index_mutex);
+        if (m_fde_index_initialized == false && ParseEHFrameHdr())
+            return GetFDEEntryFromSearchTable (file_addr, fde_entry);
+    }
+
     GetFDEIndex();
 
     if (m_fde_index.IsEmpty())
@@ -126,6 +152,8 @@ DWARFCallFrameInfo::GetFunctionAddressAndSizeVector (FunctionAddressAndSizeVecto
 const DWARFCallFrameInfo::CIE*
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 {
+    Mutex::Locker locker(m_fde_index_mutex);
+
     cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
     if (pos != m_cie_map.end())
@@ -136,6 +164,26 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 
         return pos->second.get();
     }
+
+    // FDEs found through the .eh_frame_hdr table can reference CIEs that
+    // we haven't come across yet since we don't scan the section up front.
+    if (m_fde_index_initialized == false && m_hdr_fde_count > 0)
+    {
+        if (m_cfi_data_initialized == false)
+            GetCFIData();
+        if (m_cfi_data.ValidOffsetForDataOfSize (cie_offset, CFI_HEADER_SIZE))
+        {
+            lldb::offset_t offset = cie_offset;
+            const uint32_t length = m_cfi_data.GetU32(&offset);
+            const dw_offset_t cie_id = m_cfi_data.GetU32(&offset);
+            if (length > 0 && cie_id == 0)
+            {
+                CIESP cie_sp = ParseCIE (cie_offset);
+                m_cie_map[cie_offset] = cie_sp;
+                return cie_sp.get();
+            }
+        }
+    }
     return NULL;
 }
 
@@ -176,9 +224,19 @@ DWARFCallFrameInfo::ParseCIE (const dw_offset_t cie_offset)
             Host::SystemLog (Host::eSystemLogError, "CIE parse error: CIE augmentation string was too large for the fixed sized buffer of %d bytes.\n", CFI_AUG_MAX_SIZE);
             return cie_sp;
         }
+        if (!m_is_eh_frame && cie_sp->version >= 4)
+        {
+            // DWARF4 debug_frame CIEs have address_size and segment_size fields
+            m_cfi_data.GetU8(&offset); // address_size
+            m_cfi_data.GetU8(&offset); // segment_size
+        }
         cie_sp->code_align = (uint32_t)m_cfi_data.GetULEB128(&offset);
         cie_sp->data_align = (int32_t)m_cfi_data.GetSLEB128(&offset);
-        cie_sp->return_addr_reg_num = m_cfi_data.GetU8(&offset);
+        // The return address register is a ubyte in version 1 and a ULEB128 afterwards
+        if (cie_sp->version == 1)
+            cie_sp->return_addr_reg_num = m_cfi_data.GetU8(&offset);
+        else
+            cie_sp->return_addr_reg_num = (uint32_t)m_cfi_data.GetULEB128(&offset);
 
         if (cie_sp->augmentation[0])
         {
@@ -302,6 +360,7 @@ DWARFCallFrameInfo::ParseCIE (const dw_offset_t cie_offset)
 void
 DWARFCallFrameInfo::GetCFIData()
 {
+    Mutex::Locker locker(m_fde_index_mutex);
     if (m_cfi_data_initialized == false)
     {
         Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
@@ -341,14 +400,21 @@ DWARFCallFrameInfo::GetFDEIndex ()
         dw_offset_t next_entry = current_entry + len + 4;
         dw_offset_t cie_id = m_cfi_data.GetU32 (&offset);
 
-        if (cie_id == 0 || cie_id == UINT32_MAX || len == 0)
+        // eh_frame CIEs have an id of 0, debug_frame CIEs use UINT32_MAX
+        const bool is_cie = m_is_eh_frame ? cie_id == 0 : cie_id == UINT32_MAX;
+        if (is_cie || len == 0)
         {
-            m_cie_map[current_entry] = ParseCIE (current_entry);
+            // Lookups through the .eh_frame_hdr table may already have parsed this CIE
+            CIESP &cie_sp = m_cie_map[current_entry];
+            if (cie_sp.get() == NULL)
+                cie_sp = ParseCIE (current_entry);
             offset = next_entry;
             continue;
         }
 
-        const dw_offset_t cie_offset = current_entry + 4 - cie_id;
+        // An eh_frame FDE's CIE pointer is relative to the FDE, while in
+        // debug_frame it is an offset from the start of the section.
+        const dw_offset_t cie_offset = m_is_eh_frame ? current_entry + 4 - cie_id : cie_id;
         const CIE *cie = GetCIE (cie_offset);
         if (cie)
         {
@@ -375,6 +441,167 @@ DWARFCallFrameInfo::GetFDEIndex ()
     m_fde_index_initialized = true;
 }
 
+// Read the .eh_frame_hdr header and check that its binary search table can
+// be used for lookups in our eh_frame section.  The layout is:
+//
+//   uint8_t  version             (always 1)
+//   uint8_t  eh_frame_ptr_enc    DW_EH_PE encoding of eh_frame_ptr
+//   uint8_t  fde_count_enc       DW_EH_PE encoding of fde_count
+//   uint8_t  table_enc           DW_EH_PE encoding of the table entries
+//   encoded  eh_frame_ptr        address of the start of .eh_frame
+//   encoded  fde_count           number of entries in the table
+//   encoded  table[fde_count]    (initial_loc, fde_address) pairs sorted by initial_loc
+//
+// Table entries are data relative (to the start of .eh_frame_hdr) in
+// practice, but any fixed size encoding is accepted.
+// Must be called with m_fde_index_mutex held.
+
+bool
+DWARFCallFrameInfo::ParseEHFrameHdr ()
+{
+    if (m_hdr_parsed)
+        return m_hdr_fde_count > 0;
+
+    m_hdr_parsed = true;
+    m_hdr_fde_count = 0;
+
+    if (!m_is_eh_frame || m_hdr_section_sp.get() == NULL || m_hdr_section_sp->IsEncrypted())
+        return false;
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+
+    m_objfile.ReadSectionData (m_hdr_section_sp.get(), m_hdr_data);
+    if (!m_hdr_data.ValidOffsetForDataOfSize (0, 4))
+        return false;
+
+    lldb::offset_t offset = 0;
+    const uint8_t version = m_hdr_data.GetU8 (&offset);
+    const uint8_t eh_frame_ptr_enc = m_hdr_data.GetU8 (&offset);
+    const uint8_t fde_count_enc = m_hdr_data.GetU8 (&offset);
+    const uint8_t table_enc = m_hdr_data.GetU8 (&offset);
+
+    if (version != 1 || eh_frame_ptr_enc == DW_EH_PE_omit || fde_count_enc == DW_EH_PE_omit || table_enc == DW_EH_PE_omit)
+        return false;
+
+    uint8_t entry_size = 0;
+    switch (table_enc & DW_EH_PE_MASK_ENCODING)
+    {
+        case DW_EH_PE_udata2:
+        case DW_EH_PE_sdata2:   entry_size = 2 * 2; break;
+        case DW_EH_PE_udata4:
+        case DW_EH_PE_sdata4:   entry_size = 2 * 4; break;
+        case DW_EH_PE_udata8:
+        case DW_EH_PE_sdata8:   entry_size = 2 * 8; break;
+        case DW_EH_PE_absptr:   entry_size = 2 * m_hdr_data.GetAddressByteSize(); break;
+        default:
+            // Variable length (LEB128) entries can't be binary searched
+            return false;
+    }
+
+    const lldb::addr_t hdr_addr = m_hdr_section_sp->GetFileAddress();
+    const lldb::addr_t eh_frame_ptr = m_hdr_data.GetGNUEHPointer (&offset, eh_frame_ptr_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    const lldb::addr_t fde_count = m_hdr_data.GetGNUEHPointer (&offset, fde_count_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+
+    if (eh_frame_ptr != m_section_sp->GetFileAddress())
+    {
+        if (log)
+            m_objfile.GetModule()->LogMessage (log, ".eh_frame_hdr points to 0x%" PRIx64 " but .eh_frame is at 0x%" PRIx64 ", ignoring the search table",
+                                               eh_frame_ptr, m_section_sp->GetFileAddress());
+        return false;
+    }
+
+    if (fde_count == 0 || fde_count > UINT32_MAX || !m_hdr_data.ValidOffsetForDataOfSize (offset, fde_count * entry_size))
+        return false;
+
+    m_hdr_table_offset = offset;
+    m_hdr_table_enc = table_enc;
+    m_hdr_entry_size = entry_size;
+    m_hdr_fde_count = (uint32_t)fde_count;
+
+    if (log)
+        m_objfile.GetModule()->LogMessage (log, "Using .eh_frame_hdr search table with %u FDEs", m_hdr_fde_count);
+    return true;
+}
+
+lldb::addr_t
+DWARFCallFrameInfo::GetSearchTableInitialLocation (uint32_t idx)
+{
+    const lldb::addr_t hdr_addr = m_hdr_section_sp->GetFileAddress();
+    lldb::offset_t offset = m_hdr_table_offset + (lldb::offset_t)idx * m_hdr_entry_size;
+    return m_hdr_data.GetGNUEHPointer (&offset, m_hdr_table_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+}
+
+// Binary search the .eh_frame_hdr table for the FDE covering file_addr and
+// decode just that FDE's address range.
+// Must be called with m_fde_index_mutex held after ParseEHFrameHdr() succeeded.
+
+bool
+DWARFCallFrameInfo::GetFDEEntryFromSearchTable (addr_t file_addr, FDEEntryMap::Entry &fde_entry)
+{
+    // Find the last entry whose initial location is <= file_addr
+    uint32_t lo = 0;
+    uint32_t hi = m_hdr_fde_count;
+    while (lo < hi)
+    {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (GetSearchTableInitialLocation (mid) <= file_addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == 0)
+        return false;
+
+    const lldb::addr_t hdr_addr = m_hdr_section_sp->GetFileAddress();
+    lldb::offset_t offset = m_hdr_table_offset + (lldb::offset_t)(lo - 1) * m_hdr_entry_size;
+    const lldb::addr_t initial_loc = m_hdr_data.GetGNUEHPointer (&offset, m_hdr_table_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    const lldb::addr_t fde_addr = m_hdr_data.GetGNUEHPointer (&offset, m_hdr_table_enc, hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+
+    const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+    if (fde_addr < eh_frame_addr)
+        return false;
+
+    if (m_cfi_data_initialized == false)
+        GetCFIData();
+
+    const dw_offset_t fde_offset = (dw_offset_t)(fde_addr - eh_frame_addr);
+    if (!m_cfi_data.ValidOffsetForDataOfSize (fde_offset, CFI_HEADER_SIZE))
+        return false;
+
+    offset = fde_offset;
+    const uint32_t len = m_cfi_data.GetU32 (&offset);
+    const dw_offset_t cie_id = m_cfi_data.GetU32 (&offset);
+    if (len == 0 || cie_id == 0 || cie_id == UINT32_MAX)
+        return false;
+
+    const CIE *cie = GetCIE (fde_offset + 4 - cie_id);
+    if (cie == NULL)
+        return false;
+
+    const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+    const lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS);
+    const lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS);
+
+    if (addr != initial_loc)
+    {
+        Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+        if (log)
+            m_objfile.GetModule()->LogMessage (log, ".eh_frame_hdr entry for 0x%" PRIx64 " points to an FDE for 0x%" PRIx64, initial_loc, addr);
+        return false;
+    }
+
+    if (file_addr < addr || file_addr >= addr + length)
+        return false;
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (log)
+        m_objfile.GetModule()->LogMessage (log, ".eh_frame_hdr search table maps 0x%" PRIx64 " to the FDE at 0x%8.8x for [0x%" PRIx64 "-0x%" PRIx64 ")",
+                                           file_addr, fde_offset, addr, addr + length);
+
+    fde_entry = FDEEntryMap::Entry (addr, length, fde_offset);
+    return true;
+}
+
 bool
 DWARFCallFrameInfo::FDEToUnwindPlan (dw_offset_t dwarf_offset, Address startaddr, UnwindPlan& unwind_plan)
 {
@@ -390,7 +617,7 @@ DWARFCallFrameInfo::FDEToUnwindPlan (dw_offset_t dwarf_offset, Address startaddr
     uint32_t length = m_cfi_data.GetU32 (&offset);
     dw_offset_t cie_offset = m_cfi_data.GetU32 (&offset);
 
-    assert (cie_offset != 0 && cie_offset != UINT32_MAX);
+    assert (m_is_eh_frame ? (cie_offset != 0 && cie_offset != UINT32_MAX) : cie_offset != UINT32_MAX);
 
     // Translate the CIE_id from the eh_frame format, which
     // is relative to the FDE offset, into a __eh_frame section
@@ -90,6 +90,16 @@ FuncUnwinders::GetUnwindPlanAtCallSite (int current_offset)
                 if (!eh_frame->GetUnwindPlan (current_pc, *m_unwind_plan_call_site_sp))
                     m_unwind_plan_call_site_sp.reset();
             }
+
+            // Binaries built without asynchronous unwind tables may only describe
+            // this function in debug_frame.
+            DWARFCallFrameInfo *debug_frame = m_unwind_table.GetDebugFrameInfo();
+            if (debug_frame && m_unwind_plan_call_site_sp.get() == NULL)
+            {
+                m_unwind_plan_call_site_sp.reset (new UnwindPlan (lldb::eRegisterKindGeneric));
+                if (!debug_frame->GetUnwindPlan (current_pc, *m_unwind_plan_call_site_sp))
+                    m_unwind_plan_call_site_sp.reset();
+            }
         }
     }
     return m_unwind_plan_call_site_sp;
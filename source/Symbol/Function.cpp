@@ -8,6 +8,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Symbol/Function.h"
+
+#include <algorithm>
+
 #include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
@@ -212,7 +215,8 @@ Function::Function
     m_range (range),
     m_frame_base (),
     m_flags (),
-    m_prologue_byte_size (0)
+    m_prologue_byte_size (0),
+    m_block_ranges ()
 {
     m_block.SetParentScope(this);
     assert(comp_unit != NULL);
@@ -236,7 +240,8 @@ Function::Function
     m_range (range),
     m_frame_base (),
     m_flags (),
-    m_prologue_byte_size (0)
+    m_prologue_byte_size (0),
+    m_block_ranges ()
 {
     m_block.SetParentScope(this);
     assert(comp_unit != NULL);
@@ -322,6 +327,115 @@ Function::GetBlock (bool can_create)
     return m_block;
 }
 
+Block *
+Function::FindBlockContainingAddress (const Address &addr)
+{
+    const Address &func_addr = m_range.GetBaseAddress();
+    if (addr.GetSection() != func_addr.GetSection())
+        return NULL;
+    const addr_t addr_offset = addr.GetOffset();
+    const addr_t func_offset = func_addr.GetOffset();
+    if (addr_offset < func_offset)
+        return NULL;
+    return FindBlockContainingOffset (addr_offset - func_offset);
+}
+
+Block *
+Function::FindBlockContainingOffset (addr_t func_offset)
+{
+    GetBlock (true);
+    if (m_flags.IsClear(flagsCalculatedBlockRanges))
+    {
+        CalculateBlockRanges ();
+        m_flags.Set(flagsCalculatedBlockRanges);
+    }
+
+    if (func_offset > UINT32_MAX)
+        return NULL;
+    const BlockRangeMap::Entry *entry = m_block_ranges.FindEntryThatContains (func_offset);
+    if (entry)
+        return entry->data;
+    return NULL;
+}
+
+void
+Function::CalculateBlockRanges ()
+{
+    m_block_ranges.Clear();
+
+    // Gather the ranges of all blocks, parents before their children,
+    // along with every offset where a range starts or ends.
+    struct BlockRange
+    {
+        Block::Range range;
+        Block *block;
+        Block *parent;
+    };
+    std::vector<BlockRange> block_ranges;
+    std::vector<uint32_t> bounds;
+    std::vector<std::pair<Block *, Block *> > blocks_to_visit (1, std::make_pair (&m_block, (Block *)NULL));
+    while (!blocks_to_visit.empty())
+    {
+        Block *block = blocks_to_visit.back().first;
+        Block *parent = blocks_to_visit.back().second;
+        blocks_to_visit.pop_back();
+
+        const Block::Range *range;
+        for (uint32_t range_idx = 0; (range = block->GetRangeOffsetsAtIndex (range_idx)) != NULL; ++range_idx)
+        {
+            if (range->GetByteSize() == 0)
+                continue;
+            BlockRange block_range = { *range, block, parent };
+            block_ranges.push_back (block_range);
+            bounds.push_back (range->GetRangeBase());
+            bounds.push_back (range->GetRangeEnd());
+        }
+
+        // Push the children in reverse so they are visited in order.
+        const size_t first_child_idx = blocks_to_visit.size();
+        for (Block *child = block->GetFirstChild(); child != NULL; child = child->GetSibling())
+            blocks_to_visit.push_back (std::make_pair (child, block));
+        std::reverse (blocks_to_visit.begin() + first_child_idx, blocks_to_visit.end());
+    }
+
+    if (bounds.empty())
+        return;
+
+    std::sort (bounds.begin(), bounds.end());
+    bounds.erase (std::unique (bounds.begin(), bounds.end()), bounds.end());
+
+    // The bounds cut the function into pieces that are each entirely
+    // inside or outside of every block.  Blocks claim their pieces in the
+    // order above, but only pieces their parent holds: a child range that
+    // sticks out of its parent is cut back to it, and where siblings
+    // overlap the first one keeps the piece.  That is the block that
+    // walking down the tree from the function to the innermost block
+    // containing an address finds.
+    std::vector<Block *> innermost_blocks (bounds.size() - 1, NULL);
+    for (const BlockRange &block_range : block_ranges)
+    {
+        const uint32_t range_end = block_range.range.GetRangeEnd();
+        size_t idx = std::lower_bound (bounds.begin(), bounds.end(), block_range.range.GetRangeBase()) - bounds.begin();
+        for (; idx < innermost_blocks.size() && bounds[idx] < range_end; ++idx)
+        {
+            if (innermost_blocks[idx] == block_range.parent)
+                innermost_blocks[idx] = block_range.block;
+        }
+    }
+
+    // Adjacent pieces in the same block become a single entry.
+    size_t idx = 0;
+    while (idx < innermost_blocks.size())
+    {
+        Block *block = innermost_blocks[idx];
+        const size_t start_idx = idx;
+        while (idx < innermost_blocks.size() && innermost_blocks[idx] == block)
+            ++idx;
+        if (block)
+            m_block_ranges.Append (BlockRangeMap::Entry (bounds[start_idx], bounds[idx] - bounds[start_idx], block));
+    }
+}
+
 CompileUnit*
 Function::GetCompileUnit()
 {
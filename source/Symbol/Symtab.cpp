@@ -11,6 +11,7 @@
 
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Core/RegularExpressionSearch.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Symbol/ObjectFile.h"
@@ -716,18 +717,13 @@ Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp
     uint32_t prev_size = indexes.size();
     uint32_t sym_end = m_symbols.size();
 
+    std::vector<uint32_t> candidate_indexes;
     for (uint32_t i = 0; i < sym_end; i++)
     {
         if (symbol_type == eSymbolTypeAny || m_symbols[i].GetType() == symbol_type)
-        {
-            const char *name = m_symbols[i].GetMangled().GetName().AsCString();
-            if (name)
-            {
-                if (regexp.Execute (name))
-                    indexes.push_back(i);
-            }
-        }
+            candidate_indexes.push_back(i);
     }
+    AppendSymbolIndexesMatchingRegEx (regexp, candidate_indexes, indexes);
     return indexes.size() - prev_size;
 
 }
@@ -740,6 +736,7 @@ Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp
     uint32_t prev_size = indexes.size();
     uint32_t sym_end = m_symbols.size();
 
+    std::vector<uint32_t> candidate_indexes;
     for (uint32_t i = 0; i < sym_end; i++)
     {
         if (symbol_type == eSymbolTypeAny || m_symbols[i].GetType() == symbol_type)
@@ -747,18 +744,46 @@ Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp
             if (CheckSymbolAtIndex(i, symbol_debug_type, symbol_visibility) == false)
                 continue;
 
-            const char *name = m_symbols[i].GetMangled().GetName().AsCString();
-            if (name)
-            {
-                if (regexp.Execute (name))
-                    indexes.push_back(i);
-            }
+            candidate_indexes.push_back(i);
         }
     }
+    AppendSymbolIndexesMatchingRegEx (regexp, candidate_indexes, indexes);
     return indexes.size() - prev_size;
 
 }
 
+namespace {
+
+struct SymbolNameBaton
+{
+    const Symtab *symtab;
+    const std::vector<uint32_t> *symbol_indexes;
+};
+
+}
+
+static const char *
+GetSymbolNameAtIndex (void *baton, size_t idx)
+{
+    SymbolNameBaton *symbol_baton = (SymbolNameBaton *)baton;
+    const Symbol *symbol = symbol_baton->symtab->SymbolAtIndex ((*symbol_baton->symbol_indexes)[idx]);
+    return symbol->GetMangled().GetName().AsCString();
+}
+
+void
+Symtab::AppendSymbolIndexesMatchingRegEx (const RegularExpression &regexp, const std::vector<uint32_t> &candidate_indexes, std::vector<uint32_t>& indexes)
+{
+    // Getting the names can demangle, so they are fetched on the search
+    // threads.  Nothing else touches the symbols while m_mutex is held.
+    SymbolNameBaton baton = { this, &candidate_indexes };
+    std::vector<uint32_t> match_indexes;
+    RegularExpressionSearch search (regexp);
+    search.FindMatches (GetSymbolNameAtIndex, &baton, candidate_indexes.size(), match_indexes);
+    const size_t num_matches = match_indexes.size();
+    for (size_t i = 0; i < num_matches; ++i)
+        indexes.push_back (candidate_indexes[match_indexes[i]]);
+}
+
 Symbol *
 Symtab::FindSymbolWithType (SymbolType symbol_type, Debug symbol_debug_type, Visibility symbol_visibility, uint32_t& start_idx)
 {
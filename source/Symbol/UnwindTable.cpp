@@ -29,9 +29,12 @@ using namespace lldb_private;
 UnwindTable::UnwindTable (ObjectFile& objfile) : 
     m_object_file (objfile), 
     m_unwinds (),
+    m_lru (),
+    m_mutex (Mutex::eMutexTypeRecursive),
     m_initialized (false),
     m_assembly_profiler (NULL),
-    m_eh_frame (NULL)
+    m_eh_frame (NULL),
+    m_debug_frame (NULL)
 {
 }
 
@@ -41,16 +44,28 @@ UnwindTable::UnwindTable (ObjectFile& objfile) :
 void
 UnwindTable::Initialize ()
 {
+    Mutex::Locker locker (m_mutex);
+
     if (m_initialized)
         return;
 
     SectionList* sl = m_object_file.GetSectionList ();
-    if (sl)
+    if (sl && m_eh_frame == NULL && m_debug_frame == NULL)
     {
         SectionSP sect = sl->FindSectionByType (eSectionTypeEHFrame, true);
         if (sect.get())
         {
             m_eh_frame = new DWARFCallFrameInfo(m_object_file, sect, eRegisterKindGCC, true);
+
+            SectionSP hdr_sect = sl->FindSectionByType (eSectionTypeEHFrameHdr, true);
+            if (hdr_sect.get())
+                m_eh_frame->SetEHFrameHdrSection (hdr_sect);
+        }
+
+        sect = sl->FindSectionByType (eSectionTypeDWARFDebugFrame, true);
+        if (sect.get())
+        {
+            m_debug_frame = new DWARFCallFrameInfo(m_object_file, sect, eRegisterKindGCC, false);
         }
     }
     
@@ -66,6 +81,35 @@ UnwindTable::~UnwindTable ()
 {
     if (m_eh_frame)
         delete m_eh_frame;
+    if (m_debug_frame)
+        delete m_debug_frame;
+}
+
+// The cache is per ObjectFile so this bounds the number of functions we keep
+// UnwindPlans for in any one Module.  Unwinding a few hundred threads with deep
+// stacks rarely touches more than a few thousand distinct functions.
+size_t
+UnwindTable::GetMaximumCachedFuncUnwinders ()
+{
+    return 8192;
+}
+
+size_t
+UnwindTable::GetNumCachedFuncUnwinders ()
+{
+    Mutex::Locker locker (m_mutex);
+    return m_unwinds.size();
+}
+
+// Get the function bounds for addr from the eh_frame or debug_frame FDEs
+bool
+UnwindTable::GetAddressRangeFromCallFrameInfo (const Address& addr, AddressRange &range)
+{
+    if (m_eh_frame && m_eh_frame->GetAddressRange (addr, range))
+        return true;
+    if (m_debug_frame && m_debug_frame->GetAddressRange (addr, range))
+        return true;
+    return false;
 }
 
 FuncUnwindersSP
@@ -73,6 +117,8 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
 {
     FuncUnwindersSP no_unwind_found;
 
+    Mutex::Locker locker (m_mutex);
+
     Initialize();
 
     // There is an UnwindTable per object file, so we can safely use file handles
@@ -83,25 +129,46 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
     {
         insert_pos = m_unwinds.lower_bound (file_addr);
         iterator pos = insert_pos;
-        if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second->GetFunctionStartAddress() != addr))
+        if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second.func_unwinders_sp->GetFunctionStartAddress() != addr))
             --pos;
 
-        if (pos->second->ContainsAddress (addr))
-            return pos->second;
+        if (pos->second.func_unwinders_sp->ContainsAddress (addr))
+        {
+            m_lru.splice (m_lru.begin(), m_lru, pos->second.lru_pos);
+            return pos->second.func_unwinders_sp;
+        }
     }
 
     AddressRange range;
     if (!sc.GetAddressRange(eSymbolContextFunction | eSymbolContextSymbol, 0, false, range) || !range.GetBaseAddress().IsValid())
     {
-        // Does the eh_frame unwind info has a function bounds for this addr?
-        if (m_eh_frame == NULL || !m_eh_frame->GetAddressRange (addr, range))
+        // Does the eh_frame or debug_frame unwind info have function bounds for this addr?
+        if (!GetAddressRangeFromCallFrameInfo (addr, range))
         {
             return no_unwind_found;
         }
     }
 
     FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, m_assembly_profiler, range));
-    m_unwinds.insert (insert_pos, std::make_pair(range.GetBaseAddress().GetFileAddress(), func_unwinder_sp));
+    const addr_t func_file_addr = range.GetBaseAddress().GetFileAddress();
+    std::pair<iterator, bool> insert_result = m_unwinds.insert (std::make_pair(func_file_addr, CachedFuncUnwinders()));
+    if (!insert_result.second)
+    {
+        // A FuncUnwinders for this start address exists but didn't contain addr;
+        // replace it with the one for the current range.
+        m_lru.erase (insert_result.first->second.lru_pos);
+    }
+    m_lru.push_front (func_file_addr);
+    insert_result.first->second.func_unwinders_sp = func_unwinder_sp;
+    insert_result.first->second.lru_pos = m_lru.begin();
+
+    // Drop the least recently used FuncUnwinders if the table has grown too
+    // large.  Anyone still holding a shared pointer to one keeps it alive.
+    while (m_unwinds.size() > GetMaximumCachedFuncUnwinders())
+    {
+        m_unwinds.erase (m_lru.back());
+        m_lru.pop_back();
+    }
 //    StreamFile s(stdout, false);
 //    Dump (s);
     return func_unwinder_sp;
@@ -120,8 +187,8 @@ UnwindTable::GetUncachedFuncUnwindersContainingAddress (const Address& addr, Sym
     AddressRange range;
     if (!sc.GetAddressRange(eSymbolContextFunction | eSymbolContextSymbol, 0, false, range) || !range.GetBaseAddress().IsValid())
     {
-        // Does the eh_frame unwind info has a function bounds for this addr?
-        if (m_eh_frame == NULL || !m_eh_frame->GetAddressRange (addr, range))
+        // Does the eh_frame or debug_frame unwind info have function bounds for this addr?
+        if (!GetAddressRangeFromCallFrameInfo (addr, range))
         {
             return no_unwind_found;
         }
@@ -135,6 +202,7 @@ UnwindTable::GetUncachedFuncUnwindersContainingAddress (const Address& addr, Sym
 void
 UnwindTable::Dump (Stream &s)
 {
+    Mutex::Locker locker (m_mutex);
     s.Printf("UnwindTable for '%s':\n", m_object_file.GetFileSpec().GetPath().c_str());
     const_iterator begin = m_unwinds.begin();
     const_iterator end = m_unwinds.end();
@@ -151,3 +219,10 @@ UnwindTable::GetEHFrameInfo ()
     Initialize();
     return m_eh_frame;
 }
+
+DWARFCallFrameInfo *
+UnwindTable::GetDebugFrameInfo ()
+{
+    Initialize();
+    return m_debug_frame;
+}
@@ -10,6 +10,7 @@
 #include "lldb/Target/Memory.h"
 // C Includes
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
@@ -204,6 +205,52 @@ MemoryCache::Read (addr_t addr,
 }
 
 
+size_t
+MemoryCache::Prefetch (addr_t addr, size_t size, Error &error)
+{
+    if (size == 0)
+        return 0;
+
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+    addr_t start_addr = addr - (addr % cache_line_byte_size);
+    addr_t end_addr = addr + size;
+    if (end_addr % cache_line_byte_size)
+        end_addr += cache_line_byte_size - (end_addr % cache_line_byte_size);
+    if (end_addr <= start_addr)
+        return 0;
+
+    Mutex::Locker locker (m_mutex);
+
+    // Trim cache lines we already have off both ends so we only read what's missing
+    while (start_addr < end_addr && m_cache.find (start_addr) != m_cache.end())
+        start_addr += cache_line_byte_size;
+    while (end_addr > start_addr && m_cache.find (end_addr - cache_line_byte_size) != m_cache.end())
+        end_addr -= cache_line_byte_size;
+    if (start_addr == end_addr)
+        return 0;
+
+    if (m_invalid_ranges.FindEntryThatContains (start_addr))
+        return 0;
+
+    DataBufferHeap data (end_addr - start_addr, 0);
+    const size_t bytes_read = m_process.ReadMemoryFromInferior (start_addr, data.GetBytes(), data.GetByteSize(), error);
+
+    for (size_t offset = 0; offset < bytes_read; offset += cache_line_byte_size)
+    {
+        const addr_t curr_addr = start_addr + offset;
+        if (m_invalid_ranges.FindEntryThatContains (curr_addr))
+            break;
+        if (m_cache.find (curr_addr) != m_cache.end())
+            continue;
+        const size_t line_size = std::min<size_t> (cache_line_byte_size, bytes_read - offset);
+        m_cache[curr_addr] = DataBufferSP (new DataBufferHeap (data.GetBytes() + offset, line_size));
+        // Partial lines are handled by Read() but must be the last ones we add
+        if (line_size != cache_line_byte_size)
+            break;
+    }
+    return bytes_read;
+}
+
 
 AllocatedBlock::AllocatedBlock (lldb::addr_t addr, 
                                 uint32_t byte_size, 
@@ -356,7 +403,9 @@ AllocatedBlock::FreeBlock (addr_t addr)
 AllocatedMemoryCache::AllocatedMemoryCache (Process &process) :
     m_process (process),
     m_mutex (Mutex::eMutexTypeRecursive),
-    m_memory_map()
+    m_memory_map(),
+    m_num_process_allocations (0),
+    m_num_allocations (0)
 {
 }
 
@@ -390,20 +439,40 @@ AllocatedMemoryCache::AllocatePage (uint32_t byte_size,
     const size_t num_pages = (byte_size + page_size - 1) / page_size;
     const size_t page_byte_size = num_pages * page_size;
 
-    addr_t addr = m_process.DoAllocateMemory(page_byte_size, permissions, error);
+    // Expressions allocate many small pieces of code and data, so grab a
+    // whole arena at a time and hand it out from here.  Fall back to just
+    // what was asked for if the process can't give us that much.
+    size_t arena_byte_size = (m_process.GetExpressionArenaSize() + page_size - 1) / page_size * page_size;
+    if (arena_byte_size > UINT32_MAX)
+        arena_byte_size = UINT32_MAX / page_size * page_size;
+    addr_t addr = LLDB_INVALID_ADDRESS;
+    size_t block_byte_size = page_byte_size;
+    if (arena_byte_size > page_byte_size)
+    {
+        block_byte_size = arena_byte_size;
+        addr = m_process.DoAllocateMemory(block_byte_size, permissions, error);
+        ++m_num_process_allocations;
+    }
+    if (addr == LLDB_INVALID_ADDRESS)
+    {
+        error.Clear();
+        block_byte_size = page_byte_size;
+        addr = m_process.DoAllocateMemory(block_byte_size, permissions, error);
+        ++m_num_process_allocations;
+    }
 
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
     if (log)
     {
         log->Printf ("Process::DoAllocateMemory (byte_size = 0x%8.8zx, permissions = %s) => 0x%16.16" PRIx64,
-                     page_byte_size, 
+                     block_byte_size, 
                      GetPermissionsAsCString(permissions), 
                      (uint64_t)addr);
     }
 
     if (addr != LLDB_INVALID_ADDRESS)
     {
-        block_sp.reset (new AllocatedBlock (addr, page_byte_size, permissions, chunk_size));
+        block_sp.reset (new AllocatedBlock (addr, block_byte_size, permissions, chunk_size));
         m_memory_map.insert (std::make_pair (permissions, block_sp));
     }
     return block_sp;
@@ -422,6 +491,8 @@ AllocatedMemoryCache::AllocateMemory (size_t byte_size,
     for (PermissionsToBlockMap::iterator pos = range.first; pos != range.second; ++pos)
     {
         addr = (*pos).second->ReserveBlock (byte_size);
+        if (addr != LLDB_INVALID_ADDRESS)
+            break;
     }
     
     if (addr == LLDB_INVALID_ADDRESS)
@@ -431,9 +502,15 @@ AllocatedMemoryCache::AllocateMemory (size_t byte_size,
         if (block_sp)
             addr = block_sp->ReserveBlock (byte_size);
     }
+    ++m_num_allocations;
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
     if (log)
-        log->Printf ("AllocatedMemoryCache::AllocateMemory (byte_size = 0x%8.8zx, permissions = %s) => 0x%16.16" PRIx64, byte_size, GetPermissionsAsCString(permissions), (uint64_t)addr);
+        log->Printf ("AllocatedMemoryCache::AllocateMemory (byte_size = 0x%8.8zx, permissions = %s) => 0x%16.16" PRIx64 " (%" PRIu64 " allocations served by %" PRIu64 " process allocations)",
+                     byte_size,
+                     GetPermissionsAsCString(permissions),
+                     (uint64_t)addr,
+                     m_num_allocations,
+                     m_num_process_allocations);
     return addr;
 }
 
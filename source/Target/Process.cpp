@@ -11,6 +11,8 @@
 
 #include "lldb/Target/Process.h"
 
+#include <algorithm>
+
 #include "lldb/lldb-private-log.h"
 
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
@@ -100,6 +102,14 @@ public:
     }
 };
 
+static OptionEnumValueElement
+g_follow_fork_mode_enums[] =
+{
+    { eFollowForkParent, "parent", "Keep debugging the process that forked and let the child run (default)."},
+    { eFollowForkChild,  "child",  "Debug the child and let the process that forked run."},
+    { 0, NULL, NULL }
+};
+
 static PropertyDefinition
 g_properties[] =
 {
@@ -111,6 +121,17 @@ g_properties[] =
     { "python-os-plugin-path", OptionValue::eTypeFileSpec, false, true, NULL, NULL, "A path to a python OS plug-in module file that contains a OperatingSystemPlugIn class." },
     { "stop-on-sharedlibrary-events" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, stop when a shared library is loaded or unloaded." },
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, detach will attempt to keep the process stopped." },
+    { "expression-arena-size", OptionValue::eTypeUInt64 , false, 64 * 1024, NULL, NULL, "The minimum number of bytes to allocate at a time in the process for expression code and data.  "
+                                                                                          "The memory is handed out to expressions in small pieces and reused once they are done with it, so larger values mean fewer allocations in the process." },
+    { "non-stop-mode" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, only the thread that stops for an event is stopped and the other threads keep running, and stepping a thread only resumes that thread.  "
+                                                                            "Only supported by the Linux native process plug-in." },
+    { "displaced-stepping" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, a thread continuing from a software breakpoint runs a copy of the instruction under the breakpoint elsewhere, "
+                                                                                 "so the breakpoint stays in place and the other threads don't have to be held while it steps.  Only used on x86." },
+    { "follow-fork-mode" , OptionValue::eTypeEnum, false, eFollowForkParent, NULL, g_follow_fork_mode_enums, "Which process to debug after the process forks.  Following the child keeps the target, its modules and its breakpoints, "
+                                                                                                              "so nothing has to be loaded again.  A step that forks into a followed child stops in the child.  "
+                                                                                                              "The child must stay in the process group of the process: one that calls setsid() or setpgid() is lost, "
+                                                                                                              "and a child that starts out in another group is not followed.  Read when the process is launched or attached to.  "
+                                                                                                              "Only supported by the Linux native process plug-in." },
     {  NULL                  , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
 };
 
@@ -121,7 +142,11 @@ enum {
     ePropertyUnwindOnErrorInExpressions,
     ePropertyPythonOSPluginPath,
     ePropertyStopOnSharedLibraryEvents,
-    ePropertyDetachKeepsStopped
+    ePropertyDetachKeepsStopped,
+    ePropertyExpressionArenaSize,
+    ePropertyNonStopMode,
+    ePropertyDisplacedStepping,
+    ePropertyFollowForkMode
 };
 
 ProcessProperties::ProcessProperties (bool is_global) :
@@ -238,6 +263,55 @@ ProcessProperties::SetDetachKeepsStopped (bool stop)
     m_collection_sp->SetPropertyAtIndexAsBoolean(NULL, idx, stop);
 }
 
+uint64_t
+ProcessProperties::GetExpressionArenaSize () const
+{
+    const uint32_t idx = ePropertyExpressionArenaSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(NULL, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+ProcessProperties::GetNonStopModeEnabled () const
+{
+    const uint32_t idx = ePropertyNonStopMode;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+void
+ProcessProperties::SetNonStopModeEnabled (bool enable)
+{
+    const uint32_t idx = ePropertyNonStopMode;
+    m_collection_sp->SetPropertyAtIndexAsBoolean(NULL, idx, enable);
+}
+
+bool
+ProcessProperties::GetDisplacedSteppingEnabled () const
+{
+    const uint32_t idx = ePropertyDisplacedStepping;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+void
+ProcessProperties::SetDisplacedSteppingEnabled (bool enable)
+{
+    const uint32_t idx = ePropertyDisplacedStepping;
+    m_collection_sp->SetPropertyAtIndexAsBoolean(NULL, idx, enable);
+}
+
+FollowForkMode
+ProcessProperties::GetFollowForkMode () const
+{
+    const uint32_t idx = ePropertyFollowForkMode;
+    return (FollowForkMode)m_collection_sp->GetPropertyAtIndexAsEnumeration(NULL, idx, g_properties[idx].default_uint_value);
+}
+
+void
+ProcessProperties::SetFollowForkMode (FollowForkMode mode)
+{
+    const uint32_t idx = ePropertyFollowForkMode;
+    m_collection_sp->SetPropertyAtIndexAsEnumeration(NULL, idx, mode);
+}
+
 void
 ProcessInstanceInfo::Dump (Stream &s, Platform *platform) const
 {
@@ -1057,6 +1131,10 @@ Process::Process(Target &target, Listener &listener) :
     m_force_next_event_delivery(false),
     m_last_broadcast_state (eStateInvalid),
     m_destroy_in_process (false),
+    m_displaced_step_arena (LLDB_INVALID_ADDRESS),
+    m_displaced_step_arena_tried (false),
+    m_displaced_step_free_slots (),
+    m_displaced_step_mutex (Mutex::eMutexTypeNormal),
     m_can_jit(eCanJITDontKnow)
 {
     CheckInWithManager ();
@@ -1166,6 +1244,7 @@ Process::Finalize()
     m_image_tokens.clear();
     m_memory_cache.Clear();
     m_allocated_memory_cache.Clear();
+    ClearDisplacedStepArena();
     m_language_runtimes.clear();
     m_next_event_action_ap.reset();
 //#ifdef LLDB_CONFIGURATION_DEBUG
@@ -1748,6 +1827,12 @@ Process::Resume ()
     Log *log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_STATE | LIBLLDB_LOG_PROCESS));
     if (log)
         log->Printf("Process::Resume -- locking run lock");
+
+    // Set up the displaced stepping slots before anything is resumed, while
+    // code can still be run in the inferior to allocate them.
+    if (GetDisplacedSteppingEnabled())
+        AllocateDisplacedStepArena ();
+
     if (!m_public_run_lock.TrySetRunning())
     {
         Error error("Resume request failed - process still running.");
@@ -2462,7 +2547,10 @@ size_t
 Process::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
     error.Clear();
-    if (!GetDisableMemoryCache())
+    // In non-stop mode the threads that keep running change memory while the
+    // process is stopped, so the cache, which is only flushed when the
+    // process stops or resumes, can't be trusted.
+    if (!GetDisableMemoryCache() && !IsNonStopModeActive())
     {        
 #if defined (VERIFY_MEMORY_READS)
         // Memory caching is enabled, with debug verification
@@ -2656,6 +2744,15 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+size_t
+Process::PrefetchMemory (addr_t addr, size_t size, Error &error)
+{
+    error.Clear();
+    if (GetDisableMemoryCache())
+        return 0;
+    return m_memory_cache.Prefetch (addr, size, error);
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -2877,6 +2974,86 @@ Process::AllocateMemory(size_t size, uint32_t permissions, Error &error)
 #endif
 }
 
+// The number of instructions that can be stepped out of line at once.
+static const size_t g_num_displaced_step_slots = 64;
+
+void
+Process::AllocateDisplacedStepArena ()
+{
+    const size_t num_slots = g_num_displaced_step_slots;
+
+    {
+        Mutex::Locker locker (m_displaced_step_mutex);
+        if (m_displaced_step_arena_tried || GetPrivateState() != eStateStopped)
+            return;
+        m_displaced_step_arena_tried = true;
+    }
+
+    // Don't hold the lock while allocating: that can run code in the process,
+    // which may stop at a breakpoint and step over it with a slot.
+    if (!CanJIT())
+        return;
+
+    // This comes from the same pages as the memory for expressions.
+    Error error;
+    const addr_t arena = AllocateMemory (num_slots * GetDisplacedStepSlotSize(),
+                                         ePermissionsReadable | ePermissionsWritable | ePermissionsExecutable,
+                                         error);
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    if (log)
+        log->Printf("Process::AllocateDisplacedStepArena() => 0x%" PRIx64 " %s",
+                    (uint64_t)arena, error.AsCString(""));
+    if (arena == LLDB_INVALID_ADDRESS)
+        return;
+
+    Mutex::Locker locker (m_displaced_step_mutex);
+    // The arena was cleared by an exec or the process going away meanwhile.
+    if (!m_displaced_step_arena_tried)
+        return;
+    m_displaced_step_arena = arena;
+    for (size_t i = num_slots; i > 0; --i)
+        m_displaced_step_free_slots.push_back (arena + (i - 1) * GetDisplacedStepSlotSize());
+}
+
+void
+Process::ClearDisplacedStepArena ()
+{
+    // The memory itself goes away with the process or the exec, or with the
+    // allocated memory cache.
+    Mutex::Locker locker (m_displaced_step_mutex);
+    m_displaced_step_arena = LLDB_INVALID_ADDRESS;
+    m_displaced_step_arena_tried = false;
+    m_displaced_step_free_slots.clear();
+}
+
+addr_t
+Process::AcquireDisplacedStepSlot ()
+{
+    Mutex::Locker locker (m_displaced_step_mutex);
+    if (m_displaced_step_free_slots.empty())
+        return LLDB_INVALID_ADDRESS;
+    const addr_t slot_addr = m_displaced_step_free_slots.back();
+    m_displaced_step_free_slots.pop_back();
+    return slot_addr;
+}
+
+void
+Process::ReleaseDisplacedStepSlot (addr_t slot_addr)
+{
+    Mutex::Locker locker (m_displaced_step_mutex);
+    // Slots handed out before an exec belong to memory that is gone, and
+    // anything else was never a slot.
+    const size_t slot_size = GetDisplacedStepSlotSize();
+    if (m_displaced_step_arena == LLDB_INVALID_ADDRESS ||
+        slot_addr < m_displaced_step_arena ||
+        slot_addr >= m_displaced_step_arena + g_num_displaced_step_slots * slot_size ||
+        (slot_addr - m_displaced_step_arena) % slot_size != 0)
+        return;
+    if (std::find (m_displaced_step_free_slots.begin(), m_displaced_step_free_slots.end(), slot_addr) != m_displaced_step_free_slots.end())
+        return;
+    m_displaced_step_free_slots.push_back (slot_addr);
+}
+
 bool
 Process::CanJIT ()
 {
@@ -5982,6 +6159,7 @@ Process::DidExec ()
     m_jit_loaders_ap.reset();
     m_image_tokens.clear();
     m_allocated_memory_cache.Clear();
+    ClearDisplacedStepArena();
     m_language_runtimes.clear();
     m_thread_list.DiscardThreadPlans();
     m_memory_cache.Clear(true);
@@ -183,6 +183,14 @@ public:
                     ExecutionContext exe_ctx (thread_sp->GetStackFrameAtIndex(0));
                     StoppointCallbackContext context (event_ptr, exe_ctx, true);
                     m_should_stop = bp_site_sp->ShouldStop (&context);
+
+                    // If we can already tell that PerformAction won't want to stop, don't stop
+                    // at all.  That saves reporting the stop and continuing from it.
+                    if (m_should_stop && NoLocationWillStop (*thread_sp, *bp_site_sp, exe_ctx))
+                    {
+                        m_should_stop = false;
+                        m_should_perform_action = false;
+                    }
                 }
                 else
                 {
@@ -299,6 +307,40 @@ public:
     }
 
 protected:
+    // Returns true if, for each location at bp_site, PerformAction would
+    // skip it or its condition would say not to stop, and that can be
+    // worked out without running code in the process.
+    bool
+    NoLocationWillStop (Thread &thread, BreakpointSite &bp_site, ExecutionContext &exe_ctx)
+    {
+        // PerformAction doesn't look at conditions while running an expression.
+        if (thread.GetProcess()->GetModIDRef().IsLastResumeForUserExpression())
+            return false;
+
+        const size_t num_owners = bp_site.GetNumberOfOwners();
+        if (num_owners == 0)
+            return false;
+
+        for (size_t j = 0; j < num_owners; j++)
+        {
+            lldb::BreakpointLocationSP bp_loc_sp = bp_site.GetOwnerAtIndex(j);
+            if (!bp_loc_sp->IsEnabled() || !bp_loc_sp->GetBreakpoint().IsEnabled())
+                continue;
+            if (!bp_loc_sp->ValidForThisThread(&thread))
+                continue;
+            bool condition_says_stop;
+            if (bp_loc_sp->ConditionSaysStopWithoutExpression (exe_ctx, condition_says_stop) && !condition_says_stop)
+                continue;
+            return false;
+        }
+
+        Log *log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS);
+        if (log)
+            log->Printf ("StopInfoBreakpoint::NoLocationWillStop - continuing from breakpoint site %" PRId64 " on thread 0x%" PRIx64 " without a stop.",
+                         m_value, thread.GetID());
+        return true;
+    }
+
     bool
     ShouldStop (Event *event_ptr)
     {
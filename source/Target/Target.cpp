@@ -35,6 +35,7 @@
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Expression/ClangASTSource.h"
 #include "lldb/Expression/ClangUserExpression.h"
+#include "lldb/Expression/ClangUserExpressionCache.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
@@ -83,6 +84,7 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_scratch_ast_source_ap (),
     m_ast_importer_ap (),
     m_persistent_variables (),
+    m_expression_cache_ap (),
     m_source_manager_ap(),
     m_stop_hooks (),
     m_stop_hook_next_id (0),
@@ -161,6 +163,9 @@ Target::DeleteCurrentProcess ()
 {
     if (m_process_sp.get())
     {
+        // Cached expressions may have JIT code in the process.
+        if (m_expression_cache_ap.get())
+            m_expression_cache_ap->Clear();
         m_section_load_history.Clear();
         if (m_process_sp->IsAlive())
             m_process_sp->Destroy();
@@ -205,6 +210,7 @@ Target::Destroy()
     m_search_filter_sp.reset();
     m_image_search_paths.Clear(notify);
     m_persistent_variables.Clear();
+    m_expression_cache_ap.reset();
     m_stop_hooks.clear();
     m_stop_hook_next_id = 0;
     m_suppress_stop_hooks = false;
@@ -1022,6 +1028,8 @@ Target::ClearModules(bool delete_locations)
     ModulesDidUnload (m_images, delete_locations);
     m_section_load_history.Clear();
     m_images.Clear();
+    if (m_expression_cache_ap.get())
+        m_expression_cache_ap->Clear();
     m_scratch_ast_context_ap.reset();
     m_scratch_ast_source_ap.reset();
     m_ast_importer_ap.reset();
@@ -1161,6 +1169,8 @@ void
 Target::ModuleUpdated (const ModuleList& module_list, const ModuleSP &old_module_sp, const ModuleSP &new_module_sp)
 {
     // A module is replacing an already added module
+    if (m_expression_cache_ap.get())
+        m_expression_cache_ap->Clear();
     m_breakpoint_list.UpdateBreakpointsWhenModuleIsReplaced(old_module_sp, new_module_sp);
 }
 
@@ -1169,6 +1179,10 @@ Target::ModulesDidLoad (ModuleList &module_list)
 {
     if (module_list.GetSize())
     {
+        // Cached expressions were parsed without the new modules' types
+        // and functions.
+        if (m_expression_cache_ap.get())
+            m_expression_cache_ap->Clear();
         m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
         if (m_process_sp)
         {
@@ -1198,6 +1212,8 @@ Target::SymbolsDidLoad (ModuleList &module_list)
             }
         }
         
+        if (m_expression_cache_ap.get())
+            m_expression_cache_ap->Clear();
         m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
         BroadcastEvent(eBroadcastBitSymbolsLoaded, NULL);
     }
@@ -1208,6 +1224,8 @@ Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
 {
     if (module_list.GetSize())
     {
+        if (m_expression_cache_ap.get())
+            m_expression_cache_ap->Clear();
         m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         // TODO: make event data that packages up the module_list
         BroadcastEvent (eBroadcastBitModulesUnloaded, NULL);
@@ -1785,6 +1803,14 @@ Target::GetClangASTImporter()
     return ast_importer;
 }
 
+ClangUserExpressionCache &
+Target::GetExpressionCache()
+{
+    if (m_expression_cache_ap.get() == NULL)
+        m_expression_cache_ap.reset (new ClangUserExpressionCache());
+    return *m_expression_cache_ap;
+}
+
 void
 Target::SettingsInitialize ()
 {
@@ -2639,6 +2665,10 @@ g_properties[] =
         "'minimal' is the fastest setting and will load section data with no symbols, but should rarely be used as stack frames in these memory regions will be inaccurate and not provide any context (fastest). " },
     { "display-expression-in-crashlogs"    , OptionValue::eTypeBoolean   , false, false,                      NULL, NULL, "Expressions that crash will show up in crash logs if the host system supports executable specific crash log strings and this setting is set to true." },
     { "trap-handler-names"                 , OptionValue::eTypeArray     , true,  OptionValue::eTypeString,   NULL, NULL, "A list of trap handler function names, e.g. a common Unix user process one is _sigtramp." },
+    { "use-fast-breakpoint-conditions"     , OptionValue::eTypeBoolean   , false, true,                       NULL, NULL, "Evaluate simple breakpoint conditions (comparisons and arithmetic on variables) inside the debugger instead of running them as expressions." },
+    { "expression-cache-size"              , OptionValue::eTypeUInt64    , false, 32,                         NULL, NULL, "The number of parsed expressions to keep so that evaluating the same expression again in the same scope doesn't parse it again. Set to zero to disable." },
+    { "expression-lazy-type-completion"    , OptionValue::eTypeBoolean   , false, true,                       NULL, NULL, "If true, types of fields copied into expressions are imported as forward declarations and only completed when the expression needs their layout or members." },
+    { "expression-interpreter-instruction-limit", OptionValue::eTypeUInt64, false, 64*1024,                   NULL, NULL, "The number of IR instructions an expression evaluated in the debugger (rather than by running code in the target) may execute before giving up." },
     { NULL                                 , OptionValue::eTypeInvalid   , false, 0                         , NULL, NULL, NULL }
 };
 enum
@@ -2672,7 +2702,11 @@ enum
     ePropertyLoadScriptFromSymbolFile,
     ePropertyMemoryModuleLoadLevel,
     ePropertyDisplayExpressionsInCrashlogs,
-    ePropertyTrapHandlerNames
+    ePropertyTrapHandlerNames,
+    ePropertyUseFastBreakpointConditions,
+    ePropertyExpressionCacheSize,
+    ePropertyExpressionLazyTypeCompletion,
+    ePropertyExpressionInterpreterInstructionLimit
 };
 
 
@@ -3051,6 +3085,34 @@ TargetProperties::GetUseFastStepping () const
     return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool
+TargetProperties::GetUseFastBreakpointConditions () const
+{
+    const uint32_t idx = ePropertyUseFastBreakpointConditions;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+uint64_t
+TargetProperties::GetExpressionCacheSize () const
+{
+    const uint32_t idx = ePropertyExpressionCacheSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+TargetProperties::GetExpressionLazyTypeCompletion () const
+{
+    const uint32_t idx = ePropertyExpressionLazyTypeCompletion;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+uint64_t
+TargetProperties::GetExpressionInterpreterInstructionLimit () const
+{
+    const uint32_t idx = ePropertyExpressionInterpreterInstructionLimit;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
 bool
 TargetProperties::GetDisplayExpressionsInCrashlogs () const
 {
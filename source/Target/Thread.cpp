@@ -505,6 +505,19 @@ Thread::ThreadStoppedForAReason (void)
     return (bool) GetPrivateStopInfo ();
 }
 
+bool
+Thread::IsIdle ()
+{
+    if (m_plan_stack.size() > 1 || !m_completed_plan_stack.empty())
+        return false;
+    {
+        Mutex::Locker locker(m_frame_mutex);
+        if (m_curr_frames_sp)
+            return false;
+    }
+    return KnownToHaveNoStopReason ();
+}
+
 bool
 Thread::CheckpointThreadState (ThreadStateCheckpoint &saved_state)
 {
@@ -599,7 +612,10 @@ Thread::WillStop()
 void
 Thread::SetupForResume ()
 {
-    if (GetResumeState() != eStateSuspended)
+    // An idle thread didn't stop at the breakpoint it might be sitting on,
+    // so it doesn't have to step over it, and there is no need to read its
+    // PC to find out.
+    if (GetResumeState() != eStateSuspended && !IsIdle())
     {
     
         // If we're at a breakpoint push the step-over breakpoint plan.  Do this before
@@ -615,7 +631,7 @@ Thread::SetupForResume ()
         if (reg_ctx_sp)
         {
             BreakpointSiteSP bp_site_sp = GetProcess()->GetBreakpointSiteList().FindByAddress(reg_ctx_sp->GetPC());
-            if (bp_site_sp)
+            if (bp_site_sp && !(bp_site_sp->IsHardware() && CanResumePastHardwareBreakpoint()))
             {
                 // Note, don't assume there's a ThreadPlanStepOverBreakpoint, the target may not require anything
                 // special to step over a breakpoint.
@@ -1131,6 +1147,18 @@ Thread::GetCurrentPlan ()
     return m_plan_stack.back().get();
 }
 
+bool
+Thread::HasPublicPlans ()
+{
+    // The base plan is at the bottom of the stack.
+    for (size_t i = 1; i < m_plan_stack.size(); ++i)
+    {
+        if (!m_plan_stack[i]->GetPrivate())
+            return true;
+    }
+    return false;
+}
+
 ThreadPlanSP
 Thread::GetCompletedPlan ()
 {
@@ -2036,6 +2064,15 @@ Thread::GetUnwinder ()
     return m_unwinder_ap.get();
 }
 
+uint32_t
+Thread::GetStackPCs (std::vector<lldb::addr_t> &pcs, uint32_t max_frames)
+{
+    pcs.clear();
+    Unwind *unwinder = GetUnwinder ();
+    if (unwinder)
+        return unwinder->GetStackPCs (pcs, max_frames);
+    return 0;
+}
 
 void
 Thread::Flush ()
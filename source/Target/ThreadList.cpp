@@ -12,6 +12,7 @@
 
 #include "lldb/Core/Log.h"
 #include "lldb/Core/State.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/ThreadList.h"
 #include "lldb/Target/Thread.h"
@@ -254,6 +255,14 @@ ThreadList::FindThreadByIndexID (uint32_t index_id, bool can_update)
     return thread_sp;
 }
 
+// In non-stop mode the threads that didn't stop are still running, and have
+// nothing to say about the stop.
+static bool
+ThreadIsStillRunning (Process *process, const ThreadSP &thread_sp)
+{
+    return StateIsRunningState (thread_sp->GetState()) && process->IsNonStopModeActive();
+}
+
 bool
 ThreadList::ShouldStop (Event *event_ptr)
 {
@@ -297,12 +306,16 @@ ThreadList::ShouldStop (Event *event_ptr)
     for (pos = threads_copy.begin(); pos != end; ++pos)
     {
         ThreadSP thread_sp(*pos);
+        if (ThreadIsStillRunning (m_process, thread_sp) || thread_sp->IsIdle())
+            continue;
         thread_sp->GetStopInfo();
     }
     
     for (pos = threads_copy.begin(); pos != end; ++pos)
     {
         ThreadSP thread_sp(*pos);
+        if (ThreadIsStillRunning (m_process, thread_sp))
+            continue;
         
         // We should never get a stop for which no thread had a stop reason, but sometimes we do see this -
         // for instance when we first connect to a remote stub.  In that case we should stop, since we can't figure out
@@ -323,6 +336,11 @@ ThreadList::ShouldStop (Event *event_ptr)
             did_anybody_stop_for_a_reason = true;
         else
             did_anybody_stop_for_a_reason |= thread_sp->ThreadStoppedForAReason();
+
+        // Idle threads have no stop reason and no plans that could want to
+        // stop, so there is nothing to ask them.
+        if (thread_sp->IsIdle())
+            continue;
         
         const bool thread_should_stop = thread_sp->ShouldStop(event_ptr);
         if (thread_should_stop)
@@ -344,6 +362,8 @@ ThreadList::ShouldStop (Event *event_ptr)
         for (pos = threads_copy.begin(); pos != end; ++pos)
         {
             ThreadSP thread_sp(*pos);
+            if (ThreadIsStillRunning (m_process, thread_sp) || thread_sp->IsIdle())
+                continue;
             thread_sp->WillStop ();
         }
     }
@@ -370,6 +390,8 @@ ThreadList::ShouldReportStop (Event *event_ptr)
     for (pos = m_threads.begin(); pos != end; ++pos)
     {
         ThreadSP thread_sp(*pos);
+        if (ThreadIsStillRunning (m_process, thread_sp))
+            continue;
         const Vote vote = thread_sp->ShouldReportStop (event_ptr);
         switch (vote)
         {
@@ -488,7 +510,12 @@ ThreadList::RefreshStateAfterStop ()
 
     collection::iterator pos, end = m_threads.end();
     for (pos = m_threads.begin(); pos != end; ++pos)
+    {
+        if (ThreadIsStillRunning (m_process, *pos))
+            continue;
         (*pos)->RefreshStateAfterStop ();
+        (*pos)->GetCurrentPlan()->ThreadStopped ();
+    }
 }
 
 void
@@ -504,6 +531,136 @@ ThreadList::DiscardThreadPlans ()
 
 }
 
+namespace {
+
+// Shared state for the ComputeStackFrames() worker threads.  Each worker
+// pulls the next thread to unwind from the list until it runs out.
+struct StackFrameWorkQueue
+{
+    StackFrameWorkQueue (const ThreadList::collection &threads, uint32_t max_frames) :
+        threads (threads),
+        max_frames (max_frames),
+        next_idx (0),
+        mutex ()
+    {
+    }
+
+    bool
+    GetNextThread (ThreadSP &thread_sp)
+    {
+        Mutex::Locker locker (mutex);
+        if (next_idx >= threads.size())
+            return false;
+        thread_sp = threads[next_idx++];
+        return true;
+    }
+
+    const ThreadList::collection &threads;
+    const uint32_t max_frames;
+    size_t next_idx;
+    Mutex mutex;
+};
+
+}
+
+static void
+ComputeStackFramesForThread (Thread &thread, uint32_t max_frames)
+{
+    if (max_frames == UINT32_MAX)
+        thread.GetStackFrameCount();
+    else if (max_frames > 0)
+        thread.GetStackFrameAtIndex (max_frames - 1);
+}
+
+static thread_result_t
+StackFrameWorkerThread (thread_arg_t arg)
+{
+    StackFrameWorkQueue *queue = (StackFrameWorkQueue *)arg;
+    ThreadSP thread_sp;
+    while (queue->GetNextThread (thread_sp))
+        ComputeStackFramesForThread (*thread_sp, queue->max_frames);
+    return NULL;
+}
+
+uint32_t
+ThreadList::ComputeStackFrames (uint32_t max_frames, uint32_t num_workers)
+{
+    collection threads;
+    {
+        Mutex::Locker locker(GetMutex());
+        m_process->UpdateThreadListIfNeeded();
+        threads = m_threads;
+    }
+
+    if (threads.empty())
+        return 0;
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
+
+    // Read the top of every stack up front.  Sorting by stack pointer lets
+    // neighboring stacks share a read, and the unwinders' many small
+    // reads of saved registers and return addresses then hit the memory
+    // cache instead of going to the inferior one at a time.
+    const addr_t stack_prefetch_size = 4096;
+    std::vector<addr_t> stack_pointers;
+    stack_pointers.reserve (threads.size());
+    for (const ThreadSP &thread_sp : threads)
+    {
+        RegisterContextSP reg_ctx_sp (thread_sp->GetRegisterContext());
+        if (reg_ctx_sp)
+        {
+            const addr_t sp = reg_ctx_sp->GetSP (LLDB_INVALID_ADDRESS);
+            if (sp != LLDB_INVALID_ADDRESS)
+                stack_pointers.push_back (sp);
+        }
+    }
+    std::sort (stack_pointers.begin(), stack_pointers.end());
+    size_t sp_idx = 0;
+    while (sp_idx < stack_pointers.size())
+    {
+        const addr_t range_base = stack_pointers[sp_idx];
+        addr_t range_end = range_base + stack_prefetch_size;
+        for (++sp_idx; sp_idx < stack_pointers.size() && stack_pointers[sp_idx] <= range_end; ++sp_idx)
+            range_end = stack_pointers[sp_idx] + stack_prefetch_size;
+        Error error;
+        m_process->PrefetchMemory (range_base, range_end - range_base, error);
+    }
+
+    if (num_workers == 0)
+        num_workers = Host::GetNumberCPUS();
+    if (num_workers > threads.size())
+        num_workers = threads.size();
+
+    if (log)
+        log->Printf ("ThreadList::%s unwinding %" PRIu64 " threads (max_frames = %u) with %u workers",
+                     __FUNCTION__, (uint64_t)threads.size(), max_frames, num_workers);
+
+    if (num_workers <= 1)
+    {
+        for (const ThreadSP &thread_sp : threads)
+            ComputeStackFramesForThread (*thread_sp, max_frames);
+        return threads.size();
+    }
+
+    StackFrameWorkQueue queue (threads, max_frames);
+    std::vector<lldb::thread_t> workers;
+    for (uint32_t i = 0; i < num_workers; ++i)
+    {
+        lldb::thread_t worker = Host::ThreadCreate ("<lldb.target.unwind-worker>", StackFrameWorkerThread, &queue, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(worker))
+            workers.push_back (worker);
+    }
+
+    // Help out on this thread too; this also makes sure we finish if no
+    // worker threads could be created.
+    StackFrameWorkerThread (&queue);
+
+    for (lldb::thread_t worker : workers)
+        Host::ThreadJoin (worker, NULL, NULL);
+
+    return threads.size();
+}
+
 bool
 ThreadList::WillResume ()
 {
@@ -564,6 +721,8 @@ ThreadList::WillResume ()
         {
             if ((*pos)->IsOperatingSystemPluginThread() && !(*pos)->GetBackingThread())
                 continue;
+            if (ThreadIsStillRunning (m_process, *pos))
+                continue;
             (*pos)->SetupForResume ();
         }
     }
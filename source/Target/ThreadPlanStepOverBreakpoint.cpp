@@ -10,14 +10,23 @@
 #include "lldb/Target/ThreadPlanStepOverBreakpoint.h"
 
 // C Includes
+#include <string.h>
+
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private-log.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -35,15 +44,195 @@ ThreadPlanStepOverBreakpoint::ThreadPlanStepOverBreakpoint (Thread &thread) :
                             // over a breakpoint
     m_breakpoint_addr (LLDB_INVALID_ADDRESS),
     m_auto_continue(false),
-    m_reenabled_breakpoint_site (false)
+    m_reenabled_breakpoint_site (false),
+    m_displaced_step_addr (LLDB_INVALID_ADDRESS),
+    m_displaced_step_length (0)
 
 {
     m_breakpoint_addr = m_thread.GetRegisterContext()->GetPC();
     m_breakpoint_site_id =  m_thread.GetProcess()->GetBreakpointSiteList().FindIDByAddress (m_breakpoint_addr);
+
+    // If we can, step a copy of the instruction under the breakpoint instead,
+    // so the trap stays in place for the other threads and they don't have to
+    // be held while this one steps.
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp->GetDisplacedSteppingEnabled())
+        return;
+    BreakpointSiteSP bp_site_sp (process_sp->GetBreakpointSiteList().FindByAddress (m_breakpoint_addr));
+    if (!bp_site_sp || !bp_site_sp->IsEnabled() || bp_site_sp->IsHardware())
+        return;
+
+    // A signal that is delivered on resume runs its handler with a return
+    // address in the copy, and the slot is gone by the time the handler
+    // returns.  The stop info passes its signal on when the thread resumes.
+    StopInfoSP stop_info_sp (GetPrivateStopInfo ());
+    if (stop_info_sp && stop_info_sp->GetStopReason() == eStopReasonSignal &&
+        !process_sp->GetUnixSignals().GetShouldSuppress (stop_info_sp->GetValue()))
+        return;
+
+    const addr_t slot_addr = process_sp->AcquireDisplacedStepSlot();
+    if (slot_addr == LLDB_INVALID_ADDRESS)
+        return;
+    const size_t length = RelocateInstruction (m_thread, m_breakpoint_addr, slot_addr);
+    if (length == 0)
+    {
+        process_sp->ReleaseDisplacedStepSlot (slot_addr);
+        return;
+    }
+    m_displaced_step_addr = slot_addr;
+    m_displaced_step_length = length;
+    // There is nothing to re-enable.
+    m_reenabled_breakpoint_site = true;
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    if (log)
+        log->Printf("Stepping the %" PRIu64 " byte instruction at 0x%" PRIx64 " from 0x%" PRIx64 ".",
+                    (uint64_t)length, (uint64_t)m_breakpoint_addr, (uint64_t)slot_addr);
 }
 
 ThreadPlanStepOverBreakpoint::~ThreadPlanStepOverBreakpoint ()
 {
+    ReleaseDisplacedStepSlot ();
+}
+
+//----------------------------------------------------------------------
+// Finds the 32 bit displacement of the %rip relative memory operand of the
+// x86-64 instruction in bytes by walking its prefixes and opcode to the
+// ModRM byte, and returns its offset in disp_offset.  Returns false if the
+// ModRM byte doesn't describe a %rip relative operand.
+//----------------------------------------------------------------------
+static bool
+FindRIPRelativeDisplacement (const uint8_t *bytes, size_t length, size_t &disp_offset)
+{
+    size_t offset = 0;
+    bool is_prefix = true;
+    while (is_prefix && offset < length)
+    {
+        switch (bytes[offset])
+        {
+        case 0x26: case 0x2e: case 0x36: case 0x3e: case 0x64: case 0x65:   // Segment overrides
+        case 0x66: case 0x67:                                               // Operand and address size
+        case 0xf0: case 0xf2: case 0xf3:                                    // lock, repne, rep
+            ++offset;
+            break;
+        default:
+            is_prefix = false;
+            break;
+        }
+    }
+    if (offset + 1 >= length)
+        return false;
+
+    // The VEX, EVEX and XOP prefixes select the opcode map themselves, and
+    // are followed by a single opcode byte.  XOP shares its first byte with
+    // "pop r/m", whose ModRM reg field is zero.
+    size_t opcode_length = 1;
+    switch (bytes[offset])
+    {
+    case 0xc5:
+        offset += 2;
+        break;
+    case 0xc4:
+        offset += 3;
+        break;
+    case 0x62:
+        offset += 4;
+        break;
+    case 0x8f:
+        if ((bytes[offset + 1] & 0x1f) >= 8)
+            offset += 3;
+        break;
+    default:
+        if ((bytes[offset] & 0xf0) == 0x40)     // REX
+            ++offset;
+        if (offset + 1 < length && bytes[offset] == 0x0f)
+            opcode_length = (bytes[offset + 1] == 0x38 || bytes[offset + 1] == 0x3a) ? 3 : 2;
+        break;
+    }
+
+    const size_t modrm_offset = offset + opcode_length;
+    if (modrm_offset + 1 + sizeof(int32_t) > length)
+        return false;
+    // Mod 00 with r/m 101 and no SIB byte is the %rip relative form.
+    if ((bytes[modrm_offset] & 0xc7) != 0x05)
+        return false;
+    disp_offset = modrm_offset + 1;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Copies the instruction at from_addr to to_addr so that it does the same
+// thing when it is executed there, and returns its length, or zero if that
+// can't be done.  Only x86 instructions that don't change the flow of
+// control are moved; the only position dependent operands those can have
+// are %rip relative memory operands, whose displacements are adjusted.
+//----------------------------------------------------------------------
+size_t
+ThreadPlanStepOverBreakpoint::RelocateInstruction (Thread &thread, addr_t from_addr, addr_t to_addr)
+{
+    ProcessSP process_sp (thread.GetProcess());
+    const ArchSpec &arch = process_sp->GetTarget().GetArchitecture();
+    const llvm::Triple::ArchType machine = arch.GetMachine();
+    if (machine != llvm::Triple::x86 && machine != llvm::Triple::x86_64)
+        return 0;
+
+    // x86 instructions are at most 15 bytes long.  ReadMemory hands back the
+    // original bytes under any breakpoints.
+    const size_t max_length = 15;
+    DataBufferSP buffer_sp (new DataBufferHeap (max_length, 0));
+    Error error;
+    const size_t bytes_read = process_sp->ReadMemory (from_addr, buffer_sp->GetBytes(), max_length, error);
+    if (bytes_read == 0)
+        return 0;
+
+    DisassemblerSP disassembler_sp (Disassembler::FindPlugin (arch, "att", NULL));
+    if (!disassembler_sp)
+        return 0;
+    DataExtractor data (buffer_sp, arch.GetByteOrder(), arch.GetAddressByteSize());
+    if (disassembler_sp->DecodeInstructions (Address (from_addr), data, 0, 1, false, false) != 1)
+        return 0;
+    InstructionSP inst_sp (disassembler_sp->GetInstructionList().GetInstructionAtIndex (0));
+    if (!inst_sp)
+        return 0;
+
+    const size_t length = inst_sp->GetOpcode().GetByteSize();
+    if (length == 0 || length > bytes_read || length > Process::GetDisplacedStepSlotSize())
+        return 0;
+
+    // Branches are relative to where they are, and traps and system calls
+    // report or return to the address after them.
+    if (inst_sp->DoesBranch())
+        return 0;
+    static const char *g_unmovable[] = { "int", "int3", "into", "syscall", "sysenter", "ud2", "hlt", "xbegin" };
+    const char *mnemonic = inst_sp->GetMnemonic (NULL);
+    for (size_t i = 0; i < sizeof(g_unmovable) / sizeof(g_unmovable[0]); ++i)
+    {
+        if (::strcmp (mnemonic, g_unmovable[i]) == 0)
+            return 0;
+    }
+
+    uint8_t *bytes = buffer_sp->GetBytes();
+    const char *operands = inst_sp->GetOperands (NULL);
+    if (::strstr (operands, "(%rip)") || ::strstr (operands, "(%eip)"))
+    {
+        // Only the disassembler knows which opcodes have a ModRM byte, but
+        // the displacement is found in the encoding itself.
+        size_t disp_offset = 0;
+        if (machine != llvm::Triple::x86_64 || !FindRIPRelativeDisplacement (bytes, length, disp_offset))
+            return 0;
+
+        int32_t disp;
+        ::memcpy (&disp, bytes + disp_offset, sizeof(disp));
+        const int64_t new_disp = (int64_t)disp + (int64_t)(from_addr - to_addr);
+        if (new_disp < INT32_MIN || new_disp > INT32_MAX)
+            return 0;
+        const int32_t encoded = (int32_t)new_disp;
+        ::memcpy (bytes + disp_offset, &encoded, sizeof(encoded));
+    }
+
+    if (process_sp->WriteMemory (to_addr, bytes, length, error) != length)
+        return 0;
+    return length;
 }
 
 void
@@ -82,7 +271,9 @@ ThreadPlanStepOverBreakpoint::ShouldStop (Event *event_ptr)
 bool
 ThreadPlanStepOverBreakpoint::StopOthers ()
 {
-    return true;
+    // The breakpoint stays in place while a copy of the instruction steps,
+    // so the other threads can't run past it.
+    return !IsDisplaced();
 }
 
 StateType
@@ -96,9 +287,32 @@ ThreadPlanStepOverBreakpoint::DoWillResume (StateType resume_state, bool current
 {
     if (current_plan)
     {
+        // The constructor already steps in place when the thread stopped
+        // with a signal; this catches any other signal it is resumed with.
+        const int signo = m_thread.GetResumeSignal();
+        if (IsDisplaced() && signo != 0 && signo != LLDB_INVALID_SIGNAL_NUMBER)
+        {
+            MoveBackFromDisplacedStep ();
+            ReleaseDisplacedStepSlot ();
+            m_reenabled_breakpoint_site = false;
+        }
+
+        if (IsDisplaced())
+        {
+            RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+            if (reg_ctx_sp->GetPC() == m_breakpoint_addr)
+                reg_ctx_sp->SetPC (m_displaced_step_addr);
+            return true;
+        }
+
         BreakpointSiteSP bp_site_sp (m_thread.GetProcess()->GetBreakpointSiteList().FindByAddress (m_breakpoint_addr));
         if (bp_site_sp  && bp_site_sp->IsEnabled())
+        {
+            Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+            if (log)
+                log->Printf("Stepping over the breakpoint at 0x%" PRIx64 " in place.", (uint64_t)m_breakpoint_addr);
             m_thread.GetProcess()->DisableBreakpointSite (bp_site_sp.get());
+        }
     }
     return true;
 }
@@ -150,6 +364,47 @@ void
 ThreadPlanStepOverBreakpoint::ThreadDestroyed ()
 {
     ReenableBreakpointSite ();
+    ReleaseDisplacedStepSlot ();
+}
+
+void
+ThreadPlanStepOverBreakpoint::ThreadStopped ()
+{
+    // Nobody should see the thread in the copy.
+    MoveBackFromDisplacedStep ();
+}
+
+void
+ThreadPlanStepOverBreakpoint::WillPop ()
+{
+    MoveBackFromDisplacedStep ();
+    ReleaseDisplacedStepSlot ();
+    ThreadPlan::WillPop ();
+}
+
+void
+ThreadPlanStepOverBreakpoint::MoveBackFromDisplacedStep ()
+{
+    if (!IsDisplaced())
+        return;
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+    if (!reg_ctx_sp)
+        return;
+    const addr_t pc = reg_ctx_sp->GetPC();
+    if (pc >= m_displaced_step_addr && pc <= m_displaced_step_addr + m_displaced_step_length)
+        reg_ctx_sp->SetPC (m_breakpoint_addr + (pc - m_displaced_step_addr));
+}
+
+void
+ThreadPlanStepOverBreakpoint::ReleaseDisplacedStepSlot ()
+{
+    if (!IsDisplaced())
+        return;
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (process_sp)
+        process_sp->ReleaseDisplacedStepSlot (m_displaced_step_addr);
+    m_displaced_step_addr = LLDB_INVALID_ADDRESS;
+    m_displaced_step_length = 0;
 }
 
 void
@@ -394,6 +394,7 @@ lldb_private::GetSectionTypeAsCString (SectionType sect_type)
     case eSectionTypeDWARFAppleNamespaces: return "apple-namespaces";
     case eSectionTypeDWARFAppleObjC: return "apple-objc";
     case eSectionTypeEHFrame: return "eh-frame";
+    case eSectionTypeEHFrameHdr: return "eh-frame-hdr";
     case eSectionTypeOther: return "regular";
     }
     return "unknown";
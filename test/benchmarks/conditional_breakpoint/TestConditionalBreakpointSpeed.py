@@ -0,0 +1,61 @@
+"""Benchmark the number of conditional breakpoint hits per second lldb can process."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+
+class ConditionalBreakpointSpeedBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.num_hits = 1000
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 3
+        self.line = line_number('main.c', '// Set conditional breakpoint here.')
+
+    @benchmarks_test
+    def test_conditional_breakpoint_hits(self):
+        """Benchmark a conditional breakpoint that never stops, with and without in-debugger condition evaluation."""
+        self.buildDefault()
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.use-fast-breakpoint-conditions"))
+
+        print
+        expr_avg = self.run_conditional_breakpoint_bench(exe, False)
+        print "lldb conditional breakpoint benchmark, expression evaluation:", self.stopwatch
+        print "hits/sec: %f" % (self.num_hits/expr_avg)
+        fast_avg = self.run_conditional_breakpoint_bench(exe, True)
+        print "lldb conditional breakpoint benchmark, in-debugger evaluation:", self.stopwatch
+        print "hits/sec: %f" % (self.num_hits/fast_avg)
+        print "expr_avg/fast_avg: %f" % (expr_avg/fast_avg)
+
+    def run_conditional_breakpoint_bench(self, exe, use_fast_conditions):
+        self.runCmd("settings set target.use-fast-breakpoint-conditions %s" % ("true" if use_fast_conditions else "false"))
+        self.stopwatch.reset()
+        for i in range(self.count):
+            target = self.dbg.CreateTarget(exe)
+            self.assertTrue(target, VALID_TARGET)
+
+            bkpt = target.BreakpointCreateByLocation("main.c", self.line)
+            self.assertTrue(bkpt.GetNumLocations() == 1, VALID_BREAKPOINT)
+            # Never true, so every hit is evaluated and the process continues.
+            bkpt.SetCondition("i == -1 && r->state == 3")
+
+            with self.stopwatch:
+                process = target.LaunchSimple ([str(self.num_hits)], None, self.get_process_working_directory())
+                self.assertTrue(process, PROCESS_IS_VALID)
+                self.assertTrue(process.GetState() == lldb.eStateExited, "the condition never stopped the process")
+            self.assertTrue(bkpt.GetHitCount() == self.num_hits)
+
+            self.dbg.DeleteTarget(target)
+        return self.stopwatch.avg()
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
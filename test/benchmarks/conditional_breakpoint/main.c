@@ -0,0 +1,30 @@
+#include <stdlib.h>
+
+struct request
+{
+    int id;
+    int state;
+};
+
+int g_total = 0;
+
+void
+handle_request (int i, struct request *r)
+{
+    g_total += r->state; // Set conditional breakpoint here.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int num_requests = argc > 1 ? atoi (argv[1]) : 1000;
+    struct request r = { 0, 0 };
+    int i;
+    for (i = 0; i < num_requests; ++i)
+    {
+        r.id = i;
+        r.state = i % 4;
+        handle_request (i, &r);
+    }
+    return 0;
+}
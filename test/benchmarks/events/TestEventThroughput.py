@@ -0,0 +1,142 @@
+"""Benchmark how many events per second go from a broadcaster to a listener."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+
+class EventThroughputBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.num_events = 100000
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 5
+
+    @benchmarks_test
+    def test_event_throughput(self):
+        """Benchmark broadcasting events and taking them off the listener's queue."""
+        print
+        batched_rate = self.run_event_bench(False)
+        print "lldb queued events benchmark: %d events/sec," % batched_rate, self.stopwatch
+        interleaved_rate = self.run_event_bench(True)
+        print "lldb broadcast then get event benchmark: %d events/sec," % interleaved_rate, self.stopwatch
+
+    @benchmarks_test
+    def test_threaded_event_throughput(self):
+        """Benchmark several threads broadcasting to a listener that a thread is blocked on."""
+        print
+        rate = self.run_threaded_event_bench(4)
+        print "lldb threaded broadcast to a waiting listener benchmark: %d events/sec," % rate, self.stopwatch
+
+    def run_event_bench(self, interleaved):
+        """Broadcast self.num_events events, either taking each one off the
+        queue right away or all of them at the end, and return events/sec."""
+        self.stopwatch.reset()
+        for i in range(self.count):
+            broadcaster = lldb.SBBroadcaster("bench-broadcaster")
+            listener = lldb.SBListener("bench-listener")
+            listener.StartListeningForEvents(broadcaster, 0x3)
+            event = lldb.SBEvent()
+
+            received = 0
+            with self.stopwatch:
+                for j in range(self.num_events):
+                    broadcaster.BroadcastEventByType(1 << (j & 1))
+                    if interleaved and listener.GetNextEvent(event):
+                        received += 1
+                while listener.GetNextEvent(event):
+                    received += 1
+            self.assertTrue(received == self.num_events, "Got all the events")
+        return self.num_events / self.stopwatch.avg()
+
+    def run_threaded_event_bench(self, num_broadcasters):
+        """Broadcast self.num_events events from num_broadcasters threads
+        while another thread waits for them, and return events/sec.  Each
+        broadcaster's events have to arrive in order, and a second waiter
+        on the same listener, for a broadcaster nobody uses, must not get
+        any of them."""
+        import threading
+        events_per_broadcaster = self.num_events // num_broadcasters
+        num_events = events_per_broadcaster * num_broadcasters
+
+        class BroadcastingThread(threading.Thread):
+            def __init__(self, broadcaster, index):
+                threading.Thread.__init__(self)
+                self.broadcaster = broadcaster
+                self.index = index
+            def run(self):
+                for seq in range(events_per_broadcaster):
+                    data = "%d:%d" % (self.index, seq)
+                    self.broadcaster.BroadcastEvent(lldb.SBEvent(1 << (seq & 1), data))
+
+        class WaitingThread(threading.Thread):
+            def __init__(self, listener):
+                threading.Thread.__init__(self)
+                self.listener = listener
+                self.received = 0
+                self.out_of_order = 0
+            def run(self):
+                next_seq = [0] * num_broadcasters
+                event = lldb.SBEvent()
+                while self.received < num_events and self.listener.WaitForEvent(10, event):
+                    (index, seq) = [int(field) for field in lldb.SBEvent.GetCStringFromEvent(event).split(':')]
+                    if seq != next_seq[index]:
+                        self.out_of_order += 1
+                    next_seq[index] = seq + 1
+                    self.received += 1
+
+        class IdleWaitingThread(threading.Thread):
+            def __init__(self, listener, broadcaster):
+                threading.Thread.__init__(self)
+                self.listener = listener
+                self.broadcaster = broadcaster
+                self.done = False
+                self.received = 0
+            def run(self):
+                event = lldb.SBEvent()
+                while not self.done:
+                    if self.listener.WaitForEventForBroadcaster(1, self.broadcaster, event):
+                        self.received += 1
+
+        self.stopwatch.reset()
+        for i in range(self.count):
+            listener = lldb.SBListener("bench-listener")
+            broadcasters = []
+            for index in range(num_broadcasters):
+                broadcaster = lldb.SBBroadcaster("bench-broadcaster-%d" % index)
+                listener.StartListeningForEvents(broadcaster, 0x3)
+                broadcasters.append(broadcaster)
+
+            idle_waiter = IdleWaitingThread(listener, lldb.SBBroadcaster("bench-idle-broadcaster"))
+            idle_waiter.start()
+
+            with self.stopwatch:
+                waiter = WaitingThread(listener)
+                waiter.start()
+                broadcasting_threads = [BroadcastingThread(broadcasters[index], index) for index in range(num_broadcasters)]
+                for thread in broadcasting_threads:
+                    thread.start()
+                for thread in broadcasting_threads:
+                    thread.join()
+                waiter.join()
+
+            idle_waiter.done = True
+            idle_waiter.join()
+
+            self.assertTrue(waiter.received == num_events,
+                            "Got %d of %d events" % (waiter.received, num_events))
+            self.assertTrue(waiter.out_of_order == 0,
+                            "%d events arrived out of order" % waiter.out_of_order)
+            self.assertTrue(idle_waiter.received == 0,
+                            "The idle waiter got %d events" % idle_waiter.received)
+        return num_events / self.stopwatch.avg()
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
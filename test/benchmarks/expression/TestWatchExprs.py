@@ -0,0 +1,79 @@
+"""Benchmark evaluating typical watch window expressions, and report how many were interpreted instead of JIT compiled."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+
+class WatchExpressionsBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.cpp'
+        self.line_to_break = line_number(self.source, '// Set breakpoint here.')
+        self.log_file = os.path.join(os.getcwd(), "watch-exprs.txt")
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 25
+
+    @benchmarks_test
+    def test_watch_exprs(self):
+        """Benchmark evaluating watch window expressions at each stop."""
+        self.buildDefault()
+        self.addTearDownHook(lambda: os.path.isfile(self.log_file) and os.remove(self.log_file))
+
+        print
+        self.run_watch_exprs(self.count)
+        print "lldb watch expressions benchmark:", self.stopwatch
+        print "interpreted %d, JIT compiled %d" % (self.num_interpreted, self.num_jitted)
+
+    def run_watch_exprs(self, count):
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation(self.source, self.line_to_break)
+        self.assertTrue(breakpoint.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        # The sort of expressions an IDE shows in its watch window,
+        # evaluated again after every stop.
+        exprs = [
+            "ptr[j]->point.x + ptr[j]->point.y",
+            "ptr[j]->id * 2 == j * 2",
+            "j > 500 ? ptr[j]->point.x : -1",
+            "(double)ptr[j]->point.y / 3",
+            "ptr[j]->point.x * 1.5 > 100.0",
+            "data[j] == ptr[j] && j % 7 != 0",
+        ]
+
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+
+        self.stopwatch.reset()
+        for i in range(count):
+            thread = process.GetSelectedThread()
+            frame = thread.GetFrameAtIndex(0)
+            with self.stopwatch:
+                for expr in exprs:
+                    value = frame.EvaluateExpression(expr)
+                    self.assertTrue(value.GetError().Success(), "evaluated '%s'" % expr)
+            process.Continue()
+
+        self.runCmd("log disable lldb expr")
+        with open(self.log_file, 'r') as f:
+            log = f.read()
+        self.num_interpreted = log.count("Interpreting the expression")
+        self.num_jitted = log.count("Running the JIT compiled expression")
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
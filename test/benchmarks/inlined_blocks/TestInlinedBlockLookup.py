@@ -0,0 +1,65 @@
+"""Benchmark resolving the block and inlined function for every address of a heavily inlined function."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+
+class InlinedBlockLookupBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 10
+
+    @benchmarks_test
+    def test_inlined_block_lookup(self):
+        """Benchmark looking up the innermost block of addresses in a function with thousands of nested inlined blocks."""
+        self.buildDefault()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        functions = target.FindFunctions("main")
+        self.assertTrue(functions.GetSize() == 1)
+        function = functions.GetContextAtIndex(0).GetFunction()
+        self.assertTrue(function.IsValid())
+
+        # Look up every instruction, since stepping and symbolicating
+        # frames look up the block for every PC they stop at.
+        addresses = []
+        for inst in function.GetInstructions(target):
+            addresses.append(inst.GetAddress())
+        self.assertTrue(len(addresses) > 0)
+
+        print
+        self.stopwatch.reset()
+        max_inline_depth = 0
+        for i in range(self.count):
+            with self.stopwatch:
+                for addr in addresses:
+                    sc = target.ResolveSymbolContextForAddress(addr, lldb.eSymbolContextBlock)
+                    block = sc.GetBlock()
+                    self.assertTrue(block.IsValid())
+                    if i == 0:
+                        inline_depth = 0
+                        inlined_block = block.GetContainingInlinedBlock()
+                        while inlined_block.IsValid():
+                            inline_depth += 1
+                            inlined_block = inlined_block.GetParent().GetContainingInlinedBlock()
+                        max_inline_depth = max(max_inline_depth, inline_depth)
+
+        # The innermost instructions are inside the whole chain.
+        self.assertTrue(max_inline_depth >= 256, "max inline depth is %d" % max_inline_depth)
+        print "lldb block lookup for %d addresses benchmark:" % len(addresses), self.stopwatch
+
+        self.dbg.DeleteTarget(target)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
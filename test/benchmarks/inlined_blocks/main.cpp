@@ -0,0 +1,47 @@
+// Inlines long chains of calls into main() so that it has about two thousand
+// nested inlined subroutine and lexical blocks.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+volatile int g_sink;
+
+template <int Chain, int Depth>
+struct Step
+{
+    __attribute__((always_inline)) static inline int
+    run (int value)
+    {
+        int before = value * (Depth + Chain) + 1;
+        g_sink = before;
+        {
+            int inner = Step<Chain, Depth - 1>::run (before ^ Depth);
+            g_sink = inner;
+            value += inner;
+        }
+        return value - before;
+    }
+};
+
+template <int Chain>
+struct Step<Chain, 0>
+{
+    __attribute__((always_inline)) static inline int
+    run (int value)
+    {
+        g_sink = value;
+        return value + Chain;
+    }
+};
+
+int
+main (int argc, char const *argv[])
+{
+    int value = argc > 1 ? atoi (argv[1]) : 0;
+    value = Step<0, 256>::run (value);
+    value = Step<1, 256>::run (value);
+    value = Step<2, 256>::run (value);
+    value = Step<3, 256>::run (value);
+    printf ("%d\n", value); // Set a breakpoint here.
+    return 0;
+}
@@ -0,0 +1,58 @@
+"""Benchmark setting regular expression breakpoints and 'image lookup --regex' on a large binary."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+
+class RegexBreakpointSpeedBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        # The default self.stopwatch is for "breakpoint set -r".
+        # Create self.stopwatch2 for measuring "image lookup -r -n".
+        self.stopwatch2 = Stopwatch()
+        if lldb.bmExecutable:
+            self.exe = lldb.bmExecutable
+        else:
+            self.exe = self.lldbHere
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 10
+
+    @benchmarks_test
+    def test_regex_breakpoint_speed(self):
+        """Benchmark regular expression breakpoints and lookups, with and without a literal the search can prefilter on."""
+        print
+        target = self.dbg.CreateTarget(self.exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # Parse the symbol tables and debug info indexes outside of the timed runs.
+        target.BreakpointCreateByRegex("^main$")
+
+        for regex in ["Process.*Resume", "^lldb_private::Target::Get", "(DoResume|DoLaunch)$"]:
+            self.run_regex_breakpoint_bench(target, regex)
+            print "lldb regex breakpoint '%s' benchmark:" % regex, self.stopwatch
+            print "lldb image lookup -r -n '%s' benchmark:" % regex, self.stopwatch2
+
+        self.dbg.DeleteTarget(target)
+
+    def run_regex_breakpoint_bench(self, target, regex):
+        self.stopwatch.reset()
+        self.stopwatch2.reset()
+        for i in range(self.count):
+            with self.stopwatch:
+                bkpt = target.BreakpointCreateByRegex(regex)
+            self.assertTrue(bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+            target.BreakpointDelete(bkpt.GetID())
+
+            with self.stopwatch2:
+                self.runCmd("image lookup -r -n '%s'" % regex)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,71 @@
+"""Benchmark 'thread backtrace all' on a core file with many threads, serially and in parallel."""
+
+import os, sys, glob, subprocess
+import unittest2
+import lldb
+from lldbbench import *
+
+class BacktraceAllThreadsBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.num_threads = 1000
+        self.depth = 32
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 5
+
+    @benchmarks_test
+    @skipIfDarwin # Needs an ELF core file
+    def test_backtrace_all_threads(self):
+        """Benchmark unwinding all threads of a core file, serial vs. parallel."""
+        self.buildDefault()
+        exe = os.path.join(os.getcwd(), "a.out")
+        core = self.make_core_file(exe)
+
+        print
+        serial_avg = self.run_backtrace_all_bench(exe, core, None)
+        print "lldb serial 'thread backtrace all' benchmark:", self.stopwatch
+        parallel_avg = self.run_backtrace_all_bench(exe, core, 0)
+        print "lldb 'thread backtrace all --parallel 0' benchmark:", self.stopwatch
+        print "serial_avg/parallel_avg: %f" % (serial_avg/parallel_avg)
+
+    def make_core_file(self, exe):
+        for old_core in glob.glob(os.path.join(os.getcwd(), "core*")):
+            os.remove(old_core)
+        subprocess.call([exe, str(self.num_threads), str(self.depth)], cwd=os.getcwd())
+        cores = glob.glob(os.path.join(os.getcwd(), "core*"))
+        if not cores:
+            self.skipTest("no core file was written, check /proc/sys/kernel/core_pattern")
+        self.addTearDownHook(lambda: [os.remove(c) for c in cores])
+        return cores[0]
+
+    def run_backtrace_all_bench(self, exe, core, num_workers):
+        self.stopwatch.reset()
+        command = 'thread backtrace all'
+        if num_workers is not None:
+            command += ' --parallel %d' % num_workers
+        for i in range(self.count):
+            # Use a fresh target each time so no frames are cached
+            target = self.dbg.CreateTarget(exe)
+            self.assertTrue(target, VALID_TARGET)
+            process = target.LoadCore(core)
+            self.assertTrue(process, PROCESS_IS_VALID)
+            self.assertTrue(process.GetNumThreads() > self.num_threads)
+
+            result = lldb.SBCommandReturnObject()
+            with self.stopwatch:
+                self.dbg.GetCommandInterpreter().HandleCommand(command, result)
+            self.assertTrue(result.Succeeded(), result.GetError())
+            self.assertTrue(result.GetOutput().count('recurse') >= self.num_threads * self.depth)
+
+            self.dbg.DeleteTarget(target)
+        return self.stopwatch.avg()
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,60 @@
+// Creates many threads, each parked at the bottom of a call chain, and then
+// aborts so that the system writes a core file with all of them in it.
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+static pthread_barrier_t g_barrier;
+
+__attribute__((noinline)) static void *
+recurse (int depth)
+{
+    if (depth == 0)
+    {
+        pthread_barrier_wait (&g_barrier);
+        for (;;)
+            pause ();
+    }
+    void *result = recurse (depth - 1);
+    asm volatile ("" ::: "memory"); // Keep this from being a tail call.
+    return result;
+}
+
+static void *
+thread_func (void *arg)
+{
+    return recurse ((int)(long)arg);
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int num_threads = argc > 1 ? atoi (argv[1]) : 1000;
+    int depth = argc > 2 ? atoi (argv[2]) : 32;
+
+    struct rlimit core_limit = { RLIM_INFINITY, RLIM_INFINITY };
+    setrlimit (RLIMIT_CORE, &core_limit);
+
+    pthread_barrier_init (&g_barrier, NULL, num_threads + 1);
+
+    pthread_attr_t attr;
+    pthread_attr_init (&attr);
+    pthread_attr_setstacksize (&attr, 64 * 1024);
+    for (int i = 0; i < num_threads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create (&thread, &attr, thread_func, (void *)(long)(depth + i % 8)) != 0)
+        {
+            perror ("pthread_create");
+            return 1;
+        }
+    }
+
+    pthread_barrier_wait (&g_barrier);
+    abort (); // All threads are parked, dump core.
+    return 0;
+}
@@ -0,0 +1,90 @@
+"""
+Test that expressions reuse the memory lldb allocates for them in the process
+instead of allocating new memory every time.
+"""
+
+import os, re, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ExpressionArenaTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.log_file = os.path.join(os.getcwd(), "expression-arena.txt")
+
+    def run_to_breakpoint(self):
+        self.buildDefault()
+
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.expression-cache-size"))
+        self.addTearDownHook(lambda: os.path.isfile(self.log_file) and os.remove(self.log_file))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1)
+        self.runCmd("run", RUN_SUCCEEDED)
+
+    def run_expressions(self, first, count):
+        """Evaluate count different expressions and return the process log they produced."""
+        if os.path.isfile(self.log_file):
+            os.remove(self.log_file)
+        self.runCmd("log enable -f %s lldb process" % self.log_file)
+        for i in range(first, first + count):
+            self.expect("expression add_one(value + %d)" % i,
+                substrs = ["(int)", "= %d" % (42 + i)])
+        self.runCmd("log disable lldb process")
+
+        with open(self.log_file, 'r') as f:
+            return f.read()
+
+    def process_allocations(self, log):
+        """Return the permissions of each allocation made in the process."""
+        return re.findall(r'Process::DoAllocateMemory \(byte_size = 0x[0-9a-f]+, permissions = (\S+)\)', log)
+
+    def test_expression_arena(self):
+        """Test that repeated JIT expressions don't allocate process memory each time."""
+        self.run_to_breakpoint()
+
+        # The parsed expressions are kept, so none of their memory is freed
+        # and all of it has to come from the arenas.
+        num_exprs = 5
+        allocations = self.process_allocations(self.run_expressions(0, num_exprs))
+        self.assertTrue(len(allocations) == len(set(allocations)),
+                        "%d process allocations for %d expressions: %s" % (len(allocations), num_exprs, allocations))
+
+        # Many more expressions still fit in the same arenas.
+        num_exprs = 25
+        allocations = self.process_allocations(self.run_expressions(5, num_exprs))
+        self.assertTrue(len(allocations) == 0,
+                        "%d process allocations for %d more expressions: %s" % (len(allocations), num_exprs, allocations))
+
+    def test_expression_memory_reuse(self):
+        """Test that memory freed by one expression is handed out to the next one."""
+        self.run_to_breakpoint()
+
+        # Parse every expression again so each one gets new memory, and
+        # frees it when it is done.
+        self.runCmd("settings set target.expression-cache-size 0")
+        self.run_expressions(0, 1)
+
+        log = self.run_expressions(1, 1)
+        freed = set(re.findall(r'AllocatedMemoryCache::DeallocateMemory \(addr = (0x[0-9a-f]+)\) => 1', log))
+        self.assertTrue(len(freed) > 0, "The expression freed its memory")
+
+        log = self.run_expressions(2, 1)
+        allocated = set(re.findall(r'AllocatedMemoryCache::AllocateMemory \(byte_size = 0x[0-9a-f]+, permissions = \S+\) => (0x[0-9a-f]+)', log))
+        self.assertTrue(len(allocated & freed) > 0,
+                        "Allocated %s, none of the freed %s" % (sorted(allocated), sorted(freed)))
+        self.assertTrue(len(self.process_allocations(log)) == 0,
+                        "The process was asked for more memory")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+static int
+add_one (int x)
+{
+    return x + 1;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int value = 41;
+    printf ("%d\n", add_one (value)); // Set break point at this line.
+    return 0;
+}
@@ -0,0 +1,86 @@
+"""
+Test that expressions evaluated again in the same scope are reused from the
+expression cache, and that reused expressions see the current values.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ExpressionCacheTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.inner_line = line_number('main.c', '// Set break point in the inner block.')
+        self.return_line = line_number('main.c', '// Set break point at the return.')
+        self.log_file = os.path.join(os.getcwd(), "expression-cache.txt")
+
+    def test_expression_cache(self):
+        """Test that cached expressions are materialized from the current frame."""
+        self.buildDefault()
+
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.expression-cache-size"))
+        self.addTearDownHook(lambda: os.path.isfile(self.log_file) and os.remove(self.log_file))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.return_line, num_expected_locations=1)
+
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The same expressions at each stop: the second and third time
+        # around they come from the cache, but must still read i and value
+        # from the current frame and call square() in the inferior.
+        for i in range(3):
+            self.expect("expression value * 2 + i",
+                substrs = ["(int)", "= %d" % ((i + 10) * 2 + i)])
+            self.expect("expression square(value) - i",
+                substrs = ["(int)", "= %d" % ((i + 10) * (i + 10) - i)])
+            if i < 2:
+                self.runCmd("continue")
+
+        self.runCmd("log disable lldb expr")
+        with open(self.log_file, 'r') as f:
+            log = f.read()
+        self.assertTrue(log.count("Reusing parsed expression value * 2 + i") == 2,
+                        "expression reused from the cache")
+        self.assertTrue(log.count("Reusing parsed expression square(value) - i") == 2,
+                        "expression calling a function reused from the cache")
+
+    def test_expression_cache_scope(self):
+        """Test that expressions are not reused in a different block, or with the cache disabled."""
+        self.buildDefault()
+
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.expression-cache-size"))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.inner_line, num_expected_locations=1)
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.return_line, num_expected_locations=1)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # 'inner' is only visible in the inner block.
+        self.expect("expression inner + 1",
+            substrs = ["(int)", "= 31"])
+
+        self.runCmd("continue")
+        self.expect("expression inner + 1", error=True)
+
+        self.runCmd("settings set target.expression-cache-size 0")
+        self.runCmd("continue")
+        self.expect("expression inner + value",
+            substrs = ["(int)", "= 44"])
+        self.runCmd("continue")
+        self.expect("expression value",
+            substrs = ["(int)", "= 11"])
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
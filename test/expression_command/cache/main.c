@@ -0,0 +1,28 @@
+#include <stdio.h>
+
+static int
+square (int x)
+{
+    return x * x;
+}
+
+static int
+step (int i)
+{
+    int value = i + 10;
+    {
+        int inner = value * 3;
+        printf ("inner = %d\n", inner); // Set break point in the inner block.
+    }
+    return square (value); // Set break point at the return.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < 3; ++i)
+        total += step (i);
+    return total == 0;
+}
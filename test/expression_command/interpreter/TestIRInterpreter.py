@@ -0,0 +1,68 @@
+"""
+Test that expressions with floating point math, conditionals, aggregate
+copies and loops are evaluated by the IR interpreter without running code
+in the inferior.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class IRInterpreterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.log_file = os.path.join(os.getcwd(), "ir-interpreter.txt")
+
+    def test_ir_interpreter(self):
+        """Test that common expressions are interpreted."""
+        self.buildDefault()
+
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.expression-interpreter-instruction-limit"))
+        self.addTearDownHook(lambda: os.path.isfile(self.log_file) and os.remove(self.log_file))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        expressions = [
+            ("scale * pt.x", ["(double)", "= 7.5"]),
+            ("ratio + 1", ["(float)", "= 1.75"]),
+            ("(int)(scale * 3)", ["(int)", "= 7"]),
+            ("small * 2.0", ["(double)", "= -10"]),
+            ("(long)small", ["(long)", "= -5"]),
+            ("pt.x > 2 && scale < 3.0", ["(bool)", "= true"]),
+            ("count > 5 ? pt.y : pt.x", ["(int)", "= 4"]),
+            ("struct point copy = pt; copy.y", ["(int)", "= 4"]),
+            ("int sum = 0; for (int i = 0; i < count; ++i) sum += i; sum", ["(int)", "= 45"]),
+        ]
+
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+        for (expr, substrs) in expressions:
+            self.expect("expression -- %s" % expr, substrs = substrs)
+        self.runCmd("log disable lldb expr")
+
+        with open(self.log_file, 'r') as f:
+            log = f.read()
+        self.assertTrue(log.count("Interpreting the expression") == len(expressions),
+                        "all the expressions were interpreted")
+        self.assertTrue("Running the JIT compiled expression" not in log,
+                        "no expression was run in the inferior")
+
+        # Loops that run too long give up.
+        self.runCmd("settings set target.expression-interpreter-instruction-limit 100")
+        self.expect("expression -- int sum = 0; for (int i = 0; i < 1000; ++i) sum += i; sum", error=True,
+            substrs = ["too many cycles"])
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,19 @@
+#include <stdio.h>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int
+main (int argc, char const *argv[])
+{
+    struct point pt = { 3, 4 };
+    double scale = 2.5;
+    float ratio = 0.75f;
+    signed char small = -5;
+    int count = 10;
+    printf ("%d %d %f %f %d %d\n", pt.x, pt.y, scale, ratio, small, count); // Set break point at this line.
+    return 0;
+}
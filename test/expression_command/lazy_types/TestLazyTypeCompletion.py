@@ -0,0 +1,86 @@
+"""
+Test that expressions using nested, templated records give the same results
+whether the types of their fields are completed lazily or up front, and that
+the expression log reports the import statistics.
+"""
+
+import os, re, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class LazyTypeCompletionTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+        self.log_file = os.path.join(os.getcwd(), "lazy-type-completion.txt")
+
+    def test_lazy_type_completion(self):
+        """Test expressions on nested records with lazy field type completion."""
+        self.buildDefault()
+        self.lazy_type_completion_test("true")
+
+    def test_eager_type_completion(self):
+        """Test expressions on nested records with eager field type completion."""
+        self.buildDefault()
+        self.lazy_type_completion_test("false")
+
+    def lazy_type_completion_test(self, lazy):
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.expression-lazy-type-completion"))
+        self.addTearDownHook(lambda: os.path.isfile(self.log_file) and os.remove(self.log_file))
+
+        self.runCmd("settings set target.expression-lazy-type-completion %s" % lazy)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.runCmd("log enable -f %s lldb expr" % self.log_file)
+
+        # Only needs the members of Outer.
+        self.expect("expression outer.id",
+            substrs = ["(int)", "= 7"])
+
+        # Needs the members of the field types, and their layout.
+        self.expect("expression outer.middle.leaf.value.value",
+            substrs = ["(int)", "= 12"])
+        self.expect("expression outer.middle.counter.history.elements[2]",
+            substrs = ["(long)", "= 34"])
+        self.expect("expression outer.wrapped.value.leaf.value.weight",
+            substrs = ["(double)", "= 0.5"])
+        self.expect("expression sizeof(outer) == sizeof(Outer)",
+            substrs = ["(bool)", "= true"])
+
+        # Printing the whole record needs every field type.
+        self.expect("expression outer",
+            substrs = ["id = 7", "value = 12", "weight = 0.5"])
+
+        # $0 is the result of "expression outer.id" above.
+        self.expect("expression $0 + 1",
+            substrs = ["= 8"])
+
+        self.runCmd("log disable lldb expr")
+        with open(self.log_file, 'r') as f:
+            log = f.read()
+        self.assertTrue("Time spent importing and completing Decls" in log)
+
+        # The global counters include earlier tests, so only add up the
+        # per-expression ones.
+        deferred = [int(m.group(1)) for m in re.finditer(r"-- Local metrics --[^=]*?Number of field types left incomplete\s*:\s*(\d+)", log)]
+        self.assertTrue(len(deferred) > 0, "The expression log has the deferred completion counts")
+        if lazy == "true":
+            self.assertTrue(sum(deferred) > 0, "Field types were left incomplete")
+        else:
+            self.assertTrue(sum(deferred) == 0, "%d field types were left incomplete" % sum(deferred))
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,42 @@
+template <typename T, int N>
+struct Array
+{
+    T elements[N];
+};
+
+template <typename T>
+struct Wrapper
+{
+    T value;
+    Array<T, 4> history;
+};
+
+struct Leaf
+{
+    int value;
+    double weight;
+};
+
+struct Middle
+{
+    Wrapper<Leaf> leaf;
+    Wrapper<long> counter;
+};
+
+struct Outer
+{
+    Middle middle;
+    Wrapper<Middle> wrapped;
+    int id;
+};
+
+int
+main (int argc, char const *argv[])
+{
+    Outer outer = {};
+    outer.id = 7;
+    outer.middle.leaf.value.value = 12;
+    outer.middle.counter.history.elements[2] = 34;
+    outer.wrapped.value.leaf.value.weight = 0.5;
+    return outer.id - 7; // Set break point at this line.
+}
@@ -95,6 +95,15 @@ class BreakpointCommandTestCase(TestBase):
       
         lldbutil.run_break_set_by_regexp (self, r"._MyFunction", extra_options="-f a.c -f b.c", num_expected_locations=2)
 
+        # Some expressions the literal prefilter of the regex search has to see through:
+        lldbutil.run_break_set_by_regexp (self, r"^[ab]_MyFunc", num_expected_locations=2)
+
+        lldbutil.run_break_set_by_regexp (self, r"^a_MyFunction$", num_expected_locations=1)
+
+        lldbutil.run_break_set_by_regexp (self, r"(a|b)_My(Function|Nothing)", num_expected_locations=2)
+
+        lldbutil.run_break_set_by_regexp (self, r"x?_MyFunctio+n", num_expected_locations=2)
+
         # Now try a source regex breakpoint:
         lldbutil.run_break_set_by_source_regexp (self, r"is about to return [12]0", extra_options="-f a.c -f b.c", num_expected_locations=2)
       
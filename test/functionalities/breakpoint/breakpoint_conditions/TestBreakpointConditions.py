@@ -46,6 +46,20 @@ class BreakpointConditionsTestCase(TestBase):
         self.buildDwarf()
         self.breakpoint_conditions(inline=True)
 
+    @dwarf_test
+    def test_breakpoint_condition_with_dwarf_and_expression_evaluation(self):
+        """Exercise breakpoint conditions evaluated only through the expression parser."""
+        self.buildDwarf()
+        self.runCmd("settings set target.use-fast-breakpoint-conditions false")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.use-fast-breakpoint-conditions"))
+        self.breakpoint_conditions()
+
+    @dwarf_test
+    def test_breakpoint_condition_pointer_arithmetic_with_dwarf(self):
+        """Test that pointer arithmetic in a condition agrees with the expression parser."""
+        self.buildDwarf()
+        self.breakpoint_conditions_pointer_arithmetic()
+
     @python_api_test
     @dwarf_test
     def test_breakpoint_condition_with_dwarf_and_python_api(self):
@@ -59,6 +73,7 @@ class BreakpointConditionsTestCase(TestBase):
         # Find the line number to of function 'c'.
         self.line1 = line_number('main.c', '// Find the line number of function "c" here.')
         self.line2 = line_number('main.c', "// Find the line number of c's parent call here.")
+        self.line3 = line_number('main.c', '// Find the line number of function "d" here.')
 
     def breakpoint_conditions(self, inline=False):
         """Exercise breakpoint condition with 'breakpoint modify -c <expr> id'."""
@@ -132,6 +147,53 @@ class BreakpointConditionsTestCase(TestBase):
         self.expect("process status", PROCESS_EXITED,
             patterns = ['Process .* exited'])
 
+    def stop_with_condition(self, condition):
+        """Run to the first hit of 'd' where condition holds and return (*p, hit count)."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByName('d', 'a.out')
+        self.assertTrue(breakpoint and
+                        breakpoint.GetNumLocations() == 1,
+                        VALID_BREAKPOINT)
+        breakpoint.SetCondition(condition)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        from lldbutil import get_stopped_thread
+        thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint condition")
+        frame0 = thread.GetFrameAtIndex(0)
+        self.assertTrue(frame0.GetLineEntry().GetLine() == self.line3)
+        pointee = frame0.EvaluateExpression("*p").GetValueAsSigned()
+        hit_count = breakpoint.GetHitCount()
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+        return (pointee, hit_count)
+
+    def breakpoint_conditions_pointer_arithmetic(self):
+        """Evaluate conditions that do pointer arithmetic both with and without the expression parser."""
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.use-fast-breakpoint-conditions"))
+
+        # Pointer arithmetic is scaled by the pointee size, so 'p - base' is
+        # an element count and 'base + 2' is the third element, not the
+        # address two bytes past 'base'.
+        for condition in ['p - base == 2', 'p == base + 2', 'base + 3 - p == 1']:
+            self.runCmd("settings set target.use-fast-breakpoint-conditions true")
+            fast = self.stop_with_condition(condition)
+            self.runCmd("settings set target.use-fast-breakpoint-conditions false")
+            parsed = self.stop_with_condition(condition)
+            self.assertTrue(fast == parsed,
+                            "Condition '%s' stopped at %s with the fast path but %s with the expression parser" % (condition, str(fast), str(parsed)))
+
+        self.runCmd("settings set target.use-fast-breakpoint-conditions true")
+        self.assertTrue(self.stop_with_condition('p - base == 2') == (30, 3))
+        self.assertTrue(self.stop_with_condition('p == base + 2') == (30, 3))
+        self.assertTrue(self.stop_with_condition('base + 3 - p == 1') == (30, 3))
+
     def breakpoint_conditions_python(self):
         """Use Python APIs to set breakpoint conditions."""
         exe = os.path.join(os.getcwd(), "a.out")
@@ -36,6 +36,11 @@ int c(int val)
     return val + 3; // Find the line number of function "c" here.
 }
 
+int d(int *p, int *base)
+{
+    return *p; // Find the line number of function "d" here.
+}
+
 int main (int argc, char const *argv[])
 {
     int A1 = a(1);  // a(1) -> b(1) -> c(1)
@@ -49,6 +54,10 @@ int main (int argc, char const *argv[])
 
     for (int i = 0; i < 2; ++i)
         printf("Loop\n");
+
+    int values[4] = { 10, 20, 30, 40 };
+    for (int i = 0; i < 4; ++i)
+        printf("d(values + %d) returns %d\n", i, d(values + i, values));
     
     return 0;
 }
@@ -0,0 +1,99 @@
+"""
+Test that the literal prefilter of regex symbol searches never drops a name the
+regular expression matches.
+"""
+
+import os, re, sys, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class BreakpointRegexPrefilterTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The functions defined in main.c
+    functions = ['fo_bar', 'foo_bar', 'foooo_bar', 'foobar', 'bar_foo', 'foo_baz_qux', 'qux_foo_baz', 'main']
+
+    # Pairs of an extended regular expression and the Python one that
+    # matches the same names.
+    patterns = [
+        # Alternation
+        (r'foo_(bar|baz)', r'foo_(bar|baz)'),
+        (r'(fo|bar)_', r'(fo|bar)_'),
+        (r'foobar|bar_foo', r'foobar|bar_foo'),
+        # Optional characters and groups
+        (r'foo(_baz)?_qux', r'foo(_baz)?_qux'),
+        (r'fo(o)?_bar', r'fo(o)?_bar'),
+        (r'foo?_bar', r'foo?_bar'),
+        (r'foo*_bar', r'foo*_bar'),
+        (r'fo{1,4}_bar', r'fo{1,4}_bar'),
+        (r'foo+_bar', r'foo+_bar'),
+        (r'foo_baz+*', r'foo_baz*'),
+        (r'foo_ba+?r', r'foo_b(a+)?r'),
+        # Escapes
+        (r'foo\_bar', r'foo_bar'),
+        (r'foo\.bar', r'foo\.bar'),
+        (r'foo[.]*bar', r'foo\.*bar'),
+        # Anchors
+        (r'^foo', r'^foo'),
+        (r'bar$', r'bar$'),
+        (r'^foo_bar$', r'^foo_bar$'),
+        (r'^qux_', r'^qux_'),
+        (r'_baz$', r'_baz$'),
+        (r'^fo.*_bar$', r'^fo.*_bar$'),
+        (r'^f?oo_bar', r'^f?oo_bar'),
+        # No required literal
+        (r'^[a-z]+_[a-z]+$', r'^[a-z]+_[a-z]+$'),
+        (r'(foo|bar)', r'(foo|bar)'),
+        (r'^(foo|qux)_', r'^(foo|qux)_'),
+        (r'[fq][ou]+x?_', r'[fq][ou]+x?_'),
+    ]
+
+    # Word boundaries are a GNU extension.
+    if sys.platform.startswith("linux"):
+        patterns += [
+            (r'\<bar', r'\bbar'),
+            (r'_baz\>', r'_baz\b'),
+        ]
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test that regex breakpoints find every function the expression matches."""
+        self.buildDsym()
+        self.regex_prefilter()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that regex breakpoints find every function the expression matches."""
+        self.buildDwarf()
+        self.regex_prefilter()
+
+    def regex_prefilter(self):
+        """Compare the functions regex breakpoints find with the names Python's re matches."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        for (regex, python_regex) in self.patterns:
+            breakpoint = target.BreakpointCreateByRegex(regex, "a.out")
+            self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+            found = set()
+            for location in breakpoint:
+                symbol = location.GetAddress().GetSymbol()
+                if symbol and symbol.GetName() in self.functions:
+                    found.add(symbol.GetName())
+            target.BreakpointDelete(breakpoint.GetID())
+
+            expected = set([name for name in self.functions if re.search(python_regex, name)])
+            self.assertTrue(found == expected,
+                            "'%s' found %s, expected %s" % (regex, sorted(found), sorted(expected)))
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
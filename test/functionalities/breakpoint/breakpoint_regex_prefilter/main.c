@@ -0,0 +1,20 @@
+#include <stdio.h>
+
+// The names the regex breakpoints in TestBreakpointRegexPrefilter.py are
+// matched against.
+
+int fo_bar (void) { return 1; }
+int foo_bar (void) { return 2; }
+int foooo_bar (void) { return 3; }
+int foobar (void) { return 4; }
+int bar_foo (void) { return 5; }
+int foo_baz_qux (void) { return 6; }
+int qux_foo_baz (void) { return 7; }
+
+int
+main (int argc, char const *argv[])
+{
+    int total = fo_bar () + foo_bar () + foooo_bar () + foobar () + bar_foo () + foo_baz_qux () + qux_foo_baz ();
+    printf ("total = %d\n", total);
+    return 0;
+}
@@ -0,0 +1,100 @@
+"""
+Test hardware breakpoints, and watchpoints in threads created after the watchpoint was set.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class HardwareBreakpointsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_hardware_breakpoint_with_dwarf(self):
+        """Test that a hardware breakpoint stops once per call and lets the thread continue."""
+        self.buildDwarf()
+        self.hardware_breakpoint_test()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_watchpoint_in_new_thread_with_dwarf(self):
+        """Test that a watchpoint is hit in a thread created after it was set."""
+        self.buildDwarf()
+        self.watchpoint_in_new_thread_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to set the watchpoint at.
+        self.watch_line = line_number('main.cpp', '// Set watchpoint here')
+
+    def hardware_breakpoint_test(self):
+        """Test that a hardware breakpoint stops once per call and lets the thread continue."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -H -n hot_function", BREAKPOINT_CREATED,
+            startstr = "Breakpoint 1: where = a.out`hot_function")
+
+        # Run the program.
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+
+        for i in range(5):
+            self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+            thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+            self.assertTrue(thread.IsValid(), STOPPED_DUE_TO_BREAKPOINT)
+
+            # The thread stops at each call exactly once.
+            value = thread.GetFrameAtIndex(0).FindVariable("value")
+            self.assertTrue(value.GetValueAsSigned() == i, "Stopped in the call with value %d" % i)
+            self.runCmd("continue")
+
+        # At this point, the inferior process should have exited.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.expect("breakpoint list -f", "Breakpoint hit once per call",
+            substrs = ["hit count = 5"])
+
+    def watchpoint_in_new_thread_test(self):
+        """Test that a watchpoint is hit in a thread created after it was set."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.watch_line, num_expected_locations=1)
+
+        # Run the program.
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+
+        self.expect("watchpoint set variable -w write g_watched", WATCHPOINT_CREATED,
+            substrs = ['Watchpoint created', 'size = 4', 'type = w'])
+
+        self.runCmd("continue")
+
+        # The thread that writes the variable stops for the watchpoint.
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonWatchpoint)
+        self.assertTrue(thread.IsValid(), "Stopped due to the watchpoint")
+        self.assertTrue(thread.GetFrameAtIndex(0).GetFunctionName().startswith("thread_func"),
+                        "Watchpoint hit in the new thread")
+
+        self.runCmd("watchpoint delete")
+        self.runCmd("continue")
+
+        # At this point, the inferior process should have exited.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
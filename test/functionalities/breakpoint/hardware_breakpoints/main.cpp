@@ -0,0 +1,43 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// The main thread calls hot_function in a loop, and then starts a thread that
+// writes g_watched.  The thread is created after the watchpoint is set, so it
+// only gets the debug registers when it is first resumed.
+
+#include <pthread.h>
+
+volatile int g_sum;
+volatile int g_watched;
+
+int
+hot_function (int value)
+{
+    g_sum += value;
+    return g_sum;
+}
+
+void *
+thread_func (void *input)
+{
+    g_watched = 1;
+    return NULL;
+}
+
+int main ()
+{
+    for (int i = 0; i < 5; i++)
+        hot_function (i);
+
+    pthread_t thread;   // Set watchpoint here
+    pthread_create (&thread, NULL, thread_func, NULL);
+    pthread_join (thread, NULL);
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+"""
+Test which breakpoint conditions are sent to a gdb-remote stub with the Z packets.
+"""
+
+import os, re, sys, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class StubBreakpointConditionsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires a gdb-remote stub")
+    @dsym_test
+    def test_default_with_dsym(self):
+        """Test that conditions are not sent to the stub by default."""
+        self.buildDsym()
+        self.stub_conditions(False)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires a gdb-remote stub")
+    @dwarf_test
+    def test_default_with_dwarf(self):
+        """Test that conditions are not sent to the stub by default."""
+        self.buildDwarf()
+        self.stub_conditions(False)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires a gdb-remote stub")
+    @dwarf_test
+    def test_enabled_with_dwarf(self):
+        """Test that conditions are only sent to stubs that can evaluate them."""
+        self.buildDwarf()
+        self.stub_conditions(True)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def stub_conditions(self, enable):
+        """Stop at a conditional breakpoint and look at the Z packets that inserted it."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        setting = "plugin.process.gdb-remote.target-side-breakpoint-conditions"
+        self.expect("settings show " + setting, substrs = [setting + " (boolean) = false"])
+        if enable:
+            self.runCmd("settings set %s true" % setting)
+            self.addTearDownHook(lambda: self.runCmd("settings set %s false" % setting))
+
+        log_file = os.path.join(os.getcwd(), "packets.log")
+        self.addTearDownHook(lambda: os.path.exists(log_file) and os.remove(log_file))
+        self.runCmd("log enable -f " + log_file + " gdb-remote packets")
+        self.addTearDownHook(lambda: self.runCmd("log disable gdb-remote packets"))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+        self.runCmd("breakpoint modify -c 'value == 7' 1")
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # Wherever the condition is evaluated, we only stop when it is true.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+        self.expect("frame variable value", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['(int) value = 7'])
+
+        self.runCmd("log disable gdb-remote packets")
+        with open(log_file, 'r') as f:
+            log = f.read()
+
+        # Only a stub that says it can evaluate conditions gets them, and
+        # then only if the setting allows it.
+        stub_evaluates = "ConditionalBreakpoints+" in log
+        z_packets = re.findall(r'send packet: \$(Z[01],[^#]*)#', log)
+        self.assertTrue(len(z_packets) > 0, "Found the Z packets in the log")
+        for packet in z_packets:
+            conditions = packet.split(';')[1:]
+            if enable and stub_evaluates:
+                for condition in conditions:
+                    self.assertTrue(re.match(r'X[0-9a-fA-F]+,[0-9a-fA-F]+$', condition),
+                                    "Unexpected condition in %s" % packet)
+            else:
+                self.assertTrue(len(conditions) == 0, "Conditions were sent with %s" % packet)
+
+        if enable and stub_evaluates:
+            self.assertTrue(any(';X' in packet for packet in z_packets), "No conditions were sent")
+        else:
+            # lldb saw every hit and checked the condition itself.
+            self.expect("breakpoint list -f", substrs = ['hit count = 8'])
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,26 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+int
+check (int value)
+{
+    return value * 2; // Set break point at this line.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int sum = 0;
+    int i;
+    for (i = 0; i < 10; ++i)
+        sum += check (i);
+    printf ("sum = %d\n", sum);
+    return 0;
+}
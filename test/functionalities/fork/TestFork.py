@@ -0,0 +1,169 @@
+"""
+Test following either process after the inferior forks.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ForkTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_follow_parent_with_dwarf(self):
+        """Test that the child runs on its own when following the parent."""
+        self.buildDwarf()
+        self.fork_test("parent")
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_follow_child_with_dwarf(self):
+        """Test that the target carries on with the child when following it."""
+        self.buildDwarf()
+        self.fork_test("child")
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_follow_parent_vfork_with_dwarf(self):
+        """Test that a vforked child runs on its own when following the parent."""
+        self.buildDwarf()
+        self.fork_test("parent", ["vfork"])
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_follow_child_vfork_with_dwarf(self):
+        """Test that the target carries on with a vforked child when following it."""
+        self.buildDwarf()
+        self.follow_vfork_child_test()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_step_over_fork_follow_child_with_dwarf(self):
+        """Test that stepping over fork() while following the child stops in the child."""
+        self.buildDwarf()
+        self.step_over_fork_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers for our breakpoints.
+        self.breakpoint = line_number('main.cpp', '// Set breakpoint here')
+        self.parent_breakpoint = line_number('main.cpp', '// Set parent breakpoint here')
+        self.fork_line = line_number('main.cpp', '// Step over fork here')
+
+    def set_follow_fork_mode(self, mode):
+        self.runCmd("settings set target.process.follow-fork-mode " + mode)
+        self.addTearDownHook(lambda: self.runCmd("settings set target.process.follow-fork-mode parent"))
+
+    def fork_test(self, mode, args=None):
+        """Test following the parent or the child after the inferior forks."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.set_follow_fork_mode(mode)
+
+        # Forks are only traced when the child is followed.  Otherwise the
+        # child keeps any breakpoints it inherits, so the parent is only
+        # stopped where the child doesn't go.
+        if mode == "child":
+            lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+        else:
+            lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.parent_breakpoint, num_expected_locations=1)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.LaunchSimple (args, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        parent_pid = process.GetProcessID()
+
+        # Only the followed process stops at the breakpoint, once, and
+        # nothing stops for the fork itself.
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        threads = lldbutil.get_stopped_threads(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(len(threads) == 1, STOPPED_DUE_TO_BREAKPOINT)
+        frame = threads[0].GetFrameAtIndex(0)
+        if mode == "child":
+            value = frame.FindVariable("value").GetValueAsUnsigned()
+            self.assertTrue(process.GetProcessID() != parent_pid, "Following the child")
+            self.assertTrue(value == 1, "Stopped in the child")
+        else:
+            status = frame.FindVariable("status").GetValueAsSigned()
+            self.assertTrue(process.GetProcessID() == parent_pid, "Following the parent")
+            self.assertTrue(status == 0, "Stopped in the parent after the child exited cleanly")
+
+        self.runCmd("continue")
+
+        # At this point, the followed process should have exited cleanly.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Inferior didn't exit cleanly")
+
+    def follow_vfork_child_test(self):
+        """Test following a vforked child."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.set_follow_fork_mode("child")
+
+        # The child shares its memory with the parent that is let go, so the
+        # breakpoints stay out of both until the child execs.
+        bkpt_id = lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.LaunchSimple (["vfork"], None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        # The child never stops, and the exit reported is its own.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Child didn't exit cleanly")
+        self.assertTrue(target.FindBreakpointByID(bkpt_id).GetHitCount() == 0,
+                        "The breakpoint is out of the vforked child")
+
+    def step_over_fork_test(self):
+        """Test that stepping over fork() while following the child stops in the child."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.set_follow_fork_mode("child")
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.fork_line, num_expected_locations=1)
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        parent_pid = process.GetProcessID()
+
+        threads = lldbutil.get_stopped_threads(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(len(threads) == 1, STOPPED_DUE_TO_BREAKPOINT)
+
+        # The step can't go on in the child, so the child stops where it
+        # forked instead of running to its next breakpoint.
+        threads[0].StepOver()
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.assertTrue(process.GetProcessID() != parent_pid, "Following the child")
+        threads = lldbutil.get_stopped_threads(process, lldb.eStopReasonTrace)
+        self.assertTrue(len(threads) == 1, "The child stopped after the fork")
+        self.assertTrue(threads[0].GetStopDescription(100).startswith("process forked"),
+                        "The stop reports the fork")
+        self.assertTrue(threads[0].GetThreadID() == process.GetProcessID(),
+                        "The child's thread stopped")
+
+        # The child then runs into the breakpoint it kept.
+        process.Continue()
+        threads = lldbutil.get_stopped_threads(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(len(threads) == 1, STOPPED_DUE_TO_BREAKPOINT)
+        value = threads[0].GetFrameAtIndex(0).FindVariable("value").GetValueAsUnsigned()
+        self.assertTrue(value == 1, "Stopped in the child")
+
+        process.Continue()
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Child didn't exit cleanly")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
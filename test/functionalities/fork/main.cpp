@@ -0,0 +1,41 @@
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int
+work (int value)
+{
+    return value + 1; // Set breakpoint here
+}
+
+int
+main (int argc, char const *argv[])
+{
+    // With "vfork", the child shares the memory of the parent, which is
+    // suspended until the child exits.
+    const bool use_vfork = argc > 1 && strcmp (argv[1], "vfork") == 0;
+
+    pid_t child;
+    if (use_vfork)
+    {
+        child = vfork ();
+        if (child == 0)
+            _exit (work (1) == 2 ? 0 : 1);
+    }
+    else
+    {
+        child = fork (); // Step over fork here
+        if (child == 0)
+            return work (1) == 2 ? 0 : 1;
+    }
+
+    // When the child is followed, it inherits the breakpoint in work(), so
+    // the parent only exits cleanly if the debugger takes it out of the
+    // process it lets go.
+    int status = -1;
+    const pid_t waited = waitpid (child, &status, 0);
+    if (waited != child || !WIFEXITED (status) || WEXITSTATUS (status) != 0) // Set parent breakpoint here
+        return 1;
+    return work (2) == 3 ? 0 : 1;
+}
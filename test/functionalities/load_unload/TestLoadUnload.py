@@ -24,6 +24,8 @@ class LoadUnloadTestCase(TestBase):
                                 '// Set break point at this line for test_lldb_process_load_and_unload_commands().')
         self.line_d_function = line_number('d.c',
                                            '// Find this line number within d_dunction().')
+        self.line_b_function = line_number('b.c',
+                                           '// Set break point at this line for test_load_unload_by_file_and_line().')
         if not sys.platform.startswith("darwin"):
             if "LD_LIBRARY_PATH" in os.environ:
                 self.runCmd("settings set target.env-vars " + self.dylibPath + "=" + os.environ["LD_LIBRARY_PATH"] + ":" + os.getcwd())
@@ -239,6 +241,43 @@ class LoadUnloadTestCase(TestBase):
         self.expect("breakpoint list -f", BREAKPOINT_HIT_ONCE,
             substrs = [' resolved, hit count = 2'])
 
+    @skipIfFreeBSD # llvm.org/pr14424 - missing FreeBSD Makefiles/testcase support
+    @not_remote_testsuite_ready
+    def test_load_unload_by_file_and_line(self):
+        """Test that pending file and line and name breakpoints resolve only in the libraries that have them."""
+
+        # Invoke the default build rule.
+        self.buildDefault()
+
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # Neither b.c nor c_function is in a library that is loaded yet.
+        lldbutil.run_break_set_by_file_and_line (self, "b.c", self.line_b_function, num_expected_locations=0)
+        lldbutil.run_break_set_by_symbol (self, "c_function", num_expected_locations=0)
+        # A breakpoint that never resolves must not pick up locations elsewhere.
+        lldbutil.run_break_set_by_symbol (self, "no_such_function_in_any_library", num_expected_locations=0)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # libloadunload_b gets loaded along with libloadunload_a, before c.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'b_function',
+                       'stop reason = breakpoint 1.'])
+
+        # The second time around libloadunload_c has been loaded as well.
+        self.runCmd("continue")
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'b_function',
+                       'stop reason = breakpoint 1.'])
+        self.expect("breakpoint list -f 2", "c_function breakpoint resolved in libloadunload_c",
+            substrs = ['c_function', 'locations = 1'])
+
+        self.expect("breakpoint list -f 3", "Unresolvable breakpoint has no locations",
+            substrs = ['no_such_function_in_any_library', 'locations = 0'])
+
     @skipIfFreeBSD # llvm.org/pr14424 - missing FreeBSD Makefiles/testcase support
     @not_remote_testsuite_ready
     def test_step_over_load (self):
@@ -9,5 +9,5 @@
 int
 b_function ()
 {
-  return 500;
+  return 500; // Set break point at this line for test_load_unload_by_file_and_line().
 }
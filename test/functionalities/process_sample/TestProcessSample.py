@@ -0,0 +1,126 @@
+"""
+Test the 'process sample' command.
+"""
+
+import os, sys, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ProcessSampleTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test that 'process sample' collects stacks from a running process."""
+        self.buildDsym()
+        self.process_sample()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that 'process sample' collects stacks from a running process."""
+        self.buildDwarf()
+        self.process_sample()
+
+    @dwarf_test
+    def test_breakpoint_while_sampling_with_dwarf(self):
+        """Test that a breakpoint hit while sampling is reported as a stop."""
+        self.buildDwarf()
+        self.breakpoint_while_sampling()
+
+    @dwarf_test
+    def test_frame_pointer_walk_with_dwarf(self):
+        """Test that 'process sample' follows the frame pointers of code without unwind tables."""
+        # Without debug info there is no .debug_frame either, so nothing but
+        # the frame pointers describes how to get out of spin().
+        d = {'CFLAGS_EXTRAS': '-g0 -fno-omit-frame-pointer -fno-asynchronous-unwind-tables -fno-unwind-tables'}
+        self.buildDwarf(dictionary=d)
+        self.setTearDownCleanup(dictionary=d)
+        self.frame_pointer_walk()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers to break at.
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.spin_line = line_number('main.c', '// Break here while sampling.')
+
+    def process_sample(self):
+        """Sample a spinning process in both output formats."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The breakpoint would end sampling early, so get it out of the way.
+        self.runCmd("breakpoint delete 1")
+
+        self.expect("process sample --count 5 --interval 5",
+            substrs = ['main;', 'spin', '5 samples', 'overhead:'])
+
+        # The process is left stopped and can be sampled again.
+        self.expect("process status", substrs = ['stopped'])
+
+        pprof_file = os.path.join(os.getcwd(), "sample.prof")
+        self.addTearDownHook(lambda: os.path.exists(pprof_file) and os.remove(pprof_file))
+        self.expect("process sample -c 3 -i 5 -f pprof -o " + pprof_file,
+            substrs = ['Wrote pprof profile', '3 samples'])
+        self.assertTrue(os.path.getsize(pprof_file) > 0, "the profile was written")
+
+        # The binary format needs somewhere to go.
+        self.expect("process sample -f pprof", error=True,
+            substrs = ['requires an output file'])
+
+    def frame_pointer_walk(self):
+        """Sample a process whose own functions have no unwind information."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # There is no line table, so stop at main by name.
+        lldbutil.run_break_set_by_symbol (self, "main", num_expected_locations=1, sym_exact=True)
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.runCmd("breakpoint delete 1")
+
+        # Getting from spin() to main() is up to the frame pointer chain, so
+        # the caller only shows up if the ABI's frame layout was used.
+        self.expect("process sample --count 5 --interval 5",
+            substrs = ['main;a.out`spin', '5 samples'])
+
+    def breakpoint_while_sampling(self):
+        """Test that a breakpoint hit while sampling is reported as a stop."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        listener = lldb.SBListener("lldb.test.process_sample.listener")
+        process.GetBroadcaster().AddListener(listener, lldb.SBProcess.eBroadcastBitStateChanged)
+
+        # The loop runs into this breakpoint as soon as sampling resumes it.
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.spin_line, num_expected_locations=1, loc_exact=True)
+        self.expect("process sample --count 50 --interval 5",
+            substrs = ['Sampling stopped early: process stopped before it was interrupted'])
+
+        # The stop the sampler didn't cause is passed on to the other
+        # listeners once sampling is over, and only that stop.
+        num_stopped_events = 0
+        event = lldb.SBEvent()
+        while listener.WaitForEvent(1, event):
+            if lldb.SBProcess.GetStateFromEvent(event) == lldb.eStateStopped:
+                num_stopped_events += 1
+        self.assertTrue(num_stopped_events == 1, "%d stops were reported" % num_stopped_events)
+
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread and thread.IsValid(), "Stopped at the breakpoint in spin()")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include <time.h>
+
+volatile unsigned long g_counter = 0;
+
+void
+spin (void)
+{
+    time_t start = time (NULL);
+    // Keep the process busy long enough to be sampled, but don't hang
+    // forever if the debugger goes away.
+    while (time (NULL) - start < 60)
+        ++g_counter; // Break here while sampling.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    printf ("starting to spin\n"); // Set break point at this line.
+    spin ();
+    return 0;
+}
@@ -31,6 +31,13 @@ class RegisterCommandsTestCase(TestBase):
         self.buildDefault()
         self.fp_register_write()
 
+    def test_register_write_and_continue(self):
+        """Test that a register written while stopped is seen by the inferior once it continues."""
+        if not self.getArchitecture() in ['amd64', 'x86_64']:
+            self.skipTest("This test requires x86_64 as the architecture for the inferior")
+        self.buildDefault()
+        self.register_write_and_continue()
+
     def test_register_expressions(self):
         """Test expression evaluation with commands related to registers."""
         if not self.getArchitecture() in ['amd64', 'i386', 'x86_64']:
@@ -247,6 +254,37 @@ class RegisterCommandsTestCase(TestBase):
         self.expect("register read rax 0x1234567887654321",
             substrs = ['0x1234567887654321'])
 
+    def register_write_and_continue(self):
+        """Test that a register written while stopped is seen by the inferior once it continues."""
+        self.common_setup()
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+
+        # Stop on the first instruction of return_argument(), before the
+        # argument has been moved out of rdi.
+        symbols = target.FindSymbols("return_argument")
+        self.assertTrue(symbols.GetSize() == 1, "Found return_argument")
+        start_addr = symbols.GetContextAtIndex(0).GetSymbol().GetStartAddress()
+        entry_bkpt = target.BreakpointCreateByAddress(start_addr.GetLoadAddress(target))
+        self.assertTrue(entry_bkpt, VALID_BREAKPOINT)
+        check_line = line_number('main.cpp', '// Check the result here.')
+        check_bkpt = target.BreakpointCreateByLocation('main.cpp', check_line)
+        self.assertTrue(check_bkpt, VALID_BREAKPOINT)
+
+        process.Continue()
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, entry_bkpt)
+        self.assertTrue(len(threads) == 1, "Stopped at the start of return_argument()")
+
+        self.expect("register read rdi", substrs = ['rdi = 0x0000000000000007'])
+        self.runCmd("register write rdi 42")
+
+        # The write is only sent to the thread when it resumes, together with
+        # the resume itself.
+        process.Continue()
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, check_bkpt)
+        self.assertTrue(len(threads) == 1, "Stopped after return_argument() returned")
+        self.expect("expr g_result", substrs = ['= 42'])
+
     def convenience_registers_with_process_attach(self, test_16bit_regs):
         """Test convenience registers after a 'process attach'."""
         exe = os.path.join(os.getcwd(), "a.out")
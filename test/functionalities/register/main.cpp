@@ -9,6 +9,16 @@
 #include <stdio.h>
 #include <unistd.h>
 
+int g_result = 0;
+
+// The test changes the argument register before the first instruction of
+// this function runs.
+extern "C" int __attribute__((noinline))
+return_argument (int value)
+{
+    return value;
+}
+
 int main (int argc, char const *argv[])
 {
     char my_string[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 0};
@@ -24,5 +34,8 @@ int main (int argc, char const *argv[])
 
     printf("my_string=%s\n", my_string);
     printf("my_double=%g\n", my_double);
+
+    g_result = return_argument (7);
+    printf("g_result=%d\n", g_result); // Check the result here.
     return 0;
 }
@@ -0,0 +1,96 @@
+"""
+Test stepping over a breakpoint hit by several threads with displaced stepping.
+"""
+
+import os, re, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class DisplacedSteppingTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test stepping over a breakpoint hit by several threads with displaced stepping."""
+        self.buildDwarf()
+        self.displaced_stepping_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number for our breakpoint.
+        self.breakpoint = line_number('main.cpp', '// Set breakpoint here')
+
+    def displaced_stepping_test(self):
+        """Test stepping over a breakpoint hit by several threads with displaced stepping."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.runCmd("settings set target.process.displaced-stepping true")
+        self.addTearDownHook(lambda: self.runCmd("settings set target.process.displaced-stepping false"))
+
+        # The step log tells whether the instruction was stepped in a slot
+        # rather than in place with the other threads held.  The verbose log
+        # also says whenever a thread ran with the others held.
+        log_file = os.path.join(os.getcwd(), "step.log")
+        self.runCmd("log enable -v -f %s lldb step" % log_file)
+        def cleanup():
+            self.runCmd("log disable lldb step")
+            if os.path.exists(log_file):
+                os.remove(log_file)
+        self.addTearDownHook(cleanup)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+
+        # Run the program.
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        breakpoint_addr = target.GetBreakpointAtIndex(0).GetLocationAtIndex(0).GetLoadAddress()
+
+        # Each call stops once; several threads may stop for it at once.
+        hits = 0
+        while process.GetState() == lldb.eStateStopped:
+            threads = lldbutil.get_stopped_threads(process, lldb.eStopReasonBreakpoint)
+            self.assertTrue(len(threads) > 0, STOPPED_DUE_TO_BREAKPOINT)
+            for thread in threads:
+                self.assertTrue(thread.GetFrameAtIndex(0).GetLineEntry().GetLine() == self.breakpoint,
+                                "Stopped at the breakpoint, not in the copy of the instruction")
+            hits += len(threads)
+            self.runCmd("continue")
+
+        # At this point, the inferior process should have exited, without
+        # losing or repeating any of the adds.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "All calls were made once")
+        self.assertTrue(hits == 20, "Breakpoint hit once per call")
+
+        self.runCmd("log disable lldb step")
+        with open(log_file, "r") as f:
+            log = f.read()
+
+        # Every hit was stepped over in a slot.  Threads that were stopped
+        # right at the breakpoint step over it too, without a hit.
+        steps = re.findall(r"Stepping the \d+ byte instruction at (0x[0-9a-f]+) from 0x[0-9a-f]+\.", log)
+        self.assertTrue(len(steps) >= hits,
+                        "%d of %d hits were stepped in a displaced step slot" % (len(steps), hits))
+        for addr in steps:
+            self.assertTrue(int(addr, 16) == breakpoint_addr,
+                            "Stepped the instruction at %s, not the one at 0x%x" % (addr, breakpoint_addr))
+
+        # The breakpoint was never taken out, and no thread was held while
+        # another one stepped.
+        self.assertTrue("in place." not in log, "The breakpoint was lifted to step over it in place")
+        self.assertTrue("Turning on notification of new threads while single stepping" not in log,
+                        "Other threads were held during a displaced step")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
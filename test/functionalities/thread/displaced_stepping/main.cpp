@@ -0,0 +1,40 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Several threads run through the breakpoint over and over.  The instruction
+// under it is a %rip relative add, so it has to be relocated to be stepped
+// somewhere else.  The program exits with the number of calls that went
+// missing.
+
+#include <pthread.h>
+
+#define NUM_THREADS 4
+#define NUM_CALLS 5
+
+volatile int g_calls;
+
+void *
+thread_func (void *input)
+{
+    for (int i = 0; i < NUM_CALLS; i++)
+        __sync_fetch_and_add (&g_calls, 1);    // Set breakpoint here
+    return NULL;
+}
+
+int main ()
+{
+    pthread_t threads[NUM_THREADS];
+
+    for (int i = 0; i < NUM_THREADS; i++)
+        pthread_create (&threads[i], NULL, thread_func, NULL);
+    for (int i = 0; i < NUM_THREADS; i++)
+        pthread_join (threads[i], NULL);
+
+    return NUM_THREADS * NUM_CALLS - g_calls;
+}
@@ -0,0 +1,97 @@
+"""
+Test stopping, stepping and resuming a process with many threads.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ManyThreadsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # main.cpp creates this many threads besides the main thread.
+    num_threads = 200
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test stepping while many other threads are running."""
+        self.buildDsym(dictionary=self.getBuildFlags())
+        self.many_threads_test()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test stepping while many other threads are running."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.many_threads_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number for our breakpoint.
+        self.breakpoint = line_number('main.cpp', '// Set breakpoint here')
+
+    def many_threads_test(self):
+        """Test stepping while many other threads are running."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+
+        # Collect the stop statistics while the process runs.
+        self.runCmd("log timers enable")
+        self.addTearDownHook(lambda: self.runCmd("log timers disable"))
+
+        # Run the program.
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+
+        # Make sure we see all the threads, and that they are all stopped.
+        self.assertTrue(process.GetNumThreads() == self.num_threads + 1,
+                        'Number of expected threads and actual threads do not match.')
+        for thread in process:
+            self.assertTrue(thread.IsStopped(), "Thread %u didn't stop at the breakpoint" % thread.GetIndexID())
+
+        # Each step stops and resumes all the threads a few times.
+        main_thread = process.GetSelectedThread()
+        for i in range(3):
+            main_thread.StepOver()
+            self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+            self.assertTrue(main_thread.GetStopReason() == lldb.eStopReasonPlanComplete, "Step didn't complete")
+            self.assertTrue(process.GetNumThreads() == self.num_threads + 1,
+                            'Number of expected threads and actual threads do not match after stepping.')
+
+        # The other threads are left alone at each stop until someone looks at
+        # them.  Looking at them has to work, and so does stepping afterwards.
+        for thread in process:
+            self.assertTrue(thread.GetNumFrames() > 0, "Thread %u has no frames" % thread.GetIndexID())
+        main_thread.StepOver()
+        self.assertTrue(main_thread.GetStopReason() == lldb.eStopReasonPlanComplete, "Step after inspecting the threads didn't complete")
+
+        if sys.platform.startswith("linux"):
+            self.expect("log timers dump", "Stop statistics are shown",
+                substrs = ['samples of ProcessLinux::StopAllThreads() threads',
+                           'samples of ProcessLinux::StopAllThreads() latency (usec)'])
+
+        # Run to completion
+        self.runCmd("continue")
+
+        # At this point, the inferior process should have exited.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Inferior didn't exit cleanly")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
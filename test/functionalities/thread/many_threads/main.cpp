@@ -0,0 +1,61 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// This test creates a lot of threads that are all running when the main
+// thread stops, so that every stop and every step has to stop and resume all
+// of them.
+
+#include <pthread.h>
+#include <unistd.h>
+#include <atomic>
+
+#define NUM_THREADS 200
+
+std::atomic_int g_running;
+std::atomic_bool g_done;
+
+void *
+thread_func (void *input)
+{
+    g_running++;
+
+    // Keep running until the main thread is done, without hogging the CPU.
+    while (!g_done)
+        usleep (1000);
+
+    return NULL;
+}
+
+int main ()
+{
+    pthread_t threads[NUM_THREADS];
+    int i;
+
+    g_running = 0;
+    g_done = false;
+
+    for (i = 0; i < NUM_THREADS; ++i)
+        pthread_create (&threads[i], NULL, thread_func, NULL);
+
+    // Wait until all threads are running
+    while (g_running < NUM_THREADS)
+        usleep (1000);
+
+    int count = 0;      // Set breakpoint here
+    count++;
+    count++;
+    count++;
+
+    g_done = true;
+
+    for (i = 0; i < NUM_THREADS; ++i)
+        pthread_join (threads[i], NULL);
+
+    return count - 3;
+}
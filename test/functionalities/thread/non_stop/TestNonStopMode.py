@@ -0,0 +1,220 @@
+"""
+Test that other threads keep running while a thread is stopped in non-stop mode.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class NonStopModeTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that other threads keep running while a thread is stopped in non-stop mode."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.non_stop_test()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_interrupt_with_dwarf(self):
+        """Test that interrupting the process stops the threads that are still running."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.interrupt_test()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_detach_with_dwarf(self):
+        """Test that detaching works while threads are still running."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.detach_test()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_pending_stop_with_dwarf(self):
+        """Test that a stop that happens while the process is stopped is reported on the next resume."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.pending_stop_test()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires Linux")
+    @dwarf_test
+    def test_watchpoint_with_dwarf(self):
+        """Test that a watchpoint set while a thread is running also watches that thread."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.watchpoint_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers for our breakpoints.
+        self.breakpoint = line_number('main.cpp', '// Set breakpoint here')
+        self.worker_breakpoint = line_number('main.cpp', '// Set worker breakpoint here')
+
+    def counter_value(self, target):
+        counter = target.FindFirstGlobalVariable("g_counter")
+        self.assertTrue(counter.IsValid(), "g_counter found")
+        return counter.GetValueAsUnsigned()
+
+    def run_to_breakpoint(self):
+        """Run to the breakpoint in main in non-stop mode, and return the process and the main thread."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.runCmd("settings set target.process.non-stop-mode true")
+        self.addTearDownHook(lambda: self.runCmd("settings set target.process.non-stop-mode false"))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        main_thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(main_thread.IsValid(), STOPPED_DUE_TO_BREAKPOINT)
+        self.assertTrue(process.GetNumThreads() == 2, 'Number of expected threads and actual threads do not match.')
+        return (process, main_thread)
+
+    def get_worker_thread(self, process, main_thread):
+        for thread in process:
+            if thread.GetThreadID() != main_thread.GetThreadID():
+                return thread
+        self.fail("No worker thread")
+
+    def interrupt_test(self):
+        """Test that interrupting the process stops the threads that are still running."""
+        (process, main_thread) = self.run_to_breakpoint()
+        target = process.GetTarget()
+        worker_thread = self.get_worker_thread(process, main_thread)
+        self.assertFalse(worker_thread.IsStopped(), "Worker thread stopped in non-stop mode")
+
+        # The process is already stopped, so the interrupt only stops the
+        # worker.
+        self.assertTrue(process.Stop().Success(), "Interrupted the process")
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.assertTrue(worker_thread.IsStopped(), "Worker thread still running after the interrupt")
+
+        first = self.counter_value(target)
+        time.sleep(0.5)
+        self.assertTrue(self.counter_value(target) == first, "Worker thread counted after the interrupt")
+
+        # The interrupt isn't reported as a stop of the worker.
+        self.runCmd("breakpoint delete 1")
+        self.runCmd("continue")
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Inferior didn't exit cleanly")
+
+    def detach_test(self):
+        """Test that detaching works while threads are still running."""
+        (process, main_thread) = self.run_to_breakpoint()
+        worker_thread = self.get_worker_thread(process, main_thread)
+        self.assertFalse(worker_thread.IsStopped(), "Worker thread stopped in non-stop mode")
+
+        self.assertTrue(process.Detach().Success(), "Detached with a running thread")
+        self.assertTrue(process.GetState() == lldb.eStateDetached, "Process is detached")
+
+    def watchpoint_test(self):
+        """Test that a watchpoint set while a thread is running also watches that thread."""
+        (process, main_thread) = self.run_to_breakpoint()
+        worker_thread = self.get_worker_thread(process, main_thread)
+        self.assertFalse(worker_thread.IsStopped(), "Worker thread stopped in non-stop mode")
+
+        # The worker is the only thread that writes g_counter.  It has to be
+        # stopped to get the debug registers, and picks them up on resume.
+        self.expect("watchpoint set variable -w write g_counter", WATCHPOINT_CREATED,
+            substrs = ['Watchpoint created', 'size = 4', 'type = w'])
+        self.assertTrue(worker_thread.IsStopped(), "Worker thread kept running without the watchpoint")
+
+        self.runCmd("continue")
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.assertTrue(worker_thread.GetStopReason() == lldb.eStopReasonWatchpoint, "Worker thread didn't hit the watchpoint")
+
+        self.runCmd("watchpoint delete 1")
+        self.runCmd("breakpoint delete 1")
+        self.runCmd("continue")
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Inferior didn't exit cleanly")
+
+    def pending_stop_test(self):
+        """Test that a stop that happens while the process is stopped is reported on the next resume."""
+        (process, main_thread) = self.run_to_breakpoint()
+        worker_thread = self.get_worker_thread(process, main_thread)
+
+        # The worker runs into this breakpoint while the process is stopped,
+        # and that stop can't be reported until the process is resumed.
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.worker_breakpoint, num_expected_locations=1)
+        for i in range(100):
+            if worker_thread.IsStopped():
+                break
+            time.sleep(0.05)
+        self.assertTrue(worker_thread.IsStopped(), "Worker thread didn't reach its breakpoint")
+        self.runCmd("breakpoint delete 1")
+
+        # Resuming reports the worker's stop right away, and only resumes
+        # the main thread.
+        self.runCmd("continue")
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.assertTrue(worker_thread.GetStopReason() == lldb.eStopReasonBreakpoint, "Worker thread's stop wasn't reported")
+        self.assertTrue(worker_thread.GetFrameAtIndex(0).GetLineEntry().GetLine() == self.worker_breakpoint,
+                        "Worker thread stopped at its breakpoint")
+        self.assertFalse(main_thread.IsStopped(), "Main thread wasn't resumed")
+
+        self.runCmd("breakpoint delete 2")
+        self.runCmd("continue")
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Inferior didn't exit cleanly")
+
+    def non_stop_test(self):
+        """Test that other threads keep running while a thread is stopped in non-stop mode."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.runCmd("settings set target.process.non-stop-mode true")
+        self.addTearDownHook(lambda: self.runCmd("settings set target.process.non-stop-mode false"))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+
+        # Run the program.
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+
+        main_thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(main_thread.IsValid(), STOPPED_DUE_TO_BREAKPOINT)
+        self.assertTrue(process.GetNumThreads() == 2, 'Number of expected threads and actual threads do not match.')
+
+        # Only the thread that hit the breakpoint stopped.
+        for thread in process:
+            if thread.GetThreadID() != main_thread.GetThreadID():
+                self.assertFalse(thread.IsStopped(), "Worker thread stopped in non-stop mode")
+
+        # The worker keeps counting while we are stopped.
+        first = self.counter_value(target)
+        time.sleep(0.5)
+        second = self.counter_value(target)
+        self.assertTrue(second > first, "Worker thread didn't run while the main thread was stopped")
+
+        # Stepping only moves the main thread, and the worker keeps running.
+        main_thread.StepOver()
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.assertTrue(main_thread.GetStopReason() == lldb.eStopReasonPlanComplete, "Step didn't complete")
+        self.assertTrue(self.counter_value(target) > second, "Worker thread didn't run while stepping")
+
+        self.runCmd("breakpoint delete 1")
+
+        # Run to completion
+        self.runCmd("continue")
+
+        # At this point, the inferior process should have exited.
+        self.assertTrue(process.GetState() == lldb.eStateExited, PROCESS_EXITED)
+        self.assertTrue(process.GetExitStatus() == 0, "Inferior didn't exit cleanly")
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,51 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// The worker thread keeps counting while the main thread is stopped at the
+// breakpoint, and stops the counter when the main thread is done.
+
+#include <pthread.h>
+#include <unistd.h>
+
+volatile int g_counter;
+volatile bool g_done;
+
+void *
+thread_func (void *input)
+{
+    while (!g_done)
+    {
+        g_counter++;    // Set worker breakpoint here
+        usleep (1000);
+    }
+    return NULL;
+}
+
+int main ()
+{
+    pthread_t thread;
+
+    g_counter = 0;
+    g_done = false;
+
+    pthread_create (&thread, NULL, thread_func, NULL);
+
+    // Wait until the worker is counting
+    while (g_counter == 0)
+        usleep (1000);
+
+    int count = 0;      // Set breakpoint here
+    usleep (100000);
+    count++;
+
+    g_done = true;
+    pthread_join (thread, NULL);
+
+    return count - 1;
+}
@@ -0,0 +1,92 @@
+"""
+Test that unwinding all threads at once gives the same backtraces as unwinding
+them one at a time.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ParallelBacktraceTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # main.cpp creates this many threads besides the main thread.
+    num_threads = 16
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test that parallel backtraces match serial ones."""
+        self.buildDsym(dictionary=self.getBuildFlags())
+        self.parallel_backtrace_test()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that parallel backtraces match serial ones."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.parallel_backtrace_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number for our breakpoint.
+        self.breakpoint = line_number('main.cpp', '// Break here once all threads are parked.')
+
+    def get_backtraces(self, parallel):
+        """Run to the breakpoint and return the pcs of every thread's frames."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.cpp", self.breakpoint)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertTrue(len(lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)) == 1,
+                        "Stopped at the breakpoint")
+        self.assertTrue(process.GetNumThreads() >= self.num_threads + 1, "All threads are there")
+
+        if parallel:
+            num_unwound = process.ComputeStackFramesForAllThreads(0xffffffff, 4)
+            self.assertTrue(num_unwound == process.GetNumThreads(),
+                            "Unwound %d of %d threads" % (num_unwound, process.GetNumThreads()))
+
+        backtraces = []
+        for thread in process:
+            frames = [frame for frame in thread]
+            # The parked threads are somewhere in their wait loop, so only
+            # the return addresses below the bottom recurse() frame are the
+            # same from run to run.
+            for idx in range(len(frames)):
+                name = frames[idx].GetFunctionName()
+                if name and name.startswith('recurse'):
+                    frames = frames[idx + 1:]
+                    break
+            backtraces.append([frame.GetPC() for frame in frames])
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+        return sorted(backtraces)
+
+    def parallel_backtrace_test(self):
+        """Compare backtraces computed in parallel with ones computed serially."""
+        serial = self.get_backtraces(False)
+        parallel = self.get_backtraces(True)
+
+        self.assertTrue(len(serial) == len(parallel),
+                        "%d threads serially, %d in parallel" % (len(serial), len(parallel)))
+        for (serial_pcs, parallel_pcs) in zip(serial, parallel):
+            self.assertTrue(len(serial_pcs) == len(parallel_pcs),
+                            "%d frames serially, %d in parallel" % (len(serial_pcs), len(parallel_pcs)))
+            self.assertTrue(serial_pcs == parallel_pcs,
+                            "Serial pcs %s, parallel pcs %s" % (serial_pcs, parallel_pcs))
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
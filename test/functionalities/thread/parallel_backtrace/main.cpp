@@ -0,0 +1,60 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// This test parks a number of threads at the bottom of call chains of
+// different depths, so their backtraces can be compared when they are
+// computed one thread at a time and all at once.
+
+#include <pthread.h>
+#include <unistd.h>
+#include <atomic>
+
+#define NUM_THREADS 16
+
+std::atomic_int g_parked;
+std::atomic_bool g_done;
+
+__attribute__((noinline)) int
+recurse (int depth)
+{
+    if (depth == 0)
+    {
+        g_parked++;
+        while (!g_done)
+            usleep (1000);
+        return 0;
+    }
+    int result = recurse (depth - 1);
+    asm volatile ("" ::: "memory"); // Keep this from being a tail call.
+    return result + 1;
+}
+
+void *
+thread_func (void *input)
+{
+    recurse ((int)(long)input);
+    return NULL;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    pthread_t threads[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i)
+        pthread_create (&threads[i], NULL, thread_func, (void *)(long)(4 + i % 5));
+
+    while (g_parked < NUM_THREADS)
+        usleep (1000);
+
+    g_done = true; // Break here once all threads are parked.
+
+    for (int i = 0; i < NUM_THREADS; ++i)
+        pthread_join (threads[i], NULL);
+    return 0;
+}
@@ -0,0 +1,126 @@
+"""
+Test reading and writing the registers of several threads after a stop.
+"""
+
+import os, sys, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ThreadRegistersTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # main.cpp creates this many workers.
+    num_threads = 4
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test that each thread's registers are read and written separately."""
+        if not self.getArchitecture() in ['amd64', 'x86_64']:
+            self.skipTest("This test requires x86_64 as the architecture for the inferior")
+        self.buildDsym()
+        self.thread_registers()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that each thread's registers are read and written separately."""
+        if not self.getArchitecture() in ['amd64', 'x86_64']:
+            self.skipTest("This test requires x86_64 as the architecture for the inferior")
+        self.buildDwarf()
+        self.thread_registers()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers for our breakpoints.
+        self.go_line = line_number('main.cpp', '// Set breakpoint here')
+        self.check_line = line_number('main.cpp', '// Check the results here.')
+
+    def get_gprs(self, thread):
+        """Return a dictionary of the general purpose registers of thread."""
+        gprs = {}
+        for reg in lldbutil.get_GPRs(thread.GetFrameAtIndex(0)):
+            gprs[reg.GetName()] = reg.GetValueAsUnsigned()
+        return gprs
+
+    def thread_registers(self):
+        """Read all threads' registers at each stop, and write the ones a worker is about to use."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        go_bkpt = target.BreakpointCreateByLocation('main.cpp', self.go_line)
+        self.assertTrue(go_bkpt, VALID_BREAKPOINT)
+        check_bkpt = target.BreakpointCreateByLocation('main.cpp', self.check_line)
+        self.assertTrue(check_bkpt, VALID_BREAKPOINT)
+
+        # Stop on the first instruction of record(), while the arguments are
+        # still in rdi and rsi.
+        symbols = target.FindSymbols("record")
+        self.assertTrue(symbols.GetSize() == 1, "Found record")
+        start_addr = symbols.GetContextAtIndex(0).GetSymbol().GetStartAddress()
+        record_bkpt = target.BreakpointCreateByAddress(start_addr.GetLoadAddress(target))
+        self.assertTrue(record_bkpt, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, go_bkpt)
+        self.assertTrue(len(threads) == 1, "Stopped before releasing the workers")
+        self.assertTrue(process.GetNumThreads() == self.num_threads + 1, "All workers are there")
+
+        # Every thread has its own registers, and reading them again gives
+        # the same values.
+        snapshots = [self.get_gprs(thread) for thread in process]
+        stack_pointers = set([gprs['rsp'] for gprs in snapshots])
+        self.assertTrue(len(stack_pointers) == len(snapshots),
+                        "Each thread has its own stack pointer: %s" % [hex(sp) for sp in stack_pointers])
+        for (thread, gprs) in zip(process, snapshots):
+            self.assertTrue(self.get_gprs(thread) == gprs,
+                            "Registers of thread %d changed while stopped" % thread.GetThreadID())
+
+        recorded = set()
+        process.Continue()
+        while len(lldbutil.get_threads_stopped_at_breakpoint(process, record_bkpt)) > 0:
+            for thread in lldbutil.get_threads_stopped_at_breakpoint(process, record_bkpt):
+                gprs = self.get_gprs(thread)
+                index = gprs['rdi']
+                self.assertTrue(index < self.num_threads and index not in recorded,
+                                "Unexpected index %d in thread %d" % (index, thread.GetThreadID()))
+                self.assertTrue(gprs['rsi'] == index,
+                                "Thread %d passes %d, expected %d" % (thread.GetThreadID(), gprs['rsi'], index))
+                recorded.add(index)
+
+                # Change the value this worker will store.  The write must
+                # land in this thread only, and show up in the next read.
+                frame = thread.GetFrameAtIndex(0)
+                rsi = frame.FindRegister('rsi')
+                error = lldb.SBError()
+                self.assertTrue(rsi.SetValueFromCString(str(100 + index), error) and error.Success(),
+                                "Wrote rsi of thread %d" % thread.GetThreadID())
+                gprs['rsi'] = 100 + index
+                self.assertTrue(self.get_gprs(thread) == gprs,
+                                "Only rsi of thread %d changed" % thread.GetThreadID())
+
+            # The other threads' registers are still their own.
+            stack_pointers = set([self.get_gprs(thread)['rsp'] for thread in process])
+            self.assertTrue(len(stack_pointers) == process.GetNumThreads(),
+                            "Each thread has its own stack pointer: %s" % [hex(sp) for sp in stack_pointers])
+            process.Continue()
+
+        self.assertTrue(len(recorded) == self.num_threads,
+                        "Stopped in record() for %d of %d workers" % (len(recorded), self.num_threads))
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, check_bkpt)
+        self.assertTrue(len(threads) == 1, "Stopped after the workers finished")
+
+        # The written values were sent to the right threads when they resumed.
+        for index in range(self.num_threads):
+            self.expect("expr g_results[%d]" % index, substrs = ['= %d' % (100 + index)])
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
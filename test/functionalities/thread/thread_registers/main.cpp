@@ -0,0 +1,64 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Each worker passes its index to record() twice.  The test stops at the
+// start of record(), changes the second argument and checks that the
+// value the worker stores is the one it wrote.
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+
+volatile long g_results[NUM_THREADS];
+volatile int g_ready;
+volatile bool g_go;
+
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+__attribute__((noinline)) void
+record (long index, long value)
+{
+    g_results[index] = value;
+}
+
+void *
+thread_func (void *input)
+{
+    long index = (long)input;
+
+    pthread_mutex_lock (&g_mutex);
+    g_ready++;
+    pthread_mutex_unlock (&g_mutex);
+
+    while (!g_go)
+        usleep (1000);
+
+    record (index, index);
+    return NULL;
+}
+
+int main ()
+{
+    pthread_t threads[NUM_THREADS];
+
+    for (long i = 0; i < NUM_THREADS; ++i)
+        pthread_create (&threads[i], NULL, thread_func, (void *)i);
+
+    // Wait until all the workers are running
+    while (g_ready < NUM_THREADS)
+        usleep (1000);
+
+    g_go = true;    // Set breakpoint here
+
+    for (long i = 0; i < NUM_THREADS; ++i)
+        pthread_join (threads[i], NULL);
+
+    return 0;       // Check the results here.
+}
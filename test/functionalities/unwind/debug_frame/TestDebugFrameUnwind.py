@@ -0,0 +1,57 @@
+"""
+Test that we can backtrace through functions whose call frame information
+is only available in .debug_frame.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class DebugFrameUnwindTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfDarwin # Mach-O binaries keep their CFI in __eh_frame and compact unwind
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test backtracing with only .debug_frame call frame information."""
+        self.buildDwarf()
+        self.debug_frame_unwind()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def debug_frame_unwind(self):
+        """Stop in a leaf function and check the whole stack is walked."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        module = target.GetModuleAtIndex(0)
+        self.assertTrue(module.FindSection(".debug_frame").IsValid(),
+                        "the test program has a .debug_frame section")
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "there is a thread stopped at our breakpoint")
+
+        names = [thread.GetFrameAtIndex(i).GetFunctionName() for i in range(thread.GetNumFrames())]
+        if self.TraceOn():
+            print names
+        self.assertTrue(names[:4] == ['leaf', 'middle', 'outer', 'main'],
+                        "backtrace through .debug_frame only functions: %s" % names)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,33 @@
+#include <stdio.h>
+
+volatile int g_sink;
+
+__attribute__((noinline)) int
+leaf (int n)
+{
+    g_sink = n; // Set break point at this line.
+    return n + 1;
+}
+
+__attribute__((noinline)) int
+middle (int n)
+{
+    int r = leaf (n * 2);
+    g_sink += r;
+    return r;
+}
+
+__attribute__((noinline)) int
+outer (int n)
+{
+    int r = middle (n + 3);
+    g_sink += r;
+    return r;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    printf ("%d\n", outer (argc));
+    return 0;
+}
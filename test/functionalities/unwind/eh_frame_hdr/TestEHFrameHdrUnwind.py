@@ -0,0 +1,82 @@
+"""
+Test that we can backtrace using the FDEs found through the .eh_frame_hdr
+search table.
+"""
+
+import os, re, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class EHFrameHdrUnwindTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfDarwin # Mach-O binaries have no .eh_frame_hdr section
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test backtracing with FDEs looked up in the .eh_frame_hdr table."""
+        self.buildDwarf()
+        self.eh_frame_hdr_unwind()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def eh_frame_hdr_unwind(self):
+        """Stop in a leaf function and check the FDEs used to walk the stack."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        module = target.GetModuleAtIndex(0)
+        self.assertTrue(module.FindSection(".eh_frame_hdr").IsValid(),
+                        "the test program has a .eh_frame_hdr section")
+
+        log_file = os.path.join(os.getcwd(), "unwind.log")
+        self.addTearDownHook(lambda: os.path.exists(log_file) and os.remove(log_file))
+        self.runCmd("log enable -f " + log_file + " lldb unwind")
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb unwind"))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "there is a thread stopped at our breakpoint")
+
+        names = [thread.GetFrameAtIndex(i).GetFunctionName() for i in range(thread.GetNumFrames())]
+        if self.TraceOn():
+            print names
+        self.assertTrue(names[:4] == ['leaf', 'middle', 'outer', 'main'],
+                        "backtrace through .eh_frame_hdr lookups: %s" % names)
+
+        self.runCmd("log disable lldb unwind")
+        with open(log_file, 'r') as f:
+            log = f.read()
+
+        # Each caller was unwound with the FDE that covers exactly its
+        # function, found through the search table.
+        lookups = re.findall(r'\.eh_frame_hdr search table maps (0x[0-9a-f]+) to the FDE at 0x[0-9a-f]+ for \[(0x[0-9a-f]+)-(0x[0-9a-f]+)\)', log)
+        self.assertTrue(len(lookups) > 0, "FDEs were found in the search table")
+        for name in ['middle', 'outer', 'main']:
+            symbols = module.FindSymbols(name)
+            self.assertTrue(symbols.GetSize() == 1, "found the symbol for %s" % name)
+            symbol = symbols.GetContextAtIndex(0).GetSymbol()
+            start = symbol.GetStartAddress().GetFileAddress()
+            end = symbol.GetEndAddress().GetFileAddress()
+            ranges = [(int(lo, 16), int(hi, 16)) for (addr, lo, hi) in lookups if start <= int(addr, 16) < end]
+            self.assertTrue(len(ranges) > 0, "looked up the FDE for %s" % name)
+            for (lo, hi) in ranges:
+                self.assertTrue(lo == start and hi <= end,
+                                "FDE for [0x%x-0x%x) is used for %s at [0x%x-0x%x)" % (lo, hi, name, start, end))
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,86 @@
+"""Check that decoded variable locations give the same answers as the DWARF stack machine."""
+
+import os, sys, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class VariableLocationsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test that decoded variable locations match the stack machine."""
+        self.buildDsym()
+        self.compare_locations()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that decoded variable locations match the stack machine."""
+        self.buildDwarf()
+        self.compare_locations()
+
+    @dwarf_test
+    def test_optimized_with_dwarf(self):
+        """Test that decoded location lists match the stack machine."""
+        d = {'CFLAGS_EXTRAS': '-O1'}
+        self.buildDwarf(dictionary=d)
+        self.setTearDownCleanup(dictionary=d)
+        self.compare_locations()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Stop here.')
+
+    def get_variables(self):
+        """Run to the breakpoint and return the variables of every frame."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(len(threads) == 1, "Stopped at the breakpoint")
+        thread = threads[0]
+
+        variables = []
+        for frame in thread:
+            for value in frame.GetVariables(True, True, True, False):
+                variables.append((frame.GetFrameID(), value.GetName(), value.GetValue(),
+                                  value.GetLoadAddress(), str(value)))
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
+        return variables
+
+    def compare_locations(self):
+        """Read every variable with and without the decoded locations."""
+        decoded = self.get_variables()
+        self.assertTrue(len(decoded) > 0, "Found variables")
+
+        # The verbose expression log makes every location go through the
+        # stack machine, so it can be traced.
+        log_file = os.path.join(os.getcwd(), "expr.log")
+        self.addTearDownHook(lambda: os.path.exists(log_file) and os.remove(log_file))
+        self.runCmd("log enable -v -f " + log_file + " lldb expr")
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb expr"))
+        interpreted = self.get_variables()
+
+        self.assertTrue(decoded == interpreted,
+                        "Decoded locations give %s, the stack machine gives %s" % (decoded, interpreted))
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
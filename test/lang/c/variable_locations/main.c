@@ -0,0 +1,30 @@
+#include <stdio.h>
+
+int g_global = 7;
+static int g_static = 11;
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int __attribute__((noinline))
+sum_down (int n, struct point *p)
+{
+    int local = n * 10;
+    struct point copy = *p;
+    copy.x += n;
+    if (n > 0)
+        return local + sum_down (n - 1, &copy);
+    return local + copy.x + copy.y + g_global + g_static; // Stop here.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    struct point origin = { 1, 2 };
+    int result = sum_down (3, &origin);
+    printf ("%d\n", result);
+    return 0;
+}
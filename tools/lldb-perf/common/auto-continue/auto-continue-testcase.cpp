@@ -0,0 +1,13 @@
+#include <stdio.h>
+
+volatile int g_sum;
+
+int main (int argc, char **argv)
+{
+    printf ("Here is some code to stop at originally.  Got: %d, %p.\n", argc, argv);
+    for (int i = 0; i < 10000; i++)
+        g_sum += i;     // Conditional breakpoint here.
+    for (int i = 0; i < 10000; i++)
+        g_sum -= i;     // Ignore count breakpoint here.
+	return g_sum;
+}
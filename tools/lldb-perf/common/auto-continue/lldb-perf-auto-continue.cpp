@@ -0,0 +1,215 @@
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <getopt.h>
+
+using namespace lldb_perf;
+
+// Measures how many breakpoint hits per second the debugger can take and
+// continue from on its own, for a breakpoint whose condition is false and
+// for one that is being ignored.
+class AutoContinueTest : public TestCase
+{
+    typedef void (*no_function) (void);
+    
+public:
+    AutoContinueTest() :
+        m_main_source("auto-continue-testcase.cpp"),
+        m_condition_time(nullptr),
+        m_ignore_count_time(nullptr)
+    {
+    }
+    
+    virtual
+    ~AutoContinueTest() {}
+    
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        
+        m_target = m_debugger.CreateTarget(m_app_path.c_str());
+        m_first_bp = m_target.BreakpointCreateBySourceRegex("Here is some code to stop at originally.", m_main_source);
+        
+        const char* file_arg = m_app_path.c_str();
+        const char* empty = nullptr;
+        const char* args[] = {file_arg, empty};
+        SBLaunchInfo launch_info (args);
+        
+        return Launch (launch_info);
+    }
+
+    void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        const double condition_time = m_condition_time.GetMetric().GetSum();
+        const double ignore_count_time = m_ignore_count_time.GetMetric().GetSum();
+        results_dict.AddDouble ("condition-time", "Time to run through all the hits of a breakpoint whose condition is false.", condition_time);
+        results_dict.AddDouble ("condition-stops-per-second", "Hits per second of a breakpoint whose condition is false.", g_num_skipped_hits / condition_time);
+        results_dict.AddDouble ("ignore-count-time", "Time to run through all the hits of a breakpoint that is being ignored.", ignore_count_time);
+        results_dict.AddDouble ("ignore-count-stops-per-second", "Hits per second of a breakpoint that is being ignored.", g_num_skipped_hits / ignore_count_time);
+
+        results.Write(m_out_path.c_str());
+    }
+
+    const char *
+    GetExecutablePath () const
+    {
+        if (m_app_path.empty())
+            return NULL;
+        return m_app_path.c_str();
+    }
+
+    void
+    SetExecutablePath (const char *path)
+    {
+        if (path && path[0])
+            m_app_path = path;
+        else
+            m_app_path.clear();
+    }
+    
+    void
+    SetResultFilePath (const char *path)
+    {
+        if (path && path[0])
+            m_out_path = path;
+        else
+            m_out_path.clear();
+    }
+
+private:
+    // The loops in the test case run 10000 times and the breakpoints stop on
+    // the last time through.
+    static const int g_num_skipped_hits = 9999;
+
+    virtual void
+	TestStep (int counter, ActionWanted &next_action)
+    {
+        switch (counter)
+        {
+        case 0:
+            m_first_bp.SetEnabled(false);
+            m_breakpoint = m_target.BreakpointCreateBySourceRegex("Conditional breakpoint here.", m_main_source);
+            m_breakpoint.SetCondition("i == 9999");
+            m_condition_time.Start();
+            next_action.Continue();
+            break;
+        case 1:
+            m_condition_time.Stop();
+            m_breakpoint.SetEnabled(false);
+            m_breakpoint = m_target.BreakpointCreateBySourceRegex("Ignore count breakpoint here.", m_main_source);
+            m_breakpoint.SetIgnoreCount(g_num_skipped_hits);
+            m_ignore_count_time.Start();
+            next_action.Continue();
+            break;
+        case 2:
+            m_ignore_count_time.Stop();
+            next_action.Continue();
+            break;
+        default:
+            next_action.Kill();
+            break;
+        }
+    }
+    
+    SBBreakpoint m_first_bp;
+    SBBreakpoint m_breakpoint;
+    SBFileSpec   m_main_source;
+    TimeMeasurement<no_function> m_condition_time;
+    TimeMeasurement<no_function> m_ignore_count_time;
+    std::string m_app_path;
+    std::string m_out_path;
+};
+
+static struct option g_long_options[] = {
+    { "verbose",      no_argument,            NULL, 'v' },
+    { "test-file",    required_argument,      NULL, 't' },
+    { "out-file",     required_argument,      NULL, 'o' },
+    { NULL,           0,                      NULL,  0  }
+};
+
+int main(int argc, const char * argv[])
+{
+    AutoContinueTest test;
+    bool verbose = false;
+    bool print_help = false;
+
+#if __GLIBC__
+    optind = 0;
+#else
+    optreset = 1;
+    optind = 1;
+#endif
+    while (1)
+    {
+        int long_options_index = -1;
+        const int short_option = ::getopt_long_only (argc,
+                                                     const_cast<char **>(argv),
+                                                     "vt:o:",
+                                                     g_long_options,
+                                                     &long_options_index);
+        if (short_option == -1)
+            break;
+        
+        switch (short_option)
+        {
+            case 'v':
+                verbose = true;
+                break;
+                
+            case 't':
+                {
+                    SBFileSpec file(optarg);
+                    if (file.Exists())
+                        test.SetExecutablePath(optarg);
+                    else
+                        fprintf(stderr, "error: file specified in --test-file (-t) option doesn't exist: '%s'\n", optarg);
+                }
+                break;
+                
+            case 'o':
+                test.SetResultFilePath(optarg);
+                break;
+                
+            default:
+                print_help = true;
+                break;
+        }
+    }
+
+    if (print_help || test.GetExecutablePath() == NULL)
+    {
+        puts(R"(
+NAME
+    lldb-perf-auto-continue -- a tool that measures how fast LLDB continues from breakpoint hits it doesn't stop for.
+
+SYNOPSIS
+    lldb-perf-auto-continue --test-file=FILE [--out-file=PATH --verbose]
+             
+DESCRIPTION
+    Runs a program built from auto-continue-testcase.cpp through 9999 hits of
+    a breakpoint whose condition is false and 9999 hits of a breakpoint that
+    is being ignored, and outputs the hits per second of each to a plist
+    file.
+)");
+        exit(test.GetExecutablePath() == NULL ? 1 : 0);
+    }
+
+    // Update argc and argv after parsing options
+    argc -= optind;
+    argv += optind;
+
+    test.SetVerbose(verbose);
+    TestCase::Run(test, argc, argv);
+    return 0;
+}